@@ -0,0 +1,128 @@
+#include "arkanoidEnv.h"
+
+#include <algorithm>
+#include <exception>
+#include <vector>
+
+#include "batchSimulation.hpp"
+
+struct ArkanoidEnv
+{
+	ArkanoidEnv(uint64_t seed, uint32_t gameCount)
+		: simulation(gameCount, seed), actions(gameCount, MoveDirection::None)
+	{
+		// The simulation's arrays never reallocate, so these pointers stay valid
+		observation = {
+			.gameCount = gameCount,
+			.ballX = simulation.getBallX().data(),
+			.ballY = simulation.getBallY().data(),
+			.ballDirectionX = simulation.getBallDirectionX().data(),
+			.ballDirectionY = simulation.getBallDirectionY().data(),
+			.ballSpeed = simulation.getBallSpeed().data(),
+			.platformX = simulation.getPlatformX().data(),
+			.aliveBlocks = simulation.getAliveBlocks().data(),
+			.rewards = simulation.getRewards().data(),
+			.done = simulation.getDone().data()
+		};
+	}
+
+	BatchSimulation simulation;
+	std::vector<MoveDirection> actions;
+	ArkanoidObservation observation{};
+};
+
+namespace
+{
+	MoveDirection toMoveDirection(int action)
+	{
+		switch (action)
+		{
+			case ARKANOID_ACTION_LEFT: return MoveDirection::Left;
+			case ARKANOID_ACTION_RIGHT: return MoveDirection::Right;
+			default: return MoveDirection::None;
+		}
+	}
+
+	// Exceptions must not cross the C boundary
+	template <typename Function>
+	int runGuarded(Function&& function)
+	{
+		try
+		{
+			function();
+			return ARKANOID_OK;
+		}
+		catch (const std::exception&)
+		{
+			return ARKANOID_ERROR;
+		}
+	}
+}
+
+ArkanoidEnv* arkanoid_create(uint64_t seed)
+{
+	return arkanoid_create_batch(seed, 1);
+}
+
+ArkanoidEnv* arkanoid_create_batch(uint64_t seed, uint32_t gameCount)
+{
+	if (gameCount == 0)
+		return nullptr;
+
+	try
+	{
+		return new ArkanoidEnv(seed, gameCount);
+	}
+	catch (const std::exception&)
+	{
+		return nullptr;
+	}
+}
+
+void arkanoid_destroy(ArkanoidEnv* env)
+{
+	delete env;
+}
+
+int arkanoid_reset(ArkanoidEnv* env)
+{
+	if (!env)
+		return ARKANOID_ERROR;
+
+	return runGuarded([&] { env->simulation.reset(); });
+}
+
+int arkanoid_step(ArkanoidEnv* env, int action, ArkanoidStepResult* result)
+{
+	if (!env || !result)
+		return ARKANOID_ERROR;
+
+	return runGuarded([&]
+	{
+		std::ranges::fill(env->actions, MoveDirection::None);
+		env->actions[0] = toMoveDirection(action);
+		env->simulation.step(env->actions);
+
+		*result = {
+			.reward = env->observation.rewards[0],
+			.done = env->observation.done[0]
+		};
+	});
+}
+
+int arkanoid_step_batch(ArkanoidEnv* env, const uint8_t* actions)
+{
+	if (!env || !actions)
+		return ARKANOID_ERROR;
+
+	return runGuarded([&]
+	{
+		std::transform(actions, actions + env->actions.size(), env->actions.begin(), [](uint8_t action) { return toMoveDirection(action); });
+		env->simulation.step(env->actions);
+	});
+}
+
+const ArkanoidObservation* arkanoid_observe(const ArkanoidEnv* env)
+{
+	return env ? &env->observation : nullptr;
+}
@@ -0,0 +1,90 @@
+/* Plain C interface to the headless Arkanoid simulation, for external training harnesses.
+ *
+ * An environment steps one or more independent games in lockstep without any window or audio.
+ * Games serve automatically; a game that ends restarts on a new level within the same step and
+ * reports done = 1 for that step. Observations are read in place through the pointers of
+ * ArkanoidObservation, which stay valid and are updated by every step until the environment is destroyed.
+ */
+#ifndef ARKANOID_ENV_H
+#define ARKANOID_ENV_H
+
+#include <stdint.h>
+
+#if defined(_WIN32)
+#if defined(ARKANOID_ENV_BUILD)
+#define ARKANOID_ENV_API __declspec(dllexport)
+#else
+#define ARKANOID_ENV_API __declspec(dllimport)
+#endif
+#else
+#define ARKANOID_ENV_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct ArkanoidEnv ArkanoidEnv;
+
+/* Returned by the functions that can fail */
+enum
+{
+	ARKANOID_OK = 0,
+	ARKANOID_ERROR = -1 /* Invalid argument or internal failure; the environment's state is unspecified */
+};
+
+/* Platform movement for one step */
+enum
+{
+	ARKANOID_ACTION_NONE = 0,
+	ARKANOID_ACTION_LEFT = 1,
+	ARKANOID_ACTION_RIGHT = 2
+};
+
+typedef struct ArkanoidStepResult
+{
+	float reward; /* Score gained in the step */
+	int done;     /* 1 when the game ended in the step and restarted */
+} ArkanoidStepResult;
+
+/* Feature buffers, one entry per game. Blocks are bits of the level grid, row-major from the top left. */
+typedef struct ArkanoidObservation
+{
+	uint32_t gameCount;
+	const float* ballX;
+	const float* ballY;
+	const float* ballDirectionX;
+	const float* ballDirectionY;
+	const float* ballSpeed;
+	const float* platformX;
+	const uint64_t* aliveBlocks;
+	const float* rewards;
+	const uint8_t* done;
+} ArkanoidObservation;
+
+/* Single game. Returns NULL on failure. */
+ARKANOID_ENV_API ArkanoidEnv* arkanoid_create(uint64_t seed);
+
+/* gameCount games stepped together. Returns NULL on failure or when gameCount is 0. */
+ARKANOID_ENV_API ArkanoidEnv* arkanoid_create_batch(uint64_t seed, uint32_t gameCount);
+
+ARKANOID_ENV_API void arkanoid_destroy(ArkanoidEnv* env);
+
+/* Restarts every game on a new level */
+ARKANOID_ENV_API int arkanoid_reset(ArkanoidEnv* env);
+
+/* Steps the first game with action, and any other games with ARKANOID_ACTION_NONE, and writes the first
+ * game's outcome to result. Unknown actions count as ARKANOID_ACTION_NONE. */
+ARKANOID_ENV_API int arkanoid_step(ArkanoidEnv* env, int action, ArkanoidStepResult* result);
+
+/* Steps every game, game i with actions[i]; results are in the observation's rewards and done arrays */
+ARKANOID_ENV_API int arkanoid_step_batch(ArkanoidEnv* env, const uint8_t* actions);
+
+/* Points into the environment; valid until arkanoid_destroy. NULL for a NULL env. */
+ARKANOID_ENV_API const ArkanoidObservation* arkanoid_observe(const ArkanoidEnv* env);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
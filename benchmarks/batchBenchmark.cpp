@@ -0,0 +1,147 @@
+// Environment steps per second of BatchSimulation for growing batch sizes and thread counts,
+// against stepping HeadlessGame instances one at a time.
+//
+// Every game is driven by a policy that follows the ball's x, computed for the whole batch in one
+// loop like a training loop would. Each thread owns a separate BatchSimulation.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <format>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "batchSimulation.hpp"
+#include "headlessGame.hpp"
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	constexpr double kSecondsPerRun = 1.0;
+
+	void trackBall(std::span<const float> ballX, std::span<const float> platformX, std::span<MoveDirection> actions)
+	{
+		constexpr float deadZone = 10.f;
+		for (size_t i = 0; i < actions.size(); ++i)
+		{
+			const float offset = ballX[i] - platformX[i];
+			actions[i] = offset > deadZone ? MoveDirection::Right : offset < -deadZone ? MoveDirection::Left : MoveDirection::None;
+		}
+	}
+
+	struct RunResult
+	{
+		double stepsPerSecond = 0.0;
+		double narrowPhaseShare = 0.0;
+		uint64_t finishedGames = 0;
+		uint64_t wonGames = 0;
+	};
+
+	RunResult runBatch(size_t gameCount, uint32_t threadCount)
+	{
+		std::atomic<uint64_t> steps{ 0 };
+		std::atomic<uint64_t> narrowPhase{ 0 };
+		std::atomic<uint64_t> finished{ 0 };
+		std::atomic<uint64_t> won{ 0 };
+		std::atomic<bool> stop{ false };
+
+		const auto start = Clock::now();
+		{
+			std::vector<std::jthread> workers;
+			for (uint32_t t = 0; t < threadCount; ++t)
+			{
+				workers.emplace_back([&, t]
+				{
+					BatchSimulation batch(gameCount, 1234 + t);
+					std::vector<MoveDirection> actions(gameCount);
+					while (!stop.load(std::memory_order_relaxed))
+					{
+						trackBall(batch.getBallX(), batch.getPlatformX(), actions);
+						batch.step(actions);
+					}
+					steps += batch.getEnvironmentSteps();
+					narrowPhase += batch.getNarrowPhaseCount();
+					finished += batch.getFinishedGameCount();
+					won += batch.getWonGameCount();
+				});
+			}
+
+			std::this_thread::sleep_for(std::chrono::duration<double>(kSecondsPerRun));
+			stop = true;
+		}
+		const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+		return {
+			.stepsPerSecond = static_cast<double>(steps) / seconds,
+			.narrowPhaseShare = static_cast<double>(narrowPhase) / static_cast<double>(std::max<uint64_t>(steps, 1)),
+			.finishedGames = finished,
+			.wonGames = won
+		};
+	}
+
+	// Reference: the same games as individual objects, stepped one after another
+	double runIndividual(size_t gameCount)
+	{
+		LevelGenConfig config;
+		config.grid = {
+			.columns = GameConfig::kBlockColumnCount,
+			.rows = GameConfig::kBlockRowCount,
+			.cellSize = GameConfig::kBlockSize,
+			.origin = GameConfig::kLevelOrigin
+		};
+
+		std::vector<HeadlessGame> games;
+		games.reserve(gameCount);
+		for (size_t i = 0; i < gameCount; ++i)
+		{
+			config.seed = 1234 + i;
+			games.emplace_back(config, static_cast<uint32_t>(i));
+		}
+
+		uint64_t steps = 0;
+		const auto start = Clock::now();
+		double seconds = 0.0;
+		while (seconds < kSecondsPerRun)
+		{
+			for (HeadlessGame& game : games)
+			{
+				if (game.isFinished())
+					game = HeadlessGame(config, static_cast<uint32_t>(steps));
+
+				game.serve();
+				const SimulationState& state = game.getState();
+				const float offset = state.ball ? state.ball->getPosition().x - state.platform->getPosition().x : 0.f;
+				game.step(offset > 10.f ? MoveDirection::Right : offset < -10.f ? MoveDirection::Left : MoveDirection::None);
+			}
+			steps += gameCount;
+			seconds = std::chrono::duration<double>(Clock::now() - start).count();
+		}
+		return static_cast<double>(steps) / seconds;
+	}
+}
+
+int main()
+{
+	const uint32_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+
+	std::cout << std::format("{:<34} {:>8} {:>12.2f} Msteps/s\n", "HeadlessGame, one at a time", 1024, runIndividual(1024) / 1e6);
+
+	for (const size_t gameCount : { 1, 64, 1024, 16384 })
+	{
+		const RunResult result = runBatch(gameCount, 1);
+		std::cout << std::format("{:<34} {:>8} {:>12.2f} Msteps/s  narrow phase {:5.1f}%  games finished {} (won {})\n",
+			"BatchSimulation, 1 thread", gameCount, result.stepsPerSecond / 1e6, 100.0 * result.narrowPhaseShare,
+			result.finishedGames, result.wonGames);
+	}
+
+	for (uint32_t threads = 2; threads <= hardwareThreads; threads *= 2)
+	{
+		const RunResult result = runBatch(1024, threads);
+		std::cout << std::format("{:<34} {:>8} {:>12.2f} Msteps/s\n",
+			std::format("BatchSimulation, {} threads", threads), 1024 * threads, result.stepsPerSecond / 1e6);
+	}
+
+	return 0;
+}
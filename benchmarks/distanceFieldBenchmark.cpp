@@ -0,0 +1,260 @@
+// Ball updates through the distance field against the brute-force sweep over every wall and block,
+// for the default level and for fields of small blocks from sparse to packed.
+//
+// Each level gets a few thousand seeded balls in free space, moved for a number of ticks with blocks
+// surviving every hit so both modes see the same geometry. Before timing, single steps of both modes are
+// compared and the field is checked against a fresh build after removing every block one at a time;
+// the benchmark exits with code 1 when either disagrees.
+//
+// Usage: DistanceFieldBenchmark [--balls N] [--ticks N]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <format>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "counterRng.hpp"
+#include "gameConfig.hpp"
+#include "gameRules.hpp"
+#include "levelGenerator.hpp"
+#include "physics.hpp"
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	using GameConfig::kViewSize;
+	using GameConfig::kWallThickness;
+	constexpr float kTickSeconds = 1.f / 60.f;
+	constexpr uint32_t kAccuracySteps = 200'000;
+
+	struct LevelPreset
+	{
+		const char* name;
+		LevelGrid grid;
+		float noiseThreshold = 0.f; // Share of cells left empty, roughly
+	};
+
+	struct BallState
+	{
+		Vector2 position;
+		Vector2 direction;
+		float speed = 0.f;
+	};
+
+	struct Timing
+	{
+		double nsPerUpdate = 0.0;
+		double iterationsPerUpdate = 0.0;
+	};
+
+	CollisionContext makeContext(const LevelPreset& preset)
+	{
+		CollisionContext context;
+		context.walls = GameRules::getWalls();
+
+		LevelGenConfig config;
+		config.seed = 1234;
+		config.grid = preset.grid;
+		config.noiseScale = preset.noiseThreshold > 0.f ? 3.f : 0.f;
+		config.noiseThreshold = preset.noiseThreshold;
+
+		// Front rows first, as in Arkanoid::updateCollisionContext
+		std::vector<LevelBlock> blocks = LevelGenerator(config).generate();
+		for (size_t i = blocks.size(); i-- > 0;)
+		{
+			const Vector2 center = getCellCenter(preset.grid, blocks[i].column, blocks[i].row);
+			context.blockAABBs.push_back({ center - preset.grid.cellSize * 0.5f, center + preset.grid.cellSize * 0.5f });
+			context.blockHandles.push_back({ 0, static_cast<uint32_t>(i) });
+		}
+		return context;
+	}
+
+	bool isFree(const Vector2& position, const CollisionContext& context)
+	{
+		auto clear = [&](const AABB& box)
+		{
+			const Vector2 closest{ std::clamp(position.x, box.min.x, box.max.x), std::clamp(position.y, box.min.y, box.max.y) };
+			return lengthSquared(position - closest) >= GameConfig::kBallRadius * GameConfig::kBallRadius;
+		};
+		return std::ranges::all_of(context.walls, clear) && std::ranges::all_of(context.blockAABBs, clear);
+	}
+
+	std::vector<BallState> makeBalls(size_t count, const CollisionContext& context, uint64_t seed)
+	{
+		CounterRng rng(seed);
+		std::vector<BallState> balls;
+		while (balls.size() < count)
+		{
+			const Vector2 position{ kWallThickness + rng.nextUniform() * (kViewSize - 2.f * kWallThickness), kWallThickness + rng.nextUniform() * (kViewSize - kWallThickness) };
+			if (!isFree(position, context))
+				continue;
+
+			const float angle = rng.nextUniform() * 2.f * pi;
+			const float speed = GameConfig::kDefaultBallSpeed + GameConfig::kBallSpeedIncrement * static_cast<float>(rng.next() % 21);
+			balls.push_back({ position, { std::cos(angle), std::sin(angle) }, speed });
+		}
+		return balls;
+	}
+
+	// Single steps of both modes from the same states; the field only skips sweeps, so results match exactly
+	uint32_t compareSteps(const CollisionContext& scan, const CollisionContext& field)
+	{
+		uint32_t mismatches = 0;
+		const std::vector<BallState> balls = makeBalls(kAccuracySteps, scan, 7);
+		for (const BallState& state : balls)
+		{
+			Ball ball(state.position, GameConfig::kBallRadius, state.speed);
+			ball.setDirection(state.direction);
+			const Vector2 move = state.direction * (state.speed * kTickSeconds * 4.f);
+
+			const PhysicsHitResult a = Physics::simulateBallStep(ball, move, state.position, scan);
+			const PhysicsHitResult b = Physics::simulateBallStep(ball, move, state.position, field);
+			const bool same = a.hitBlock == b.hitBlock && a.hitWall == b.hitWall && a.traveled == b.traveled
+				&& a.newPosition.x == b.newPosition.x && a.newPosition.y == b.newPosition.y
+				&& a.newDirection.x == b.newDirection.x && a.newDirection.y == b.newDirection.y;
+			if (!same)
+				mismatches++;
+		}
+		return mismatches;
+	}
+
+	// Removes every block in a shuffled order, patching the field locally, and compares it with a fresh
+	// build at a few points along the way. Returns the average patch time in microseconds, or -1 on a mismatch.
+	double checkRemoval(const CollisionContext& source, double& buildUs)
+	{
+		CollisionContext context = source;
+		DistanceField field({ .min = { 0.f, 0.f }, .max = { kViewSize, kViewSize } });
+		context.distanceField = &field;
+
+		const auto buildStart = Clock::now();
+		field.build(context.walls, context.blockAABBs);
+		buildUs = std::chrono::duration<double, std::micro>(Clock::now() - buildStart).count();
+
+		CounterRng rng(99);
+		double patchUs = 0.0;
+		const size_t blockCount = context.blockAABBs.size();
+		for (size_t removed = 0; removed < blockCount; ++removed)
+		{
+			const size_t index = static_cast<size_t>(rng.next() % context.blockAABBs.size());
+			const auto start = Clock::now();
+			context.removeBlock(index);
+			patchUs += std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+
+			if (removed % 97 == 0 || removed + 1 == blockCount)
+			{
+				DistanceField fresh({ .min = { 0.f, 0.f }, .max = { kViewSize, kViewSize } });
+				fresh.build(context.walls, context.blockAABBs);
+				for (float y = 0.f; y < kViewSize; y += DistanceField::kCellSize)
+				{
+					for (float x = 0.f; x < kViewSize; x += DistanceField::kCellSize)
+					{
+						if (fresh.getClearance({ x + 1.f, y + 1.f }) != field.getClearance({ x + 1.f, y + 1.f }))
+							return -1.0;
+					}
+				}
+			}
+		}
+		return blockCount > 0 ? patchUs / static_cast<double>(blockCount) : 0.0;
+	}
+
+	Timing measure(const CollisionContext& context, const std::vector<BallState>& balls, uint32_t ticks)
+	{
+		uint64_t iterations = 0;
+		const auto start = Clock::now();
+		for (const BallState& state : balls)
+		{
+			Ball ball(state.position, GameConfig::kBallRadius, state.speed);
+			ball.setDirection(state.direction);
+			for (uint32_t tick = 0; tick < ticks; ++tick)
+			{
+				const CcdResult result = Physics::moveBall(ball, state.speed * kTickSeconds, context, GameConfig::kCcdIterationBudget,
+					[](const PhysicsHitResult&) {});
+				iterations += result.iterations;
+
+				// Falling out at the bottom: serve again from the start
+				if (ball.getPosition().y > kViewSize)
+				{
+					ball.setPosition(state.position);
+					ball.setDirection(state.direction);
+				}
+			}
+		}
+		const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+		const auto updates = static_cast<double>(balls.size()) * ticks;
+		return { 1e9 * seconds / updates, static_cast<double>(iterations) / updates };
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	try
+	{
+		size_t ballCount = 2000;
+		uint32_t ticks = 600;
+		for (int i = 1; i < argc; ++i)
+		{
+			const std::string_view arg = argv[i];
+			if (arg == "--balls" && i + 1 < argc)
+				ballCount = std::max<size_t>(1, std::stoul(argv[++i]));
+			else if (arg == "--ticks" && i + 1 < argc)
+				ticks = std::max(1u, static_cast<uint32_t>(std::stoul(argv[++i])));
+			else
+				throw std::invalid_argument(std::format("Unknown argument: {}", arg));
+		}
+
+		// Small blocks over the top three quarters of the field; the noise threshold thins them out
+		constexpr LevelGrid kSmallBlocks{ .columns = 39, .rows = 58, .cellSize = { 20.f, 10.f }, .origin = { 10.f, 10.f } };
+		const std::vector<LevelPreset> presets = {
+			{ "default 12x5", { .columns = GameConfig::kBlockColumnCount, .rows = GameConfig::kBlockRowCount, .cellSize = GameConfig::kBlockSize, .origin = GameConfig::kLevelOrigin } },
+			{ "small, sparse", kSmallBlocks, 0.8f },
+			{ "small, half", kSmallBlocks, 0.5f },
+			{ "small, dense", kSmallBlocks, 0.25f },
+			{ "small, packed", kSmallBlocks, 0.f }
+		};
+
+		std::cout << std::format("{} balls x {} ticks per level, field {}x{} cells of {} units\n", ballCount, ticks,
+			static_cast<int>(kViewSize / DistanceField::kCellSize), static_cast<int>(kViewSize / DistanceField::kCellSize), DistanceField::kCellSize);
+		std::cout << std::format("{:<14} {:>6} {:>10} {:>10} {:>9} {:>8} {:>9} {:>9} {:>10}\n",
+			"level", "blocks", "scan ns", "field ns", "speedup", "ccd it.", "build us", "patch us", "mismatch");
+
+		bool passed = true;
+		for (const LevelPreset& preset : presets)
+		{
+			const CollisionContext scan = makeContext(preset);
+
+			DistanceField field({ .min = { 0.f, 0.f }, .max = { kViewSize, kViewSize } });
+			field.build(scan.walls, scan.blockAABBs);
+			CollisionContext withField = scan;
+			withField.distanceField = &field;
+
+			const uint32_t mismatches = compareSteps(scan, withField);
+			double buildUs = 0.0;
+			const double patchUs = checkRemoval(scan, buildUs);
+			passed = passed && mismatches == 0 && patchUs >= 0.0;
+
+			const std::vector<BallState> balls = makeBalls(ballCount, scan, 1);
+			const Timing scanTiming = measure(scan, balls, ticks);
+			const Timing fieldTiming = measure(withField, balls, ticks);
+
+			std::cout << std::format("{:<14} {:>6} {:>10.1f} {:>10.1f} {:>8.2f}x {:>8.3f} {:>9.1f} {:>9} {:>10}\n",
+				preset.name, scan.blockAABBs.size(), scanTiming.nsPerUpdate, fieldTiming.nsPerUpdate,
+				scanTiming.nsPerUpdate / fieldTiming.nsPerUpdate, fieldTiming.iterationsPerUpdate, buildUs,
+				patchUs >= 0.0 ? std::format("{:.2f}", patchUs) : std::string("FAILED"),
+				std::format("{}/{}", mismatches, kAccuracySteps));
+		}
+
+		return passed ? 0 : 1;
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << '\n';
+		return 1;
+	}
+}
@@ -0,0 +1,101 @@
+// Measures procedural level generation throughput in blocks per second, comparing the
+// previous mt19937 + cumulative-probability scan against LevelGenerator.
+
+#include <algorithm>
+#include <chrono>
+#include <format>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "levelGenerator.hpp"
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	// Repeats fn until at least minSeconds have passed and returns the best blocks-per-second rate
+	template <typename Fn>
+	double measureBlocksPerSecond(Fn&& fn, double minSeconds = 0.5)
+	{
+		double best = 0.0;
+		const auto start = Clock::now();
+		do
+		{
+			const auto runStart = Clock::now();
+			const size_t blocks = fn();
+			const double seconds = std::chrono::duration<double>(Clock::now() - runStart).count();
+			best = std::max(best, static_cast<double>(blocks) / seconds);
+		} while (std::chrono::duration<double>(Clock::now() - start).count() < minSeconds);
+		return best;
+	}
+
+	// Previous generateLevel approach, kept as the reference point
+	size_t generateReference(std::mt19937& rng, const LevelGrid& grid, std::vector<LevelBlock>& out)
+	{
+		constexpr std::array weights = { 0.7f, 0.2f, 0.1f };
+		std::vector<float> cumulative;
+		float sum = 0.f;
+		for (float w : weights)
+			cumulative.push_back(sum += w);
+
+		out.clear();
+		out.reserve(static_cast<size_t>(grid.columns) * grid.rows);
+		std::uniform_real_distribution<float> dist(0.f, 1.f);
+		for (uint16_t column = 0; column < grid.columns; ++column)
+		{
+			for (uint16_t row = 0; row < grid.rows; ++row)
+			{
+				const float value = dist(rng);
+				auto type = BlockType::Normal;
+				for (size_t k = 0; k < cumulative.size(); ++k)
+				{
+					if (value <= cumulative[k])
+					{
+						type = static_cast<BlockType>(k);
+						break;
+					}
+				}
+				out.push_back({ column, row, type, getDefaultHitPoints(type) });
+			}
+		}
+		return out.size();
+	}
+
+	void report(const char* name, const LevelGrid& grid, uint32_t threads, double blocksPerSecond)
+	{
+		std::cout << std::format("{:<28} {:>6}x{:<6} threads {:>3}  {:>10.1f} Mblocks/s\n",
+			name, grid.columns, grid.rows, threads, blocksPerSecond / 1e6);
+	}
+}
+
+int main()
+{
+	const uint32_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+	const std::array<LevelGrid, 3> grids = {
+		LevelGrid{ .columns = 12, .rows = 5, .cellSize = { 65.f, 30.f }, .origin = { 10.f, 10.f } },
+		LevelGrid{ .columns = 512, .rows = 512, .cellSize = { 2.f, 2.f }, .origin = {} },
+		LevelGrid{ .columns = 4096, .rows = 4096, .cellSize = { 1.f, 1.f }, .origin = {} },
+	};
+
+	std::vector<LevelBlock> out;
+	std::mt19937 rng(1234);
+
+	for (const LevelGrid& grid : grids)
+	{
+		report("reference (mt19937 + scan)", grid, 1, measureBlocksPerSecond([&] { return generateReference(rng, grid, out); }));
+
+		for (uint32_t threads = 1; threads <= hardwareThreads; threads *= 2)
+		{
+			const LevelGenerator generator({ .seed = 1234, .grid = grid, .threadCount = threads });
+			report("alias + counter rng", grid, threads, measureBlocksPerSecond([&] { return generator.generate().size(); }));
+		}
+
+		LevelGenConfig patterned{ .seed = 1234, .grid = grid, .symmetry = LevelSymmetry::MirrorX, .noiseScale = 8.f, .noiseThreshold = 0.4f, .threadCount = hardwareThreads };
+		const LevelGenerator generator(patterned);
+		report("mirror + noise field", grid, hardwareThreads, measureBlocksPerSecond([&] { return generator.generate().size(); }));
+	}
+
+	return 0;
+}
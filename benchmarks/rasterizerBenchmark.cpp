@@ -0,0 +1,175 @@
+// Frame cost of the SDL software renderer against the tiled CPU rasterizer backend, drawing the same
+// game-like frame into an XRGB8888 surface at 800x800, 1080p and 4K.
+//
+// The frame holds the walls, a full block field with outlines, a few thousand translucent particles,
+// the ball, the platform and a handful of text lines, all in the game's 800x800 logical space scaled
+// to the target. Times include presenting, which for the tiled backend is the whole rasterization.
+//
+// Usage: RasterizerBenchmark [--particles N]
+
+#include <array>
+#include <chrono>
+#include <format>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "color.hpp"
+#include "gameConfig.hpp"
+#include "gameRules.hpp"
+#include "renderer.hpp"
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	constexpr double kSecondsPerRun = 2.0;
+	constexpr Vector2 kLogicalSize{ GameConfig::kViewSize, GameConfig::kViewSize };
+
+	struct Particle
+	{
+		AABB bounds;
+		SDL_Color color;
+	};
+
+	struct Resolution
+	{
+		const char* name;
+		int width;
+		int height;
+	};
+
+	std::vector<Particle> makeParticles(size_t count)
+	{
+		std::mt19937 rng(1234);
+		std::uniform_real_distribution<float> position(20.f, 780.f);
+		std::uniform_real_distribution<float> size(2.f, 6.f);
+		std::uniform_int_distribution<int> channel(0, 255);
+
+		std::vector<Particle> particles(count);
+		for (Particle& particle : particles)
+		{
+			const Vector2 center{ position(rng), position(rng) };
+			const Vector2 halfSize = Vector2{ size(rng), size(rng) } * 0.5f;
+			particle.bounds = { center - halfSize, center + halfSize };
+			particle.color = {
+				static_cast<uint8_t>(channel(rng)),
+				static_cast<uint8_t>(channel(rng)),
+				static_cast<uint8_t>(channel(rng)),
+				static_cast<uint8_t>(channel(rng))
+			};
+		}
+		return particles;
+	}
+
+	void drawFrame(const Renderer& renderer, const std::vector<Particle>& particles, uint64_t frame)
+	{
+		constexpr std::array blockColors = { Color::Red, Color::Green, Color::Blue, Color::Yellow, Color::Cyan, Color::Violet };
+
+		renderer.clearScreen();
+
+		// Walls
+		for (const AABB& wall : GameRules::getWalls())
+			renderer.drawFilledRectangle((wall.min + wall.max) * 0.5f, wall.max - wall.min, Color::Gray);
+
+		for (size_t row = 0; row < GameConfig::kBlockRowCount; ++row)
+		{
+			for (size_t column = 0; column < GameConfig::kBlockColumnCount; ++column)
+			{
+				const Vector2 min = GameConfig::kLevelOrigin + Vector2{ static_cast<float>(column), static_cast<float>(row) } * GameConfig::kBlockSize;
+				const AABB bounds{ min, min + GameConfig::kBlockSize };
+				renderer.queueFilledRectangle(bounds, blockColors[(row + column) % blockColors.size()]);
+				renderer.queueRectangle(bounds, Color::Black);
+			}
+		}
+		renderer.flushQueue();
+
+		for (const Particle& particle : particles)
+			renderer.queueFilledRectangle(particle.bounds, particle.color);
+		renderer.flushQueue();
+
+		const float phase = static_cast<float>(frame % 600) / 600.f;
+		renderer.drawFilledCircle({ 100.f + 600.f * phase, 500.f }, GameConfig::kBallRadius, Color::White);
+		renderer.drawFilledRectangle({ 700.f - 600.f * phase, 760.f }, GameConfig::kPlatformSize, Color::Blue);
+
+		renderer.drawText(std::format("Score: {}", frame), { 20.f, 780.f }, Color::White);
+		renderer.drawText("Lives: 3", { 780.f, 780.f }, Color::White, TextAlign::MiddleRight);
+		for (int line = 0; line < 4; ++line)
+			renderer.queueAtlasText(std::format("frame {:6} line {}", frame, line), { 560.f, 200.f + 14.f * line }, Color::Lime, 0.5f);
+		renderer.flushTextQueue();
+
+		renderer.presentFrame();
+	}
+
+	double measure(const Resolution& resolution, RenderBackend backend, const std::vector<Particle>& particles)
+	{
+		SDL_Surface* surface = SDL_CreateSurface(resolution.width, resolution.height, SDL_PIXELFORMAT_XRGB8888);
+		if (!surface)
+			throw std::runtime_error(std::format("SDL_CreateSurface Error: {}", SDL_GetError()));
+
+		double msPerFrame = 0.0;
+		{
+			Renderer renderer(surface, kLogicalSize, backend);
+
+			// Warm-up: glyph atlas, queue capacity, thread pool start
+			for (uint64_t frame = 0; frame < 10; ++frame)
+				drawFrame(renderer, particles, frame);
+
+			uint64_t frames = 0;
+			const auto start = Clock::now();
+			double seconds = 0.0;
+			while (seconds < kSecondsPerRun)
+			{
+				drawFrame(renderer, particles, frames++);
+				seconds = std::chrono::duration<double>(Clock::now() - start).count();
+			}
+			msPerFrame = 1000.0 * seconds / static_cast<double>(frames);
+		}
+
+		SDL_DestroySurface(surface);
+		return msPerFrame;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	try
+	{
+		size_t particleCount = 2000;
+		for (int i = 1; i < argc; ++i)
+		{
+			const std::string_view arg = argv[i];
+			if (arg == "--particles" && i + 1 < argc)
+				particleCount = std::stoul(argv[++i]);
+			else
+				throw std::invalid_argument(std::format("Unknown argument: {}", arg));
+		}
+
+		const std::vector<Particle> particles = makeParticles(particleCount);
+		constexpr std::array resolutions = {
+			Resolution{ "800x800", 800, 800 },
+			Resolution{ "1080p", 1920, 1080 },
+			Resolution{ "4K", 3840, 2160 }
+		};
+
+		std::cout << std::format("{} particles, {} hardware threads\n", particleCount, std::thread::hardware_concurrency());
+		std::cout << std::format("{:<10} {:>14} {:>14} {:>9}\n", "target", "SDL ms/frame", "tiled ms/frame", "speedup");
+		for (const Resolution& resolution : resolutions)
+		{
+			const double sdl = measure(resolution, RenderBackend::Sdl, particles);
+			const double tiled = measure(resolution, RenderBackend::Tiled, particles);
+			std::cout << std::format("{:<10} {:>14.3f} {:>14.3f} {:>8.2f}x\n", resolution.name, sdl, tiled, sdl / tiled);
+		}
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << '\n';
+		return 1;
+	}
+
+	return 0;
+}
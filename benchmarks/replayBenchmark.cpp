@@ -0,0 +1,271 @@
+// Plays a corpus of recorded sessions (.arkr) as fast as possible and reports frame-time percentiles
+// and simulation throughput, optionally comparing them against a stored baseline.
+//
+// Usage: ReplayBenchmark [--render] [--repeat N] [--out FILE] [--baseline FILE] [--threshold PERCENT] REPLAY|DIRECTORY...
+//
+// --render also draws every frame with the offscreen software renderer. Directories are searched for
+// .arkr files. The exit code is 1 when a replay diverged from its recording, since its timings no longer
+// measure the recorded session, or, with --baseline, when a replay's p50, p95 or p99 frame time grew, or
+// its ticks per second dropped, by more than the threshold (default 10%).
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "arkanoid.hpp"
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	struct BenchmarkOptions
+	{
+		std::vector<std::string> replayPaths;
+		bool render = false;
+		uint32_t repeatCount = 1;
+		std::string outputPath = "replay_benchmark.json";
+		std::string baselinePath;
+		double thresholdPercent = 10.0;
+	};
+
+	struct ReplayResult
+	{
+		std::string name;
+		uint64_t tickCount = 0;
+		double ticksPerSecond = 0.0;
+		float p50Ms = 0.f;
+		float p95Ms = 0.f;
+		float p99Ms = 0.f;
+		float maxMs = 0.f;
+		bool diverged = false;
+	};
+
+	BenchmarkOptions parseOptions(int argc, char* argv[])
+	{
+		BenchmarkOptions options;
+		for (int i = 1; i < argc; ++i)
+		{
+			const std::string_view arg = argv[i];
+			if (arg == "--render")
+				options.render = true;
+			else if (arg == "--repeat" && i + 1 < argc)
+				options.repeatCount = std::max(1u, static_cast<uint32_t>(std::stoul(argv[++i])));
+			else if (arg == "--out" && i + 1 < argc)
+				options.outputPath = argv[++i];
+			else if (arg == "--baseline" && i + 1 < argc)
+				options.baselinePath = argv[++i];
+			else if (arg == "--threshold" && i + 1 < argc)
+				options.thresholdPercent = std::stod(argv[++i]);
+			else if (arg.starts_with("--"))
+				throw std::invalid_argument(std::format("Unknown argument: {}", arg));
+			else if (std::filesystem::is_directory(arg))
+			{
+				std::vector<std::string> corpus;
+				for (const auto& entry : std::filesystem::directory_iterator(arg))
+				{
+					if (entry.is_regular_file() && entry.path().extension() == ".arkr")
+						corpus.push_back(entry.path().string());
+				}
+				std::ranges::sort(corpus);
+				options.replayPaths.insert(options.replayPaths.end(), corpus.begin(), corpus.end());
+			}
+			else
+				options.replayPaths.emplace_back(arg);
+		}
+
+		if (options.replayPaths.empty())
+			throw std::invalid_argument("No replay files given");
+
+		return options;
+	}
+
+	float percentile(std::vector<float>& values, float fraction)
+	{
+		const auto index = static_cast<size_t>(fraction * static_cast<float>(values.size() - 1) + 0.5f);
+		std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(index), values.end());
+		return values[index];
+	}
+
+	ReplayResult runReplay(const std::string& path, const BenchmarkOptions& options)
+	{
+		GameOptions gameOptions;
+		gameOptions.replayPath = path;
+		gameOptions.display = options.render ? DisplayMode::Offscreen : DisplayMode::None;
+		gameOptions.limitFrameRate = false;
+		gameOptions.collectFrameTimes = true;
+		gameOptions.flightRecorderSeconds = 0; // Timing runs neither pay for it nor leave hitch dumps behind
+
+		ReplayResult result;
+		result.name = std::filesystem::path(path).filename().string();
+
+		std::vector<float> frameTimesMs;
+		double totalSeconds = 0.0;
+		for (uint32_t run = 0; run < options.repeatCount; ++run)
+		{
+			Arkanoid arkanoid(gameOptions);
+
+			const auto start = Clock::now();
+			arkanoid.run();
+			totalSeconds += std::chrono::duration<double>(Clock::now() - start).count();
+
+			const auto& runFrameTimes = arkanoid.getFrameTimesMs();
+			frameTimesMs.insert(frameTimesMs.end(), runFrameTimes.begin(), runFrameTimes.end());
+			result.diverged |= arkanoid.getReplayDivergenceTick().has_value();
+		}
+
+		if (frameTimesMs.empty())
+			throw std::runtime_error(std::format("Replay {} has no ticks", path));
+
+		result.tickCount = frameTimesMs.size() / options.repeatCount;
+		result.ticksPerSecond = static_cast<double>(frameTimesMs.size()) / totalSeconds;
+		result.p50Ms = percentile(frameTimesMs, 0.50f);
+		result.p95Ms = percentile(frameTimesMs, 0.95f);
+		result.p99Ms = percentile(frameTimesMs, 0.99f);
+		result.maxMs = *std::ranges::max_element(frameTimesMs);
+		return result;
+	}
+
+	// One replay per line, so readBaseline can parse the file without a JSON library
+	void writeResults(const std::string& path, const BenchmarkOptions& options, const std::vector<ReplayResult>& results)
+	{
+		std::ofstream file(path, std::ios::trunc);
+		if (!file)
+			throw std::runtime_error(std::format("Failed to open {} for writing", path));
+
+		file << std::format("{{\n  \"render\": {},\n  \"repeat\": {},\n  \"replays\": [\n", options.render, options.repeatCount);
+		for (size_t i = 0; i < results.size(); ++i)
+		{
+			const ReplayResult& result = results[i];
+			file << std::format("    {{ \"name\": \"{}\", \"ticks\": {}, \"ticksPerSecond\": {:.1f}, \"p50Ms\": {:.4f}, "
+				"\"p95Ms\": {:.4f}, \"p99Ms\": {:.4f}, \"maxMs\": {:.4f}, \"diverged\": {} }}{}\n",
+				result.name, result.tickCount, result.ticksPerSecond, result.p50Ms, result.p95Ms, result.p99Ms,
+				result.maxMs, result.diverged, i + 1 < results.size() ? "," : "");
+		}
+		file << "  ]\n}\n";
+	}
+
+	double readNumberField(std::string_view line, std::string_view key)
+	{
+		const std::string pattern = std::format("\"{}\": ", key);
+		const size_t start = line.find(pattern);
+		if (start == std::string_view::npos)
+			throw std::runtime_error(std::format("Baseline entry lacks \"{}\": {}", key, line));
+
+		return std::stod(std::string(line.substr(start + pattern.size())));
+	}
+
+	std::map<std::string, ReplayResult, std::less<>> readBaseline(const std::string& path)
+	{
+		std::ifstream file(path);
+		if (!file)
+			throw std::runtime_error(std::format("Failed to open baseline {}", path));
+
+		std::map<std::string, ReplayResult, std::less<>> baseline;
+		constexpr std::string_view kNameKey = "\"name\": \"";
+		std::string line;
+		while (std::getline(file, line))
+		{
+			const size_t nameStart = line.find(kNameKey);
+			if (nameStart == std::string::npos)
+				continue;
+
+			ReplayResult result;
+			const size_t valueStart = nameStart + kNameKey.size();
+			result.name = line.substr(valueStart, line.find('"', valueStart) - valueStart);
+			result.ticksPerSecond = readNumberField(line, "ticksPerSecond");
+			result.p50Ms = static_cast<float>(readNumberField(line, "p50Ms"));
+			result.p95Ms = static_cast<float>(readNumberField(line, "p95Ms"));
+			result.p99Ms = static_cast<float>(readNumberField(line, "p99Ms"));
+			baseline.emplace(result.name, result);
+		}
+		return baseline;
+	}
+
+	// Prints every metric against its baseline value and returns whether any regressed beyond the threshold
+	bool compareWithBaseline(const std::vector<ReplayResult>& results, const std::string& baselinePath, double thresholdPercent)
+	{
+		const auto baseline = readBaseline(baselinePath);
+		const double limit = 1.0 + thresholdPercent / 100.0;
+
+		bool regressed = false;
+		auto check = [&](std::string_view metric, double current, double reference, bool higherIsWorse)
+		{
+			const bool isRegression = higherIsWorse ? current > reference * limit : current * limit < reference;
+			const double changePercent = reference > 0.0 ? (current / reference - 1.0) * 100.0 : 0.0;
+			std::cout << std::format("    {:<16} {:>12.4f} -> {:>12.4f}  {:+7.1f}%{}\n", metric, reference, current, changePercent,
+				isRegression ? "  REGRESSION" : "");
+			regressed |= isRegression;
+		};
+
+		for (const ReplayResult& result : results)
+		{
+			const auto reference = baseline.find(result.name);
+			if (reference == baseline.end())
+			{
+				std::cout << std::format("  {}: not in baseline\n", result.name);
+				continue;
+			}
+
+			std::cout << std::format("  {}\n", result.name);
+			check("p50 ms", result.p50Ms, reference->second.p50Ms, true);
+			check("p95 ms", result.p95Ms, reference->second.p95Ms, true);
+			check("p99 ms", result.p99Ms, reference->second.p99Ms, true);
+			check("ticks/s", result.ticksPerSecond, reference->second.ticksPerSecond, false);
+		}
+		return regressed;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	try
+	{
+		const BenchmarkOptions options = parseOptions(argc, argv);
+
+		std::vector<ReplayResult> results;
+		bool diverged = false;
+		for (const std::string& path : options.replayPaths)
+		{
+			const ReplayResult& result = results.emplace_back(runReplay(path, options));
+			std::cout << std::format("{:<32} {:>7} ticks  {:>10.1f} ticks/s  p50 {:7.3f}  p95 {:7.3f}  p99 {:7.3f}  max {:7.3f} ms{}\n",
+				result.name, result.tickCount, result.ticksPerSecond, result.p50Ms, result.p95Ms, result.p99Ms, result.maxMs,
+				result.diverged ? "  (diverged from recording)" : "");
+			diverged |= result.diverged;
+		}
+
+		writeResults(options.outputPath, options, results);
+		std::cout << std::format("Wrote {}\n", options.outputPath);
+
+		if (diverged)
+		{
+			std::cout << "Replays diverged from their recordings; re-record them before comparing timings\n";
+			return 1;
+		}
+
+		if (!options.baselinePath.empty())
+		{
+			std::cout << std::format("Comparing against {} (threshold {:.1f}%)\n", options.baselinePath, options.thresholdPercent);
+			if (compareWithBaseline(results, options.baselinePath, options.thresholdPercent))
+			{
+				std::cout << "Performance regressed beyond the threshold\n";
+				return 1;
+			}
+		}
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << '\n';
+		return 2;
+	}
+
+	return 0;
+}
@@ -0,0 +1,120 @@
+// Measures the cost of saving and restoring the full simulation state through a SnapshotRing,
+// for the default level and for an endless field with every chunk slot resident.
+
+#include <algorithm>
+#include <chrono>
+#include <format>
+#include <iostream>
+
+#include "color.hpp"
+#include "gameConfig.hpp"
+#include "levelGenerator.hpp"
+#include "simulationState.hpp"
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	constexpr size_t kIterations = 1'000'000;
+	constexpr size_t kRingSlots = 120; // Two seconds of ticks at 60 Hz
+
+	LevelGenConfig makeConfig()
+	{
+		LevelGenConfig config;
+		config.seed = 1234;
+		config.grid = {
+			.columns = GameConfig::kBlockColumnCount,
+			.rows = GameConfig::kBlockRowCount,
+			.cellSize = GameConfig::kBlockSize,
+			.origin = GameConfig::kLevelOrigin
+		};
+		return config;
+	}
+
+	SimulationState makeState()
+	{
+		SimulationState state;
+		state.rng.seed(1234);
+		state.gameState = GameState::Running;
+		state.lifeCount = 3;
+		state.platform.emplace(GameConfig::kDefaultPlatformStartPosition, GameConfig::kPlatformSize, Color::White);
+		state.ball.emplace(Vector2{ 400.f, 600.f }, GameConfig::kBallRadius, GameConfig::kDefaultBallSpeed);
+		return state;
+	}
+
+	// Hits every block once, so a restore has something to undo
+	void mutate(SimulationState& state, Playfield& playfield)
+	{
+		playfield.forEachChunk([](uint32_t, PlayfieldChunk& chunk)
+		{
+			for (size_t i = 0; i < chunk.blocks.size(); ++i)
+				chunk.blocks.hit(i);
+		});
+		state.score += 100;
+		state.ball->setPosition(state.ball->getPosition() + Vector2{ 10.f, -10.f });
+		state.rng.discard(16);
+	}
+
+	void run(const char* name, SimulationState& state, Playfield& playfield)
+	{
+		SnapshotRing ring(kRingSlots);
+		ring.reserve(playfield.getHitPoints().size());
+
+		// Untouched reference used to verify restores
+		SimulationSnapshot reference;
+		saveSnapshot(state, playfield, reference);
+
+		auto start = Clock::now();
+		for (size_t i = 0; i < kIterations; ++i)
+		{
+			state.score = static_cast<uint32_t>(i);
+			saveSnapshot(state, playfield, ring.push());
+		}
+		const double saveNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / kIterations;
+
+		start = Clock::now();
+		for (size_t i = 0; i < kIterations; ++i)
+			restoreSnapshot(*ring.get(i % ring.size()), state, playfield);
+		const double restoreNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / kIterations;
+
+		mutate(state, playfield);
+		restoreSnapshot(reference, state, playfield);
+		const bool restored = state.score == reference.state.score && state.rng == reference.state.rng &&
+			std::ranges::equal(playfield.getHitPoints(), reference.hitPoints);
+
+		const size_t bytes = sizeof(SimulationState) + sizeof(PlayfieldState) + playfield.getHitPoints().size();
+		std::cout << std::format("{:<24} {:>6} bytes  save {:7.1f} ns  restore {:7.1f} ns  {}\n",
+			name, bytes, saveNs, restoreNs, restored ? "restore verified" : "RESTORE MISMATCH");
+	}
+}
+
+int main()
+{
+	const LevelGenConfig config = makeConfig();
+
+	{
+		const std::vector<LevelBlock> levelBlocks = LevelGenerator(config).generate();
+		Playfield playfield;
+		BlockArrays& blocks = playfield.resetStatic(levelBlocks.size());
+		for (const LevelBlock& block : levelBlocks)
+			blocks.add(getCellCenter(config.grid, block.column, block.row), config.grid.cellSize, block.type, block.hitPoints);
+
+		SimulationState state = makeState();
+		run("default level", state, playfield);
+	}
+
+	{
+		LevelGenConfig endless = config;
+		endless.noiseScale = GameConfig::kEndlessNoiseScale;
+		endless.noiseThreshold = GameConfig::kEndlessNoiseThreshold;
+
+		Playfield playfield;
+		playfield.resetEndless(endless);
+		playfield.update(-1'000'000.f, 800.f); // Stream in every chunk slot
+
+		SimulationState state = makeState();
+		run("endless, all chunks", state, playfield);
+	}
+
+	return 0;
+}
@@ -0,0 +1,187 @@
+// Accuracy and throughput of the VectorBatch primitives against the scalar Vector2 operators.
+//
+// The accuracy checks run first, over vectors spread across 30 orders of magnitude plus zero and
+// axis-aligned vectors, on array sizes that also exercise the scalar tails. The benchmark exits with
+// code 1 when a result is outside its documented bound, so it doubles as a regression check.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <format>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "vectorBatch.hpp"
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	constexpr double kSecondsPerRun = 0.25;
+	constexpr float kUlp = 0x1.0p-23f;
+
+	std::vector<Vector2> makeVectors(size_t count, uint32_t seed)
+	{
+		std::mt19937 rng(seed);
+		std::uniform_real_distribution<float> angle(0.f, 2.f * pi);
+		std::uniform_real_distribution<float> exponent(-15.f, 15.f);
+
+		std::vector<Vector2> vectors(count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			switch (i % 16)
+			{
+				case 0: vectors[i] = {}; break;
+				case 1: vectors[i] = { 0.f, -3.f }; break;
+				case 2: vectors[i] = { 1e-7f, 0.f }; break;
+				default:
+				{
+					const float a = angle(rng);
+					vectors[i] = std::pow(10.f, exponent(rng)) * Vector2{ std::cos(a), std::sin(a) };
+				}
+			}
+		}
+		return vectors;
+	}
+
+	float relativeError(float value, float reference, float magnitude)
+	{
+		return std::abs(value - reference) / std::max(magnitude, std::numeric_limits<float>::min());
+	}
+
+	struct AccuracyCheck
+	{
+		const char* name;
+		float maxError = 0.f; // Relative
+		float bound = 0.f;
+	};
+
+	bool checkAccuracy()
+	{
+		AccuracyCheck add{ "add", 0.f, 0.f };
+		AccuracyCheck multiply{ "multiply", 0.f, 0.f };
+		AccuracyCheck scale{ "scale", 0.f, 0.f };
+		AccuracyCheck multiplyAdd{ "multiplyAdd", 0.f, 2.f * kUlp };
+		AccuracyCheck dot{ "dot", 0.f, 2.f * kUlp };
+		AccuracyCheck normalize{ "normalize", 0.f, 0.f };
+		AccuracyCheck normalizeFast{ "normalizeFast", 0.f, VectorBatch::kFastNormalizeMaxError };
+		AccuracyCheck fastLength{ "normalizeFast length", 0.f, VectorBatch::kFastNormalizeMaxError };
+		bool zeroStaysZero = true;
+
+		for (const size_t count : { 1, 3, 4, 7, 64, 1001, 100000 })
+		{
+			const std::vector<Vector2> a = makeVectors(count, static_cast<uint32_t>(count));
+			const std::vector<Vector2> b = makeVectors(count, static_cast<uint32_t>(count) + 1);
+			std::vector<Vector2> out(count);
+			std::vector<Vector2> exact(count);
+			std::vector<float> dots(count);
+			constexpr float s = 0.37f;
+
+			auto compare = [&](AccuracyCheck& check, auto&& reference)
+			{
+				for (size_t i = 0; i < count; ++i)
+				{
+					const Vector2 expected = reference(i);
+					const float magnitude = std::max(std::abs(expected.x), std::abs(expected.y));
+					check.maxError = std::max({ check.maxError, relativeError(out[i].x, expected.x, magnitude), relativeError(out[i].y, expected.y, magnitude) });
+				}
+			};
+
+			VectorBatch::add(a, b, out);
+			compare(add, [&](size_t i) { return a[i] + b[i]; });
+			VectorBatch::multiply(a, b, out);
+			compare(multiply, [&](size_t i) { return a[i] * b[i]; });
+			VectorBatch::scale(a, s, out);
+			compare(scale, [&](size_t i) { return a[i] * s; });
+			VectorBatch::multiplyAdd(a, b, s, out);
+			compare(multiplyAdd, [&](size_t i) { return a[i] + b[i] * s; });
+
+			VectorBatch::dot(a, b, dots);
+			for (size_t i = 0; i < count; ++i)
+				dot.maxError = std::max(dot.maxError, relativeError(dots[i], ::dot(a[i], b[i]), length(a[i]) * length(b[i])));
+
+			VectorBatch::normalize(a, exact);
+			std::ranges::copy(exact, out.begin());
+			compare(normalize, [&](size_t i) { return lengthSquared(a[i]) > 0.f ? ::normalize(a[i]) : Vector2{}; });
+
+			VectorBatch::normalizeFast(a, out);
+			compare(normalizeFast, [&](size_t i) { return exact[i]; });
+			for (size_t i = 0; i < count; ++i)
+			{
+				if (lengthSquared(a[i]) > 0.f)
+					fastLength.maxError = std::max(fastLength.maxError, std::abs(length(out[i]) - 1.f));
+				else
+					zeroStaysZero = zeroStaysZero && out[i].x == 0.f && out[i].y == 0.f && exact[i].x == 0.f && exact[i].y == 0.f;
+			}
+		}
+
+		bool passed = zeroStaysZero;
+		std::cout << std::format("{:<22} {:>14} {:>14}\n", "accuracy", "max rel. error", "bound");
+		for (const AccuracyCheck& check : { add, multiply, scale, multiplyAdd, dot, normalize, normalizeFast, fastLength })
+		{
+			const bool ok = check.maxError <= check.bound;
+			passed = passed && ok;
+			std::cout << std::format("{:<22} {:>14.3g} {:>14.3g}{}\n", check.name, check.maxError, check.bound, ok ? "" : "  FAILED");
+		}
+		std::cout << std::format("{:<22} {:>14}\n\n", "zero vectors", zeroStaysZero ? "stay zero" : "FAILED");
+		return passed;
+	}
+
+	// Nanoseconds per vector of one operation over count vectors
+	double measure(size_t count, const std::function<void()>& operation)
+	{
+		uint64_t runs = 0;
+		const auto start = Clock::now();
+		double seconds = 0.0;
+		while (seconds < kSecondsPerRun)
+		{
+			operation();
+			runs++;
+			seconds = std::chrono::duration<double>(Clock::now() - start).count();
+		}
+		return 1e9 * seconds / static_cast<double>(runs * count);
+	}
+}
+
+int main()
+{
+	const bool accurate = checkAccuracy();
+
+	std::cout << std::format("{:<14} {:>9} {:>12} {:>12} {:>9}\n", "operation", "vectors", "scalar ns", "batch ns", "speedup");
+	for (const size_t count : { 1024, 65536, 1 << 20 })
+	{
+		std::vector<Vector2> a = makeVectors(count, 1);
+		const std::vector<Vector2> b = makeVectors(count, 2);
+		std::vector<Vector2> out(count);
+		std::vector<float> dots(count);
+		const float s = 1.f / 60.f;
+
+		auto report = [&](const char* name, const std::function<void()>& scalar, const std::function<void()>& batch)
+		{
+			const double scalarNs = measure(count, scalar);
+			const double batchNs = measure(count, batch);
+			std::cout << std::format("{:<14} {:>9} {:>12.3f} {:>12.3f} {:>8.2f}x\n", name, count, scalarNs, batchNs, scalarNs / batchNs);
+		};
+
+		report("add",
+			[&] { for (size_t i = 0; i < count; ++i) out[i] = a[i] + b[i]; },
+			[&] { VectorBatch::add(a, b, out); });
+		report("multiplyAdd",
+			[&] { for (size_t i = 0; i < count; ++i) out[i] = a[i] + b[i] * s; },
+			[&] { VectorBatch::multiplyAdd(a, b, s, out); });
+		report("dot",
+			[&] { for (size_t i = 0; i < count; ++i) dots[i] = dot(a[i], b[i]); },
+			[&] { VectorBatch::dot(a, b, dots); });
+		report("normalize",
+			[&] { for (size_t i = 0; i < count; ++i) out[i] = normalize(a[i]); },
+			[&] { VectorBatch::normalize(a, out); });
+		report("normalizeFast",
+			[&] { for (size_t i = 0; i < count; ++i) out[i] = normalize(a[i]); },
+			[&] { VectorBatch::normalizeFast(a, out); });
+	}
+
+	return accurate ? 0 : 1;
+}
@@ -1,5 +1,6 @@
 #include "ui.hpp"
 
+#include <algorithm>
 #include <format>
 
 #include "color.hpp"
@@ -20,6 +21,17 @@ UI::UI(Renderer& renderer)
 {
 }
 
+void UI::prepareText(uint32_t score)
+{
+	if (mHasScoreText && mScoreTextValue == score)
+		return;
+
+	// Formatted into a fixed buffer so updating the score never allocates
+	mScoreTextLength = std::format_to_n(mScoreText.data(), mScoreText.size(), "Score: {}", score).size;
+	mScoreTextValue = score;
+	mHasScoreText = true;
+}
+
 void UI::render(GameState gameState, uint32_t score, uint32_t lifeCount, bool hasMoved) const
 {
 	switch (gameState)
@@ -82,7 +94,15 @@ void UI::renderNotStarted() const
 
 void UI::drawScore(uint32_t score) const
 {
-	mRenderer.drawText(std::format("Score: {}", score), UIConfig::kScorePos, Color::White);
+	if (mHasScoreText && mScoreTextValue == score)
+		mRenderer.drawText(getScoreText(), UIConfig::kScorePos, Color::White);
+	else
+		mRenderer.drawText(std::format("Score: {}", score), UIConfig::kScorePos, Color::White);
+}
+
+std::string_view UI::getScoreText() const
+{
+	return { mScoreText.data(), std::min(mScoreTextLength, mScoreText.size()) };
 }
 
 void UI::drawLives(uint32_t lifeCount, GameState state) const
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <array>
+#include <string_view>
+
 #include "renderer.hpp"
 #include "gameState.hpp"
 
@@ -8,6 +11,9 @@ class UI
 public:
 	UI(Renderer& renderer);
 
+	// Builds the strings shown next frame. Safe to call off the render thread.
+	void prepareText(uint32_t score);
+
 	void render(GameState gameState, uint32_t score, uint32_t lifeCount, bool hasMoved) const;
 
 private:
@@ -21,5 +27,12 @@ private:
 	void drawLives(uint32_t lifeCount, GameState gameState) const;
 	void drawScore(uint32_t score) const;
 
+	std::string_view getScoreText() const;
+
 	Renderer& mRenderer;
+
+	std::array<char, 32> mScoreText{};
+	size_t mScoreTextLength = 0;
+	uint32_t mScoreTextValue = 0;
+	bool mHasScoreText = false;
 };
\ No newline at end of file
@@ -0,0 +1,63 @@
+#include "aliasTable.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+AliasTable::AliasTable(std::span<const float> weights)
+	: mThresholds(weights.size()), mAliases(weights.size())
+{
+	if (std::ranges::any_of(weights, [](float weight) { return !std::isfinite(weight) || weight < 0.f; }))
+		throw std::invalid_argument("AliasTable weights must be finite and not negative");
+
+	const double total = std::accumulate(weights.begin(), weights.end(), 0.0);
+	if (weights.empty() || !(total > 0.0))
+		throw std::invalid_argument("AliasTable needs at least one positive weight");
+
+	const size_t n = weights.size();
+	std::vector<double> scaled(n);
+	std::vector<uint32_t> small, large;
+	small.reserve(n);
+	large.reserve(n);
+
+	for (size_t i = 0; i < n; ++i)
+	{
+		scaled[i] = weights[i] / total * static_cast<double>(n);
+		(scaled[i] < 1.0 ? small : large).push_back(static_cast<uint32_t>(i));
+	}
+
+	constexpr double kScale = 4294967296.0; // 2^32
+	auto toThreshold = [](double p)
+	{
+		return p >= 1.0 ? UINT32_MAX : static_cast<uint32_t>(p * kScale);
+	};
+
+	while (!small.empty() && !large.empty())
+	{
+		const uint32_t s = small.back(); small.pop_back();
+		const uint32_t l = large.back();
+
+		mThresholds[s] = toThreshold(scaled[s]);
+		mAliases[s] = l;
+
+		scaled[l] -= 1.0 - scaled[s];
+		if (scaled[l] < 1.0)
+		{
+			large.pop_back();
+			small.push_back(l);
+		}
+	}
+
+	// Leftovers are 1 up to rounding error
+	for (uint32_t i : large)
+	{
+		mThresholds[i] = UINT32_MAX;
+		mAliases[i] = i;
+	}
+	for (uint32_t i : small)
+	{
+		mThresholds[i] = UINT32_MAX;
+		mAliases[i] = i;
+	}
+}
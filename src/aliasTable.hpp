@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Walker/Vose alias table: samples an index from a discrete distribution in O(1)
+// using a single 64-bit random value.
+class AliasTable final
+{
+public:
+	AliasTable() = default;
+
+	explicit AliasTable(std::span<const float> weights);
+
+	uint32_t sample(uint64_t random) const
+	{
+		// High 32 bits pick the column, low 32 bits decide between column and alias
+		const auto column = static_cast<uint32_t>(((random >> 32) * mThresholds.size()) >> 32);
+		return static_cast<uint32_t>(random) < mThresholds[column] ? column : mAliases[column];
+	}
+
+	size_t size() const
+	{
+		return mThresholds.size();
+	}
+
+private:
+	std::vector<uint32_t> mThresholds; // Probability of keeping the column, scaled to 2^32
+	std::vector<uint32_t> mAliases;
+};
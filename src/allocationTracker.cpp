@@ -0,0 +1,127 @@
+#include "allocationTracker.hpp"
+
+const char* getFramePhaseName(FramePhase phase)
+{
+	switch (phase)
+	{
+		case FramePhase::Events: return "events";
+		case FramePhase::Update: return "update";
+		case FramePhase::Render: return "render";
+		case FramePhase::UI: return "ui";
+		case FramePhase::Other: return "other";
+		default: return "unknown";
+	}
+}
+
+#ifdef ARKANOID_TRACK_ALLOCATIONS
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+	constexpr size_t kPhaseCount = static_cast<size_t>(FramePhase::Count);
+
+	// Plain atomics with static storage, so the hooks work before main() and never allocate themselves
+	std::atomic<FramePhase> gPhase{ FramePhase::Other };
+	std::atomic<bool> gAssertArmed{ false };
+	std::array<std::atomic<uint64_t>, kPhaseCount> gCounts{};
+	std::array<std::atomic<uint64_t>, kPhaseCount> gBytes{};
+
+	void recordAllocation(size_t size)
+	{
+		const FramePhase phase = gPhase.load(std::memory_order_relaxed);
+		const auto index = static_cast<size_t>(phase);
+		gCounts[index].fetch_add(1, std::memory_order_relaxed);
+		gBytes[index].fetch_add(size, std::memory_order_relaxed);
+
+		if (gAssertArmed.load(std::memory_order_relaxed))
+		{
+			gAssertArmed.store(false, std::memory_order_relaxed);
+
+			char message[128];
+			std::snprintf(message, sizeof(message), "Heap allocation of %zu bytes in the %s phase of a steady-state frame\n",
+				size, getFramePhaseName(phase));
+			std::fputs(message, stderr);
+			std::abort();
+		}
+	}
+
+	void* allocate(size_t size)
+	{
+		recordAllocation(size);
+		if (void* pointer = std::malloc(size != 0 ? size : 1))
+			return pointer;
+		throw std::bad_alloc();
+	}
+
+	void* allocateAligned(size_t size, std::align_val_t alignment)
+	{
+		recordAllocation(size);
+		const auto align = static_cast<size_t>(alignment);
+		if (void* pointer = std::aligned_alloc(align, (size + align - 1) / align * align))
+			return pointer;
+		throw std::bad_alloc();
+	}
+}
+
+void AllocationTracker::setPhase(FramePhase phase)
+{
+	gPhase.store(phase, std::memory_order_relaxed);
+}
+
+void AllocationTracker::beginFrame()
+{
+	for (size_t i = 0; i < kPhaseCount; ++i)
+	{
+		gCounts[i].store(0, std::memory_order_relaxed);
+		gBytes[i].store(0, std::memory_order_relaxed);
+	}
+}
+
+FrameAllocations AllocationTracker::getFrameAllocations()
+{
+	FrameAllocations allocations;
+	for (size_t i = 0; i < kPhaseCount; ++i)
+	{
+		allocations[i].count = gCounts[i].load(std::memory_order_relaxed);
+		allocations[i].bytes = gBytes[i].load(std::memory_order_relaxed);
+	}
+	return allocations;
+}
+
+void AllocationTracker::setAssertArmed(bool isArmed)
+{
+	gAssertArmed.store(isArmed, std::memory_order_relaxed);
+}
+
+void* operator new(size_t size) { return allocate(size); }
+void* operator new[](size_t size) { return allocate(size); }
+void* operator new(size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment); }
+void* operator new[](size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	recordAllocation(size);
+	return std::malloc(size != 0 ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept
+{
+	return operator new(size, tag);
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete[](void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, size_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, size_t, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { std::free(pointer); }
+
+#endif
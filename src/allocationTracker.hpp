@@ -0,0 +1,57 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Parts of a frame that heap allocations are attributed to
+enum class FramePhase : uint8_t
+{
+	Events,
+	Update,
+	Render,
+	UI,
+	Other, // Outside the phases above, e.g. frame limiting
+	Count
+};
+
+const char* getFramePhaseName(FramePhase phase);
+
+struct PhaseAllocations
+{
+	uint64_t count = 0;
+	uint64_t bytes = 0;
+};
+
+using FrameAllocations = std::array<PhaseAllocations, static_cast<size_t>(FramePhase::Count)>;
+
+// Counts global operator new calls per frame phase. The counting hooks are only compiled in when
+// ARKANOID_TRACK_ALLOCATIONS is defined; otherwise every function here is an empty inline stub.
+namespace AllocationTracker
+{
+#ifdef ARKANOID_TRACK_ALLOCATIONS
+	inline constexpr bool kEnabled = true;
+
+	// Attributes allocations on any thread to this phase from now on
+	void setPhase(FramePhase phase);
+
+	// Clears the per-frame counters
+	void beginFrame();
+
+	// Counters since beginFrame()
+	FrameAllocations getFrameAllocations();
+
+	// While armed, every allocation is reported with its phase and size and the process aborts
+	void setAssertArmed(bool isArmed);
+#else
+	inline constexpr bool kEnabled = false;
+
+	inline void setPhase(FramePhase) {}
+
+	inline void beginFrame() {}
+
+	inline FrameAllocations getFrameAllocations() { return {}; }
+
+	inline void setAssertArmed(bool) {}
+#endif
+}
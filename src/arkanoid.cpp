@@ -1,36 +1,127 @@
 #include "arkanoid.hpp"
 
-#include <ranges>
+#include <cfloat>
 #include <stdexcept>
 #include <format>
 #include <random>
 
 #include "color.hpp"
+#include "gameRules.hpp"
+#include "levelGenerator.hpp"
 #include "math.hpp"
-#include "particle.hpp"
 #include "physics.hpp"
+#include "profiler.hpp"
 
-Arkanoid::Arkanoid()
-	: mRng(std::random_device{}())
+namespace
 {
-	if (!SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO | SDL_INIT_EVENTS))
+	// Data touched by the update tasks, used to derive which of them may run concurrently
+	namespace FrameResource
+	{
+		constexpr TaskResources kInput = 1u << 0;
+		constexpr TaskResources kPlatform = 1u << 1;
+		constexpr TaskResources kView = 1u << 2; // View position and walls
+		constexpr TaskResources kPlayfield = 1u << 3;
+		constexpr TaskResources kCollisionContext = 1u << 4;
+		constexpr TaskResources kBall = 1u << 5;
+		constexpr TaskResources kDestroyedBlocks = 1u << 6;
+		constexpr TaskResources kParticles = 1u << 7;
+		constexpr TaskResources kRng = 1u << 8;
+		constexpr TaskResources kScore = 1u << 9; // Score and life count
+		constexpr TaskResources kGameState = 1u << 10;
+		constexpr TaskResources kSound = 1u << 11;
+		constexpr TaskResources kUIText = 1u << 12;
+	}
+}
+
+Arkanoid::Arkanoid(const GameOptions& options)
+	: mOptions(options)
+{
+	// A replay restores the level options and seed of its recording, which makes every draw from mState.rng repeat
+	if (!mOptions.replayPath.empty())
+	{
+		mReplayReader = std::make_unique<ReplayReader>(mOptions.replayPath);
+		const ReplayHeader& header = mReplayReader->getHeader();
+		mOptions.endless = header.endless;
+		mOptions.levelSeed = header.levelSeed;
+		mOptions.levelPath = header.levelPath;
+		mRngSeed = header.rngSeed;
+	}
+	else
+		mRngSeed = std::random_device{}();
+	mState.rng.seed(mRngSeed);
+
+	const bool windowed = mOptions.display == DisplayMode::Window;
+	if (!SDL_Init(windowed ? SDL_INIT_VIDEO | SDL_INIT_AUDIO | SDL_INIT_EVENTS : SDL_INIT_EVENTS))
 		throw std::runtime_error(std::format("SDL_Init Error: {}", SDL_GetError()));
 
-	mWindow = SDL_CreateWindow("Arkanoid", mWindowWidth, mWindowHeight, SDL_WINDOW_RESIZABLE);
-	if (!mWindow)
-		throw std::runtime_error(std::format("SDL_CreateWindow Error: {}", SDL_GetError()));
+	mInputSampler = std::make_unique<InputSampler>();
 
-	mRenderer = std::make_unique<Renderer>(mWindow, mLogicalSize, Vector2{ static_cast<float>(mWindowWidth), static_cast<float>(mWindowHeight) });
+	const RenderBackend renderBackend = mOptions.tiledRenderer ? RenderBackend::Tiled : RenderBackend::Sdl;
+	if (windowed)
+	{
+		mWindow = SDL_CreateWindow("Arkanoid", mWindowWidth, mWindowHeight, SDL_WINDOW_RESIZABLE);
+		if (!mWindow)
+			throw std::runtime_error(std::format("SDL_CreateWindow Error: {}", SDL_GetError()));
+
+		mRenderer = std::make_unique<Renderer>(mWindow, mLogicalSize, Vector2{ static_cast<float>(mWindowWidth), static_cast<float>(mWindowHeight) }, renderBackend);
+	}
+	else if (mOptions.display == DisplayMode::Offscreen)
+	{
+		mOffscreenSurface = SDL_CreateSurface(mWindowWidth, mWindowHeight, SDL_PIXELFORMAT_XRGB8888);
+		if (!mOffscreenSurface)
+			throw std::runtime_error(std::format("SDL_CreateSurface Error: {}", SDL_GetError()));
+
+		mRenderer = std::make_unique<Renderer>(mOffscreenSurface, mLogicalSize, renderBackend);
+	}
 
 	if (mRenderer)
+	{
 		mUI = std::make_unique<UI>(*mRenderer);
+		mPerfOverlay = std::make_unique<PerfOverlay>(*mRenderer);
+	}
+
+	mParticleSystem = std::make_unique<ParticleSystem>(mState.rng);
+
+	if (windowed)
+		mSoundPlayer = std::make_unique<SoundPlayer>();
+
+	if (mOptions.publishTelemetry)
+		mTelemetry = std::make_unique<TelemetryPublisher>();
 
-	mParticleSystem = std::make_unique<ParticleSystem>(mRng);
+	if (mOptions.autoplay)
+		mAutoplay = std::make_unique<AutoplayController>();
 
-	mSoundPlayer = std::make_unique<SoundPlayer>();
+	// Key events are recorded inside Running frames whenever a recorder is on, the flight recorder by default
+	mReplayTick.keyEvents.reserve(kReservedKeyEventCount);
+
+	if (mOptions.flightRecorderSeconds > 0)
+	{
+		const auto capacity = static_cast<size_t>(mOptions.flightRecorderSeconds / kTargetFrameTime);
+		mFlightRecorder = std::make_unique<FlightRecorder>(capacity, kCrashDumpPath);
+		mFlightRecorder->installCrashHandler();
+	}
+
+	// Frame times are measured inside the frames, so their storage has to exist before the first one.
+	// A replay knows how many frames it will run; count them and start over.
+	if (mOptions.collectFrameTimes)
+	{
+		size_t frameCount = kReservedFrameTimeCount;
+		if (mReplayReader)
+		{
+			ReplayTick tick;
+			while (mReplayReader->nextTick(tick))
+				;
+			frameCount = static_cast<size_t>(mReplayReader->getTickCount()) + 1;
+			mReplayReader->rewind();
+		}
+		mFrameTimesMs.reserve(frameCount);
+	}
 
 	createWalls();
 
+	mThreadPool = std::make_unique<ThreadPool>();
+	buildUpdateGraph();
+
 	playSound(SoundPlayer::SoundId::Enter);
 }
 
@@ -39,9 +130,64 @@ Arkanoid::~Arkanoid()
 	if (mRenderer)
 		mRenderer.reset();
 
+	if (mOffscreenSurface)
+	{
+		SDL_DestroySurface(mOffscreenSurface);
+		mOffscreenSurface = nullptr;
+	}
+
 	if (mSoundPlayer)
 		mSoundPlayer.reset();
 
+	for (const TaskStats& stats : mUpdateGraph.getStats())
+	{
+		if (stats.runCount == 0)
+			continue;
+
+		SDL_Log("Task %-24s avg %.3f ms, max %.3f ms, on critical path in %.0f%% of frames", stats.name,
+			static_cast<double>(stats.totalNs) / static_cast<double>(stats.runCount) / 1'000'000.0,
+			static_cast<double>(stats.maxNs) / 1'000'000.0,
+			100.0 * static_cast<double>(stats.criticalPathCount) / static_cast<double>(stats.runCount));
+	}
+	mThreadPool.reset();
+
+	if (mCcdStats.updates > 0)
+		SDL_Log("CCD iterations per ball update: %s", mCcdStats.toString().c_str());
+
+	if (AllocationTracker::kEnabled && mTrackedFrameCount > 0)
+	{
+		for (size_t i = 0; i < mTotalAllocations.size(); ++i)
+		{
+			SDL_Log("Allocations in %-6s avg %.2f (%.0f bytes) per frame, max %llu (%llu bytes)",
+				getFramePhaseName(static_cast<FramePhase>(i)),
+				static_cast<double>(mTotalAllocations[i].count) / static_cast<double>(mTrackedFrameCount),
+				static_cast<double>(mTotalAllocations[i].bytes) / static_cast<double>(mTrackedFrameCount),
+				static_cast<unsigned long long>(mMaxFrameAllocations[i].count),
+				static_cast<unsigned long long>(mMaxFrameAllocations[i].bytes));
+		}
+	}
+
+	if (mAutoplay)
+	{
+		const AutoplayStats& stats = mAutoplay->getStats();
+		const uint32_t games = mAutoplay->getFinishedGameCount();
+		SDL_Log("Autoplay: %u games finished, %u won, %u lost, %u restarted after stalling, avg score %.0f",
+			games, stats.gamesWon, stats.gamesLost, stats.gamesStalled,
+			games > 0 ? static_cast<double>(stats.totalScore) / games : 0.0);
+	}
+
+	SDL_Log("Frame arena: high-water mark %zu of %zu bytes, overflowed in %zu frames",
+		mFrameArena.getHighWaterMark(), mFrameArena.getCapacity(), mFrameArena.getOverflowCount());
+
+	if (mInputSampler)
+	{
+		const auto& latency = mInputSampler->getLatencyStats();
+		if (latency.sampleCount > 0)
+			SDL_Log("Input-to-present latency: avg %.2f ms, max %.2f ms over %llu inputs",
+				latency.averageMs, latency.maxMs, static_cast<unsigned long long>(latency.sampleCount));
+		mInputSampler.reset();
+	}
+
 	if (mWindow)
 	{
 		SDL_DestroyWindow(mWindow);
@@ -55,30 +201,228 @@ void Arkanoid::run()
 	mIsRunning = true;
 
 	const auto perfFrequency = SDL_GetPerformanceFrequency();
-	auto lastFrameTime = SDL_GetPerformanceCounter();
+
+	// The simulation clock only advances by whole ticks, so playback can reproduce it exactly
+	Uint64 previousFrameTimeNs = mReplayReader ? mReplayReader->getHeader().startTimeNs : SDL_GetTicksNS();
+	mState.platformTimeNs = previousFrameTimeNs;
+
+	if (!mOptions.recordPath.empty())
+	{
+		mReplayRecorder = std::make_unique<ReplayRecorder>(mOptions.recordPath, ReplayHeader{
+			.rngSeed = mRngSeed,
+			.startTimeNs = previousFrameTimeNs,
+			.endless = mOptions.endless,
+			.levelSeed = mOptions.levelSeed,
+			.levelPath = mOptions.levelPath
+		});
+	}
+
+	AllocationTracker::beginFrame();
+	PROFILE_THREAD("main");
 
 	while (mIsRunning)
 	{
+		PROFILE_FRAME(mFrameIndex);
+		beginAllocationTracking();
+
+		if (mReplayReader && !mReplayReader->nextTick(mReplayTick))
+		{
+			SDL_Log("Replay finished after %llu ticks%s", static_cast<unsigned long long>(mReplayReader->getTickCount()),
+				mReplayDivergenceTick ? ", diverged from the recording" : ", matched the recording");
+			break;
+		}
+
 		// Measure elapsed time
 		auto frameStartTime = SDL_GetPerformanceCounter();
-		double deltaTime = static_cast<double>(frameStartTime - lastFrameTime) / perfFrequency;
-		lastFrameTime = frameStartTime;
+		// Unthrottled autoplay advances by exactly one tick per frame, so soak runs simulate as fast as the CPU allows
+		if (mReplayReader)
+			mFrameTimeNs = previousFrameTimeNs + mReplayTick.frameDeltaNs;
+		else if (mAutoplay && !mOptions.limitFrameRate)
+			mFrameTimeNs = previousFrameTimeNs + kTargetFrameTimeNs;
+		else
+			mFrameTimeNs = SDL_GetTicksNS();
+		const Uint64 frameDeltaNs = mFrameTimeNs - previousFrameTimeNs;
+		const double deltaTime = static_cast<double>(frameDeltaNs) / 1'000'000'000.0;
+		previousFrameTimeNs = mFrameTimeNs;
 
+		AllocationTracker::setPhase(FramePhase::Events);
 		handleEvents();
+		const auto eventsEndTime = SDL_GetPerformanceCounter();
+		AllocationTracker::setPhase(FramePhase::Update);
 		update(deltaTime);
-		render();
+		finishTick(frameDeltaNs);
+		const auto updateEndTime = SDL_GetPerformanceCounter();
+
+		// An idle scene only changes through events, so it is redrawn only after one
+		const bool idle = isIdle();
+		if (mNeedsRedraw || !idle)
+		{
+			render();
+			mNeedsRedraw = false;
+			mInputSampler->markPresented(SDL_GetTicksNS());
+		}
+		AllocationTracker::setPhase(FramePhase::Other);
+		AllocationTracker::setAssertArmed(false);
+
+		// Drop every container pointing into the arena before releasing it
+		mDestroyedBlocks = FrameVector<BlockHandle>(FrameAllocator<BlockHandle>(mFrameArena));
+		mFrameArena.reset();
 
 		// Frame limiting
+		// Keep sampling input while waiting so key transitions get accurate timestamps
 		auto frameEndTime = SDL_GetPerformanceCounter();
 		double frameElapsed = static_cast<double>(frameEndTime - frameStartTime) / perfFrequency;
+		recordPerfStats(frameStartTime, eventsEndTime, updateEndTime, frameEndTime);
 		double frameDelay = kTargetFrameTime - frameElapsed;
-		if (frameDelay > 0.0)
-			SDL_Delay(static_cast<Uint32>(frameDelay * 1000.0));
+		if (idle)
+		{
+			// Sleep until the OS has an event for us instead of polling at 60 Hz.
+			// The input sampler's event watch still timestamps key transitions as they are pumped.
+			PROFILE_ZONE("Arkanoid::idleWait");
+			SDL_WaitEventTimeout(nullptr, kIdleWaitTimeoutMs);
+
+			// The wait is not simulation time; otherwise the frame that resumes from a pause would move the
+			// ball, the platform and the endless scroll by all of it at once
+			previousFrameTimeNs = SDL_GetTicksNS();
+			mState.platformTimeNs = previousFrameTimeNs;
+		}
+		else if (frameDelay > 0.0 && mOptions.limitFrameRate)
+		{
+			PROFILE_ZONE("Arkanoid::frameLimit");
+			mInputSampler->sampleUntil(SDL_GetTicksNS() + static_cast<Uint64>(frameDelay * 1'000'000'000.0));
+		}
+
+		if (mOptions.traceFrames && mFrameIndex == mOptions.traceFrames->last)
+		{
+			if (Profiler::writeChromeTrace(mOptions.tracePath, mOptions.traceFrames->first, mOptions.traceFrames->last))
+				SDL_Log("Wrote trace of frames %llu-%llu to %s", static_cast<unsigned long long>(mOptions.traceFrames->first),
+					static_cast<unsigned long long>(mOptions.traceFrames->last), mOptions.tracePath.c_str());
+			else
+				SDL_Log("Failed to write trace to %s", mOptions.tracePath.c_str());
+		}
+		mFrameIndex++;
 	}
+
+	// Flushes the recording while the window is still open
+	mReplayRecorder.reset();
+}
+
+const std::vector<float>& Arkanoid::getFrameTimesMs() const
+{
+	return mFrameTimesMs;
+}
+
+const CcdStats& Arkanoid::getCcdStats() const
+{
+	return mCcdStats;
+}
+
+std::optional<uint64_t> Arkanoid::getReplayDivergenceTick() const
+{
+	return mReplayDivergenceTick;
+}
+
+void Arkanoid::saveSnapshot(SimulationSnapshot& snapshot) const
+{
+	snapshot.tick = mFrameIndex;
+	::saveSnapshot(mState, mPlayfield, snapshot);
+}
+
+void Arkanoid::restoreSnapshot(const SimulationSnapshot& snapshot)
+{
+	::restoreSnapshot(snapshot, mState, mPlayfield);
+	placeWalls();
+}
+
+void Arkanoid::recordPerfStats(Uint64 frameStartTime, Uint64 eventsEndTime, Uint64 updateEndTime, Uint64 frameEndTime)
+{
+	if (!mPerfOverlay && !mTelemetry && !mFlightRecorder && !mOptions.collectFrameTimes)
+		return;
+
+	const double ticksToMs = 1000.0 / static_cast<double>(SDL_GetPerformanceFrequency());
+	auto toMs = [ticksToMs](Uint64 ticks) { return static_cast<float>(static_cast<double>(ticks) * ticksToMs); };
+
+	PerfFrameStats stats;
+	stats.frameMs = toMs(frameEndTime - frameStartTime);
+	stats.phaseMs[static_cast<size_t>(FramePhase::Events)] = toMs(eventsEndTime - frameStartTime);
+	stats.phaseMs[static_cast<size_t>(FramePhase::Update)] = toMs(updateEndTime - eventsEndTime);
+	stats.phaseMs[static_cast<size_t>(FramePhase::UI)] = toMs(mUIRenderTicks);
+	stats.phaseMs[static_cast<size_t>(FramePhase::Render)] = toMs(frameEndTime - updateEndTime - mUIRenderTicks);
+	stats.particleCount = mParticleSystem ? static_cast<uint32_t>(mParticleSystem->getParticleCount()) : 0;
+	stats.blockCount = static_cast<uint32_t>(mCollisionContext.blockAABBs.size());
+	stats.ccdIterations = mCcdIterationCount;
+	stats.drawCalls = mRenderer ? mRenderer->getLastFrameDrawCallCount() : 0;
+
+	if (mOptions.collectFrameTimes)
+		mFrameTimesMs.push_back(stats.frameMs);
+
+	if (mPerfOverlay)
+		mPerfOverlay->record(stats);
+
+	if (mFlightRecorder)
+	{
+		mFlightRecord.frameMs = stats.frameMs;
+		mFlightRecord.updateMs = stats.phaseMs[static_cast<size_t>(FramePhase::Update)];
+		mFlightRecord.renderMs = stats.phaseMs[static_cast<size_t>(FramePhase::Render)] + stats.phaseMs[static_cast<size_t>(FramePhase::UI)];
+		mFlightRecorder->record(mFlightRecord);
+
+		// At most one hitch dump per recorder length, so consecutive dumps never overlap
+		const bool isHitch = mOptions.hitchDumpMs > 0.f && stats.frameMs > mOptions.hitchDumpMs;
+		if (isHitch && (!mLastHitchDumpFrame || mFrameIndex - *mLastHitchDumpFrame >= mFlightRecorder->getCapacity()))
+		{
+			mLastHitchDumpFrame = mFrameIndex;
+			dumpFlightRecorder("hitch");
+		}
+	}
+
+	if (mTelemetry)
+	{
+		auto phaseMs = [&stats](FramePhase phase) { return stats.phaseMs[static_cast<size_t>(phase)]; };
+		mTelemetry->publish({
+			.frameIndex = mFrameIndex,
+			.timestampNs = SDL_GetTicksNS(),
+			.frameMs = stats.frameMs,
+			.eventsMs = phaseMs(FramePhase::Events),
+			.updateMs = phaseMs(FramePhase::Update),
+			.renderMs = phaseMs(FramePhase::Render),
+			.uiMs = phaseMs(FramePhase::UI),
+			.particleCount = stats.particleCount,
+			.blockCount = stats.blockCount,
+			.ccdIterations = stats.ccdIterations,
+			.ccdBudgetExhausted = mCcdBudgetExhausted,
+			.drawCalls = stats.drawCalls,
+			.audioQueuedBytes = mSoundPlayer ? mSoundPlayer->getQueuedBytes() : 0
+		});
+	}
+}
+
+void Arkanoid::beginAllocationTracking()
+{
+	if constexpr (!AllocationTracker::kEnabled)
+		return;
+
+	// Close the previous frame, including its frame limiting, and open the next one
+	if (mTrackedFrameCount++ > 0)
+	{
+		mLastFrameAllocations = AllocationTracker::getFrameAllocations();
+		for (size_t i = 0; i < mLastFrameAllocations.size(); ++i)
+		{
+			mTotalAllocations[i].count += mLastFrameAllocations[i].count;
+			mTotalAllocations[i].bytes += mLastFrameAllocations[i].bytes;
+			mMaxFrameAllocations[i].count = std::max(mMaxFrameAllocations[i].count, mLastFrameAllocations[i].count);
+			mMaxFrameAllocations[i].bytes = std::max(mMaxFrameAllocations[i].bytes, mLastFrameAllocations[i].bytes);
+		}
+	}
+	AllocationTracker::beginFrame();
+
+	mRunningFrameCount = mState.gameState == GameState::Running ? mRunningFrameCount + 1 : 0;
+	AllocationTracker::setAssertArmed(mOptions.assertNoAllocations && mRunningFrameCount > kAllocationWarmupFrames);
 }
 
 void Arkanoid::handleEvents()
 {
+	PROFILE_ZONE("Arkanoid::handleEvents");
+
 	SDL_Event event;
 	while (SDL_PollEvent(&event))
 	{
@@ -92,21 +436,63 @@ void Arkanoid::handleEvents()
 			mWindowHeight = targetSize;
 			mRenderer->setLogicalResolution(mLogicalSize, { static_cast<float>(mWindowWidth), static_cast<float>(mWindowHeight) });
 		}
+		if (event.type == SDL_EVENT_KEY_DOWN || event.type == SDL_EVENT_KEY_UP ||
+			(event.type >= SDL_EVENT_WINDOW_FIRST && event.type <= SDL_EVENT_WINDOW_LAST))
+			mNeedsRedraw = true;
 		mInputManager.handleEvent(event);
 	}
 
 	if (mInputManager.isKeyPressed(SDLK_ESCAPE))
 		mIsRunning = false;
 
+	if (mInputManager.isKeyPressed(SDLK_F3) && mPerfOverlay)
+		mPerfOverlay->toggle();
+
+	if (mInputManager.isKeyPressed(SDLK_F9))
+		dumpFlightRecorder("hotkey");
+
+	uint8_t commands = 0;
 	if (mInputManager.isKeyPressed(SDLK_R))
+		commands |= ReplayCommand::kRestart;
+	if (mInputManager.isKeyPressed(SDLK_SPACE))
+		commands |= ReplayCommand::kSpace;
+	mInputManager.clear();
+
+	// Playback takes game commands from the replay and ignores live input apart from quitting and the overlay
+	if (mReplayReader)
+	{
+		InputEvent ignored;
+		while (mInputSampler->popEventBefore(UINT64_MAX, ignored)) {}
+		commands = mReplayTick.commands;
+	}
+	else
+	{
+		if (mAutoplay)
+		{
+			commands |= mAutoplay->chooseCommands(mState);
+			if (mOptions.autoplayGames > 0 && mAutoplay->getFinishedGameCount() >= mOptions.autoplayGames)
+			{
+				mIsRunning = false;
+				commands = 0;
+			}
+		}
+		mReplayTick.commands = commands;
+	}
+
+	applyCommands(commands);
+}
+
+void Arkanoid::applyCommands(uint8_t commands)
+{
+	if (commands & ReplayCommand::kRestart)
 	{
 		restartGame();
 		playSound(SoundPlayer::SoundId::Click);
 	}
 
-	if (mInputManager.isKeyPressed(SDLK_SPACE))
+	if (commands & ReplayCommand::kSpace)
 	{
-		switch (mGameState)
+		switch (mState.gameState)
 		{
 			case GameState::NotStarted:
 			case GameState::GameOver:
@@ -126,44 +512,123 @@ void Arkanoid::handleEvents()
 		}
 		playSound(SoundPlayer::SoundId::Click);
 	}
+}
 
-	MoveDirection moveDir = MoveDirection::None;
-	if (mInputManager.isKeyHeld(SDLK_LEFT))
-		moveDir = MoveDirection::Left;
-	if (mInputManager.isKeyHeld(SDLK_RIGHT))
-		moveDir = MoveDirection::Right;
+void Arkanoid::update(double deltaTime)
+{
+	PROFILE_ZONE("Arkanoid::update");
 
-	mHasMoved |= moveDir != MoveDirection::None;
-	if (mPlatform)
-		mPlatform->handleInput(moveDir);
+	if (mState.gameState == GameState::Paused || mState.gameState == GameState::NotStarted)
+	{
+		applyPendingInput();
+		if (mUI)
+			mUI->prepareText(mState.score);
+		return;
+	}
 
-	mInputManager.clear();
+	mUpdateDeltaTime = deltaTime;
+	mUpdateGraph.run(*mThreadPool);
+}
+
+void Arkanoid::buildUpdateGraph()
+{
+	using namespace FrameResource;
+
+	mUpdateGraph.addTask("steerAutoplay", [this]
+	{
+		if (mAutoplay)
+			steerAutoplay();
+	}, kGameState | kBall | kPlatform | kCollisionContext, kInput);
+
+	mUpdateGraph.addTask("updatePlatform", [this] { updatePlatform(); },
+		0, kInput | kPlatform | kSound);
+
+	mUpdateGraph.addTask("scrollView", [this]
+	{
+		if (mState.gameState == GameState::Running && mPlayfield.isEndless())
+			scrollView(mUpdateDeltaTime);
+	}, kGameState, kView | kPlatform | kPlayfield);
+
+	mUpdateGraph.addTask("updateCollisionContext", [this]
+	{
+		if (mState.gameState != GameState::GameOver)
+			updateCollisionContext();
+	}, kGameState | kView | kPlatform | kPlayfield, kCollisionContext);
 
+	mUpdateGraph.addTask("updateBallPhysics", [this]
+	{
+		if (mState.gameState != GameState::GameOver)
+			updateBallPhysics(mUpdateDeltaTime, mDestroyedBlocks);
+	}, kGameState, kCollisionContext | kBall | kPlayfield | kScore | kDestroyedBlocks | kSound);
+
+	// Moving existing particles does not depend on anything else this frame
+	mUpdateGraph.addTask("integrateParticles", [this]
+	{
+		if (mParticleSystem)
+			mParticleSystem->update(mUpdateDeltaTime);
+	}, 0, kParticles);
+
+	mUpdateGraph.addTask("emitParticles", [this] { emitParticles(mDestroyedBlocks); },
+		kDestroyedBlocks | kBall | kPlatform | kPlayfield, kParticles | kRng);
+
+	mUpdateGraph.addTask("checkGameEndConditions", [this] { checkGameEndConditions(); },
+		kView | kPlatform | kPlayfield | kCollisionContext, kBall | kScore | kGameState | kSound);
+
+	mUpdateGraph.addTask("prepareUIText", [this]
+	{
+		if (mUI)
+			mUI->prepareText(mState.score);
+	}, kScore, kUIText);
 }
 
-void Arkanoid::update(double deltaTime)
+void Arkanoid::steerAutoplay()
 {
-	if (mGameState == GameState::Paused || mGameState == GameState::NotStarted)
-		return;
+	PROFILE_ZONE("Arkanoid::steerAutoplay");
 
-	std::vector<Block*> destroyedBlocks;
-	updatePlatform(deltaTime);
+	// Runs before updatePlatform, on the previous tick's collision context
+	const MoveDirection direction = mAutoplay->chooseDirection(mState, mCollisionContext, static_cast<float>(mUpdateDeltaTime));
 
-	if (mGameState != GameState::GameOver)
+	// Press and release the arrow keys at the start of the tick, like a player holding them for the whole tick
+	mAutoplayEventCount = 0;
+	mAutoplayEventIndex = 0;
+	auto setKey = [this](SDL_Keycode key, bool held, bool down)
 	{
-		updateCollisionContext();
-		updateBallPhysics(deltaTime, destroyedBlocks);
+		if (held != down)
+			mAutoplayEvents[mAutoplayEventCount++] = { .timestampNs = mState.platformTimeNs, .key = key, .down = down };
+	};
+	setKey(SDLK_LEFT, mState.moveLeftHeld, direction == MoveDirection::Left);
+	setKey(SDLK_RIGHT, mState.moveRightHeld, direction == MoveDirection::Right);
+}
+
+void Arkanoid::updatePlatform()
+{
+	PROFILE_ZONE("Arkanoid::updatePlatform");
+
+	if (mState.platform)
+		mPlatformTickStart = mState.platform->getPosition();
+
+	// Integrate piecewise between key transitions so the platform reacts at the sub-frame time a key changed
+	InputEvent event;
+	while (popInputEvent(event))
+	{
+		movePlatform(event.timestampNs);
+		applyInputEvent(event);
 	}
-	updateParticles(deltaTime, destroyedBlocks);
-	checkGameEndConditions();
+	movePlatform(mFrameTimeNs);
 }
 
-void Arkanoid::updatePlatform(double deltaTime)
+void Arkanoid::movePlatform(Uint64 untilNs)
 {
-	if (!mPlatform) return;
+	if (untilNs <= mState.platformTimeNs)
+		return;
+
+	const float deltaTime = static_cast<float>(untilNs - mState.platformTimeNs) / 1'000'000'000.f;
+	mState.platformTimeNs = untilNs;
+
+	if (!mState.platform) return;
 
-	auto nextPosition = mPlatform->getPosition() + mPlatform->getDirection() * static_cast<float>(deltaTime);
-	const auto& size = mPlatform->getSize();
+	auto nextPosition = mState.platform->getPosition() + mState.platform->getDirection() * deltaTime;
+	const auto& size = mState.platform->getSize();
 
 	const auto leftWall = mWalls[0].getAABB().max.x;
 	const auto rightWall = mWalls[2].getAABB().min.x;
@@ -181,129 +646,339 @@ void Arkanoid::updatePlatform(double deltaTime)
 		hitWall = true;
 	}
 
-	mPlatform->setPosition(nextPosition);
+	mState.platform->setPosition(nextPosition);
 
-	if (!mHitWallPreviously && hitWall)
+	if (!mState.hitWallPreviously && hitWall)
 		playSound(SoundPlayer::SoundId::HitWall);
 
-	mHitWallPreviously = hitWall;
+	mState.hitWallPreviously = hitWall;
 }
 
-void Arkanoid::updateCollisionContext()
+void Arkanoid::applyPendingInput()
+{
+	// Keep the held-key state current without moving the platform
+	InputEvent event;
+	while (popInputEvent(event))
+		applyInputEvent(event);
+
+	mState.platformTimeNs = std::max(mState.platformTimeNs, mFrameTimeNs);
+}
+
+bool Arkanoid::popInputEvent(InputEvent& event)
 {
-	// Add blocks in reverse order to ensure the blocks in the front are checked first
-	mCollisionContext.blocks.clear();
-	for (auto& mBlock : std::ranges::reverse_view(mBlocks))
+	if (mReplayReader)
 	{
-		if (!mBlock.isDestroyed())
-			mCollisionContext.blocks.push_back(&mBlock);
+		if (mReplayEventIndex == mReplayTick.keyEvents.size())
+			return false;
+
+		event = mReplayTick.keyEvents[mReplayEventIndex++];
+		return true;
+	}
+
+	if (mAutoplayEventIndex < mAutoplayEventCount)
+		event = mAutoplayEvents[mAutoplayEventIndex++];
+	else
+	{
+		// Autoplay owns the arrow keys, live presses of them are dropped
+		do
+		{
+			if (!mInputSampler->popEventBefore(mFrameTimeNs, event))
+				return false;
+		} while (mAutoplay && (event.key == SDLK_LEFT || event.key == SDLK_RIGHT));
 	}
 
-	mCollisionContext.platform = mPlatform.get();
+	// Other keys never reach the simulation through this path
+	if ((mReplayRecorder || mFlightRecorder) && (event.key == SDLK_LEFT || event.key == SDLK_RIGHT))
+		mReplayTick.keyEvents.push_back(event);
+	return true;
 }
 
-void Arkanoid::updateBallPhysics(double deltaTime, std::vector<Block*>& destroyedBlocks)
+void Arkanoid::applyInputEvent(const InputEvent& event)
 {
-	if (!mBall)
+	if (event.key == SDLK_LEFT)
+		mState.moveLeftHeld = event.down;
+	else if (event.key == SDLK_RIGHT)
+		mState.moveRightHeld = event.down;
+	else
 		return;
 
-	float speed = mBall->getSpeed();
-	float remainingDistance = speed * static_cast<float>(deltaTime);
+	MoveDirection moveDir = getHeldMoveDirection();
+	mState.hasMoved |= moveDir != MoveDirection::None;
+	if (mState.platform)
+		mState.platform->handleInput(moveDir);
+
+	// Replayed and autoplay timestamps are not from this session's clock
+	if (!mReplayReader && !mAutoplay)
+		mInputSampler->markApplied(event);
+}
+
+MoveDirection Arkanoid::getHeldMoveDirection() const
+{
+	MoveDirection moveDir = MoveDirection::None;
+	if (mState.moveLeftHeld)
+		moveDir = MoveDirection::Left;
+	if (mState.moveRightHeld)
+		moveDir = MoveDirection::Right;
+	return moveDir;
+}
+
+void Arkanoid::updateCollisionContext()
+{
+	PROFILE_ZONE("Arkanoid::updateCollisionContext");
+
+	for (size_t i = 0; i < kWallCount; i++)
+		mCollisionContext.walls[i] = mWalls[i].getAABB();
 
-	// Continuous collision detection loop
-	// Simulate step-by-step movement until the full distance is consumed.
-	while (remainingDistance > 0.f)
+	// Add blocks in reverse order to ensure the blocks in the front are checked first.
+	// Only resident chunks are visited, so this stays bounded in endless mode.
+	mCollisionContext.blockAABBs.clear();
+	mCollisionContext.blockHandles.clear();
+	mLowestBlockBottom = -FLT_MAX;
+	mPlayfield.forEachChunk([this](uint32_t slot, const PlayfieldChunk& chunk)
 	{
-		Vector2 moveVec = mBall->getDirection() * remainingDistance;
+		const auto aabbs = chunk.blocks.getAABBs();
+		const auto hitPoints = chunk.blocks.getHitPoints();
+		for (size_t i = aabbs.size(); i-- > 0;)
+		{
+			if (hitPoints[i] == 0)
+				continue;
+
+			mCollisionContext.blockAABBs.push_back(aabbs[i]);
+			mCollisionContext.blockHandles.push_back({ slot, static_cast<uint32_t>(i) });
+			mLowestBlockBottom = std::max(mLowestBlockBottom, aabbs[i].max.y);
+		}
+	});
 
-		// Simulate a single movement step and compute potential collision response
-		PhysicsHitResult hit = Physics::simulateBallStep(
-			*mBall,
-			moveVec,
-			mBall->getPosition(),
-			mCollisionContext
-		);
+	if (mState.platform)
+	{
+		mCollisionContext.platform = mState.platform->getAABB();
+		mCollisionContext.platformDirection = mState.platform->getDirection();
 
-		mBall->setPosition(hit.newPosition);
-		mBall->setDirection(hit.newDirection);
+		// Including the scroll of endless mode, so the ball is swept against the platform's motion over the tick
+		mCollisionContext.platformDisplacement = mState.platform->getPosition() - mPlatformTickStart;
+	}
+	else
+		mCollisionContext.platform.reset();
+}
 
-		// Reduce remaining distance by how far the ball moved before the collision (fractional)
-		remainingDistance -= hit.traveled * remainingDistance;
-		remainingDistance = std::max(remainingDistance, 0.f); // avoid negative values
+void Arkanoid::updateBallPhysics(double deltaTime, FrameVector<BlockHandle>& destroyedBlocks)
+{
+	PROFILE_ZONE("Arkanoid::updateBallPhysics");
 
+	if (!mState.ball)
+		return;
+
+	const float tickDistance = mState.ball->getSpeed() * static_cast<float>(deltaTime);
+
+	// Continuous collision detection loop, one step per contact until the distance is consumed or the
+	// iteration budget runs out
+	const CcdResult ccd = Physics::moveBall(*mState.ball, tickDistance, mCollisionContext, mOptions.ccdIterationBudget,
+		[&](const PhysicsHitResult& hit)
+	{
 		if (hit.hitPlatform && mCollisionContext.platform)
-			mBall->resetSpeedAndColor();
+			mState.ball->resetSpeedAndColor();
 
 		// Handle block destruction logic
 		if (hit.hitBlock)
 		{
-			hit.hitBlock->tryDestroy();
-			if (hit.hitBlock->isDestroyed())
+			const BlockHandle handle = mCollisionContext.blockHandles[*hit.hitBlock];
+			BlockArrays& blocks = mPlayfield.getChunk(handle.chunk).blocks;
+			const BlockType type = blocks.getType(handle.index);
+
+			if (blocks.hit(handle.index))
 			{
-				mScore += hit.hitBlock->getScore();
-				destroyedBlocks.push_back(hit.hitBlock);
+				mState.score += getBlockScore(type);
+				destroyedBlocks.push_back(handle);
+
+				// Later iterations of this step must not hit the block again
+				mCollisionContext.removeBlock(*hit.hitBlock);
 			}
-			if (hit.hitBlock->getType() == BlockType::Booster)
-				mBall->setSpeed(mBall->getSpeed() + GameConfig::kBallSpeedIncrement);
+			if (type == BlockType::Booster)
+				mState.ball->setSpeed(mState.ball->getSpeed() + GameConfig::kBallSpeedIncrement);
 
-			mBall->setColor(hit.hitBlock->getColor());
+			mState.ball->setColor(getBlockColor(type));
 		}
 
-		if (hit.hitBlock || hit.hitPlatform || hit.hitWall)
-			playSound(SoundPlayer::SoundId::Bounce);
-		else
-			break;
+		playSound(SoundPlayer::SoundId::Bounce);
+	});
 
-	}
+	mCcdIterationCount = ccd.iterations;
+	mCcdBudgetExhausted = ccd.budgetExhausted;
+	mCcdStats.record(ccd);
 }
 
 void Arkanoid::checkGameEndConditions()
 {
-	if (!mBall)
+	PROFILE_ZONE("Arkanoid::checkGameEndConditions");
+
+	if (!mState.ball)
 		return;
 
-	if (mScore == mMaxScore)
+	if (!mPlayfield.isEndless() && mState.score == mState.maxScore)
 	{
 		setGameState(GameState::Won);
-		mBall.reset();
+		mState.ball.reset();
+	}
+	else if (mPlayfield.isEndless() && mState.platform && mLowestBlockBottom > mState.platform->getAABB().min.y)
+	{
+		// The scrolling field reached the platform
+		mState.lifeCount = 0;
+		mState.ball.reset();
+		setGameState(GameState::GameOver);
 	}
-	else if (mGameState == GameState::Running && mBall->getPosition().y > mLogicalSize.y)
+	else if (mState.gameState == GameState::Running && GameRules::isBallLost(mState.ball->getPosition(), mState.viewTop))
 	{
-		mLifeCount--;
-		mBall.reset();
-		if (mLifeCount == 0)
+		mState.lifeCount--;
+		mState.ball.reset();
+		if (mState.lifeCount == 0)
 			setGameState(GameState::GameOver);
 		else
 			setGameState(GameState::AwaitingServe);
 	}
 }
 
+void Arkanoid::finishTick(Uint64 frameDeltaNs)
+{
+	if (!mReplayRecorder && !mReplayReader && !mFlightRecorder)
+		return;
+
+	PROFILE_ZONE("Arkanoid::finishTick");
+
+	const uint32_t checksum = computeStateChecksum();
+
+	// Timings are added once the frame is complete, in recordPerfStats
+	if (mFlightRecorder)
+	{
+		const Uint64 tickStartNs = mFrameTimeNs - frameDeltaNs;
+		mFlightRecord.frameIndex = mFrameIndex;
+		mFlightRecord.frameDeltaNs = frameDeltaNs;
+		mFlightRecord.stateChecksum = checksum;
+		mFlightRecord.gameState = mState.gameState;
+		mFlightRecord.commands = mReplayTick.commands;
+		mFlightRecord.keyEventCount = static_cast<uint8_t>(std::min<size_t>(mReplayTick.keyEvents.size(), UINT8_MAX));
+		for (size_t i = 0; i < std::min(mReplayTick.keyEvents.size(), FlightRecord::kMaxKeyEvents); ++i)
+		{
+			const InputEvent& event = mReplayTick.keyEvents[i];
+			const Uint64 offsetNs = event.timestampNs > tickStartNs ? event.timestampNs - tickStartNs : 0;
+			mFlightRecord.keyEvents[i] = {
+				.offsetNs = static_cast<uint32_t>(std::min<Uint64>(offsetNs, UINT32_MAX)),
+				.right = event.key == SDLK_RIGHT,
+				.down = event.down
+			};
+		}
+	}
+
+	if (mReplayRecorder)
+	{
+		mReplayTick.frameDeltaNs = frameDeltaNs;
+		mReplayTick.stateChecksum = checksum;
+		mReplayRecorder->recordTick(mReplayTick);
+	}
+	else if (mReplayReader && checksum != mReplayTick.stateChecksum && !mReplayDivergenceTick)
+	{
+		mReplayDivergenceTick = mReplayReader->getTickCount() - 1;
+		SDL_Log("Replay diverged from the recording at tick %llu", static_cast<unsigned long long>(*mReplayDivergenceTick));
+	}
+
+	// Playback overwrites the whole tick with the next one from the file
+	if (!mReplayReader)
+	{
+		mReplayTick.keyEvents.clear();
+		mReplayTick.commands = 0;
+	}
+	mReplayEventIndex = 0;
+}
+
+void Arkanoid::dumpFlightRecorder(const char* reason) const
+{
+	if (!mFlightRecorder)
+		return;
+
+	const std::string path = std::format("flight_recorder_{}_{}.csv", reason, mFrameIndex);
+	if (mFlightRecorder->dump(path.c_str(), reason))
+		SDL_Log("Flight recorder: wrote the last %llu ticks to %s", static_cast<unsigned long long>(
+			std::min<uint64_t>(mFlightRecorder->getRecordCount(), mFlightRecorder->getCapacity())), path.c_str());
+	else
+		SDL_Log("Flight recorder: failed to write %s", path.c_str());
+}
+
+uint32_t Arkanoid::computeStateChecksum() const
+{
+	StateChecksum checksum;
+	checksum.add(mState.gameState);
+	checksum.add(mState.score);
+	checksum.add(mState.lifeCount);
+	checksum.add(mState.viewTop);
+	checksum.add(mState.platformTimeNs);
+
+	if (mState.platform)
+	{
+		checksum.add(mState.platform->getPosition());
+		checksum.add(mState.platform->getDirection());
+	}
+
+	checksum.add(mState.ball.has_value());
+	if (mState.ball)
+	{
+		checksum.add(mState.ball->getPosition());
+		checksum.add(mState.ball->getDirection());
+		checksum.add(mState.ball->getSpeed());
+	}
+
+	mPlayfield.forEachChunk([&checksum](uint32_t slot, const PlayfieldChunk& chunk)
+	{
+		checksum.add(slot);
+		checksum.add(chunk.index);
+		checksum.add(chunk.blocks.getHitPoints());
+	});
+
+	return checksum.get();
+}
+
 void Arkanoid::render() const
 {
+	PROFILE_ZONE("Arkanoid::render");
+
 	if (!mRenderer)
 		return;
 
+	AllocationTracker::setPhase(FramePhase::Render);
 	mRenderer->clearScreen();
 
+	mRenderer->setCameraPosition({ 0.f, mState.viewTop });
 	renderGameObjects();
+
+	AllocationTracker::setPhase(FramePhase::UI);
+	const auto uiStartTime = SDL_GetPerformanceCounter();
+	mRenderer->setCameraPosition({});
 	renderUI();
+	mUIRenderTicks = SDL_GetPerformanceCounter() - uiStartTime;
 
+	AllocationTracker::setPhase(FramePhase::Render);
 	mRenderer->presentFrame();
 }
 
 void Arkanoid::renderGameObjects() const
 {
+	PROFILE_ZONE("Arkanoid::renderGameObjects");
+
 	for (auto& wall : mWalls)
 		wall.render(*mRenderer);
 
-	if (mBall)
-		mBall->render(*mRenderer);
+	if (mState.ball)
+		mState.ball->render(*mRenderer);
 
-	if (mPlatform)
-		mPlatform->render(*mRenderer);
+	if (mState.platform)
+		mState.platform->render(*mRenderer);
+
+	const float viewBottom = mState.viewTop + mLogicalSize.y;
+	mPlayfield.forEachChunk([&](uint32_t, const PlayfieldChunk& chunk)
+	{
+		if (chunk.bottom < mState.viewTop || chunk.top > viewBottom)
+			return;
 
-	for (const auto& block : mBlocks)
-		block.render(*mRenderer);
+		chunk.blocks.render(*mRenderer);
+	});
 
 	if (mParticleSystem)
 		mParticleSystem->render(*mRenderer);
@@ -311,119 +986,184 @@ void Arkanoid::renderGameObjects() const
 
 void Arkanoid::renderUI() const
 {
+	PROFILE_ZONE("Arkanoid::renderUI");
+
 	if (mUI)
-		mUI->render(mGameState, mScore, mLifeCount, mHasMoved);
+		mUI->render(mState.gameState, mState.score, mState.lifeCount, mState.hasMoved);
+
+	if (mPerfOverlay && mPerfOverlay->isVisible())
+		mPerfOverlay->render();
 }
 
 void Arkanoid::startGame()
 {
-	// Reset game state
-	mGameState = GameState::AwaitingServe;
-	mScore = 0;
-	mMaxScore = 0;
-	mLifeCount = 3;
-	mHasMoved = false;
+	// Building a level allocates; the frames after it are not steady state
+	AllocationTracker::setAssertArmed(false);
+	mRunningFrameCount = 0;
 
-	generateLevel();
+	// Reset game state
+	mState.gameState = GameState::AwaitingServe;
+	mState.score = 0;
+	mState.maxScore = 0;
+	mState.lifeCount = 3;
+	mState.hasMoved = false;
+	mState.viewTop = 0.f;
+	placeWalls();
+
+	if (mOptions.endless)
+		generateEndlessLevel();
+	else if (mOptions.levelPath.empty())
+		generateLevel();
+	else
+		loadLevel(mOptions.levelPath);
 	spawnPlatform();
 }
 
 void Arkanoid::restartGame()
 {
-	mBall.reset();
+	mState.ball.reset();
 	startGame();
 }
 
 void Arkanoid::createWalls()
 {
 	mWalls.reserve(kWallCount);
-	mWalls.emplace_back(Vector2{ 5.f, mLogicalSize.y * 0.5f }, Vector2{ 10.f, mLogicalSize.y }, Color::Gray); // Left wall
-	mWalls.emplace_back(Vector2{ mLogicalSize.x * 0.5f, 5.f }, Vector2{ mLogicalSize.x, 10.f }, Color::Gray); // Top wall
-	mWalls.emplace_back(Vector2{ mLogicalSize.x - 5.f, mLogicalSize.y * 0.5f }, Vector2{ 10.f, mLogicalSize.y }, Color::Gray); // Right wall
+	for (const AABB& wall : GameRules::getWalls())
+		mWalls.emplace_back(Vector2{}, wall.max - wall.min, Color::Gray);
+	placeWalls();
 
-	for (uint32_t i = 0; i < mWalls.size(); i++)
-		mCollisionContext.walls[i] = &mWalls[i];
 }
 
-void Arkanoid::generateLevel()
+void Arkanoid::placeWalls()
 {
-	mBlocks.clear();
-	mBlocks.reserve(GameConfig::kBlockColumnCount * GameConfig::kBlockRowCount);
+	// Walls frame the visible area
+	const std::array<AABB, kWallCount> walls = GameRules::getWalls(mState.viewTop);
+	for (size_t i = 0; i < kWallCount; i++)
+		mWalls[i].setPosition((walls[i].min + walls[i].max) * 0.5f);
+}
 
-	constexpr std::array blockTypes =
-	{
-		BlockType::Normal,
-		BlockType::Booster,
-		BlockType::Reinforced
-	};
+void Arkanoid::scrollView(double deltaTime)
+{
+	PROFILE_ZONE("Arkanoid::scrollView");
 
-	constexpr std::array blockProbabilities =
-	{
-		0.7f,
-		0.2f,
-		0.1f,
+	const float scroll = GameConfig::kEndlessScrollSpeed * static_cast<float>(deltaTime);
+	mState.viewTop -= scroll;
+	placeWalls();
+
+	if (mState.platform)
+		mState.platform->setPosition(mState.platform->getPosition() - Vector2{ 0.f, scroll });
+
+	mPlayfield.update(mState.viewTop, mState.viewTop + mLogicalSize.y);
+}
+
+LevelGenConfig Arkanoid::makeLevelGenConfig()
+{
+	// Two named draws: the operands of | are unsequenced, so the order would be up to the compiler.
+	// Drawn even with a fixed seed, so the game's random stream does not depend on it.
+	const uint64_t high = mState.rng();
+	const uint64_t low = mState.rng();
+
+	LevelGenConfig config;
+	config.seed = mOptions.levelSeed.value_or((high << 32) | low);
+	config.grid = {
+		.columns = GameConfig::kBlockColumnCount,
+		.rows = GameConfig::kBlockRowCount,
+		.cellSize = GameConfig::kBlockSize,
+		.origin = GameConfig::kLevelOrigin
 	};
+	return config;
+}
 
-	// Use cumulative probabilities to choose block types
-	std::vector<float> cumulativeProbabilities;
-	cumulativeProbabilities.reserve(blockProbabilities.size());
-	float cumulativeSum = 0.0f;
-	for (const auto& prob : blockProbabilities)
-	{
-		cumulativeSum += prob;
-		cumulativeProbabilities.push_back(cumulativeSum);
-	}
+void Arkanoid::generateLevel()
+{
+	const LevelGenConfig config = makeLevelGenConfig();
+	const std::vector<LevelBlock> levelBlocks = LevelGenerator(config).generate();
 
-	std::uniform_real_distribution<float> dist(0.0f, 1.0f);
-	for (size_t i = 0; i < GameConfig::kBlockColumnCount; ++i)
-	{
-		for (size_t j = 0; j < GameConfig::kBlockRowCount; ++j)
-		{
-			Vector2 position = { static_cast<float>(10 + i * GameConfig::kBlockSize.x + GameConfig::kBlockSize.x * 0.5f), static_cast<float>(10 + j * GameConfig::kBlockSize.y + GameConfig::kBlockSize.y * 0.5f) };
+	BlockArrays& blocks = mPlayfield.resetStatic(levelBlocks.size());
+	for (const auto& levelBlock : levelBlocks)
+		addBlock(blocks, config.grid, levelBlock);
+}
 
-			float randomValue = dist(mRng);
-			BlockType blockType = BlockType::Normal;
-			for (size_t k = 0; k < cumulativeProbabilities.size(); ++k)
-			{
-				if (randomValue <= cumulativeProbabilities[k])
-				{
-					blockType = blockTypes[k];
-					break;
-				}
-			}
+void Arkanoid::generateEndlessLevel()
+{
+	LevelGenConfig config = makeLevelGenConfig();
+	config.noiseScale = GameConfig::kEndlessNoiseScale;
+	config.noiseThreshold = GameConfig::kEndlessNoiseThreshold;
 
-			mBlocks.emplace_back(position, GameConfig::kBlockSize, blockType);
-			mMaxScore += mBlocks.back().getScore(); // Update max score based on block type
-		}
-	}
+	mPlayfield.resetEndless(config);
+	mPlayfield.update(mState.viewTop, mState.viewTop + mLogicalSize.y);
+}
+
+void Arkanoid::loadLevel(const std::string& path)
+{
+	LevelReader reader(path);
+	const LevelGrid& grid = reader.getHeader().grid;
+
+	// Size the block storage once from the header, which the reader checked against the grid and the records,
+	// then build blocks straight from the stream
+	BlockArrays& blocks = mPlayfield.resetStatic(reader.getHeader().blockCount);
+	reader.forEachBlock([&](const LevelBlock& levelBlock) { addBlock(blocks, grid, levelBlock); });
+}
+
+void Arkanoid::addBlock(BlockArrays& blocks, const LevelGrid& grid, const LevelBlock& levelBlock)
+{
+	blocks.add(getCellCenter(grid, levelBlock.column, levelBlock.row), grid.cellSize, levelBlock.type, levelBlock.hitPoints);
+	mState.maxScore += getBlockScore(levelBlock.type); // Update max score based on block type
 }
 
 void Arkanoid::spawnPlatform()
 {
-	if (!mPlatform)
-		mPlatform = std::make_unique<Platform>(GameConfig::kDefaultPlatformStartPosition, GameConfig::kPlatformSize, Color::White);
+	if (!mState.platform)
+		mState.platform.emplace(GameConfig::kDefaultPlatformStartPosition, GameConfig::kPlatformSize, Color::White);
+
+	// Keep the horizontal position across games, but return to the start height
+	mState.platform->setPosition({ mState.platform->getPosition().x, mState.viewTop + GameConfig::kDefaultPlatformStartPosition.y });
+
+	mState.platform->handleInput(getHeldMoveDirection());
 }
 
 void Arkanoid::spawnBall()
 {
-	Vector2 ballStartPosition = { mPlatform->getPosition().x, mPlatform->getPosition().y - GameConfig::kBallRadius - mPlatform->getSize().y * 0.5f - 1.f };
-	mBall = std::make_unique<Ball>(ballStartPosition, GameConfig::kBallRadius, GameConfig::kDefaultBallSpeed);
+	mState.ball.emplace(GameRules::getServePosition(mState.platform->getPosition()), GameConfig::kBallRadius, GameConfig::kDefaultBallSpeed);
 
 	// Set random angle for the ball's initial direction
-	constexpr float spreadAngle = 30.f;
-	static std::uniform_real_distribution angleDist(-spreadAngle, spreadAngle);
+	mState.ball->setDirection(GameRules::drawServeDirection(mState.rng));
+	playSound(SoundPlayer::SoundId::Start);
+}
 
-	float angleDeg = angleDist(mRng);
-	float angleRad = angleDeg * (pi / 180.0f);
+bool Arkanoid::isIdle() const
+{
+	// Benchmarks, playback, autoplay and offscreen runs go flat out. A recording's clock is the sum of its
+	// tick deltas, so it keeps ticking through idle screens rather than skipping the time spent waiting.
+	if (!mOptions.limitFrameRate || mReplayReader || mReplayRecorder || mAutoplay || !mWindow)
+		return false;
 
-	Vector2 dir = { std::sin(angleRad), -std::cos(angleRad) };
-	mBall->setDirection(dir);
-	playSound(SoundPlayer::SoundId::Start);
+	switch (mState.gameState)
+	{
+		case GameState::NotStarted:
+		case GameState::Paused:
+			break;
+		case GameState::GameOver:
+		case GameState::Won:
+			// The platform can still be moved around on the end screens
+			if (mState.platform && lengthSquared(mState.platform->getDirection()) > 0.f)
+				return false;
+			break;
+		default:
+			return false;
+	}
+
+	// Particles still fading out and the overlay's live graph change every frame
+	if (mParticleSystem && mParticleSystem->getParticleCount() > 0)
+		return false;
+
+	return !mPerfOverlay || !mPerfOverlay->isVisible();
 }
 
 void Arkanoid::setGameState(GameState newState)
 {
-	mGameState = newState;
+	mNeedsRedraw = true;
+	mState.gameState = newState;
 	switch (newState)
 	{
 		case GameState::Won: playSound(SoundPlayer::SoundId::Win); break;
@@ -439,19 +1179,22 @@ void Arkanoid::playSound(SoundPlayer::SoundId soundId) const
 		mSoundPlayer->play(soundId);
 }
 
-void Arkanoid::updateParticles(double deltaTime, const std::vector<Block*>& destroyedBlocks) const
+void Arkanoid::emitParticles(const FrameVector<BlockHandle>& destroyedBlocks) const
 {
+	PROFILE_ZONE("Arkanoid::emitParticles");
+
 	if (!mParticleSystem)
 		return;
 
-	mParticleSystem->update(deltaTime);
-
-	for (const auto& b : destroyedBlocks)
-		mParticleSystem->emitFromBlock(*b);
+	for (const BlockHandle& handle : destroyedBlocks)
+	{
+		const BlockArrays& blocks = mPlayfield.getChunk(handle.chunk).blocks;
+		mParticleSystem->emitFromBlock(blocks.getAABBs()[handle.index], getBlockColor(blocks.getType(handle.index)));
+	}
 
-	if (mBall)
-		mParticleSystem->emitFromBall(*mBall);
+	if (mState.ball)
+		mParticleSystem->emitFromBall(*mState.ball);
 
-	if (mPlatform)
-		mParticleSystem->emitFromPlatform(*mPlatform);
+	if (mState.platform)
+		mParticleSystem->emitFromPlatform(*mState.platform);
 }
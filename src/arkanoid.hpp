@@ -1,48 +1,104 @@
 #pragma once
+#include <array>
 #include <memory>
+#include <optional>
 #include <random>
 #include <vector>
 
 #include "ball.hpp"
 #include "block.hpp"
-#include "particle.hpp"
 #include "platform.hpp"
+#include "playfield.hpp"
 #include "renderer.hpp"
 #include "soundPlayer.hpp"
 #include "wall.hpp"
 #include "SDL3/SDL.h"
+#include "allocationTracker.hpp"
+#include "autoplay.hpp"
 #include "collisionContext.hpp"
+#include "flightRecorder.hpp"
+#include "frameArena.hpp"
 #include "inputManager.hpp"
+#include "inputSampler.hpp"
 #include "gameState.hpp"
 #include "gameConfig.hpp"
+#include "gameOptions.hpp"
+#include "levelFormat.hpp"
+#include "levelGenerator.hpp"
 #include "particleSystem.hpp"
+#include "perfOverlay.hpp"
+#include "physics.hpp"
+#include "replay.hpp"
+#include "simulationState.hpp"
+#include "taskGraph.hpp"
+#include "telemetryPublisher.hpp"
+#include "threadPool.hpp"
 #include "UI.hpp"
 
 class Arkanoid final
 {
 public:
-	Arkanoid();
+	explicit Arkanoid(const GameOptions& options = {});
 
 	~Arkanoid();
 
 	void run();
 
+	// CPU time of every frame run so far in ms, kept when GameOptions::collectFrameTimes is set
+	const std::vector<float>& getFrameTimesMs() const;
+	const CcdStats& getCcdStats() const;
+
+	// First played back tick whose state did not match the recording
+	std::optional<uint64_t> getReplayDivergenceTick() const;
+
+	// Rollback support: copies the whole simulation into a snapshot slot and back. Particles are
+	// cosmetic and keep running; a snapshot can only be restored on the level it was taken on.
+	void saveSnapshot(SimulationSnapshot& snapshot) const;
+
+	void restoreSnapshot(const SimulationSnapshot& snapshot);
+
 private:
 
+	void recordPerfStats(Uint64 frameStartTime, Uint64 eventsEndTime, Uint64 updateEndTime, Uint64 frameEndTime);
+
+	void beginAllocationTracking();
+
 	void handleEvents();
 
+	void applyCommands(uint8_t commands);
+
 	void update(double deltaTime);
 
-	void updatePlatform(double deltaTime);
+	void buildUpdateGraph();
+
+	void steerAutoplay();
+
+	void updatePlatform();
+
+	void movePlatform(Uint64 untilNs);
+
+	void applyPendingInput();
+
+	bool popInputEvent(InputEvent& event);
+
+	void applyInputEvent(const InputEvent& event);
+
+	MoveDirection getHeldMoveDirection() const;
 
 	void updateCollisionContext();
 
-	void updateBallPhysics(double deltaTime, std::vector<Block*>& destroyedBlocks);
+	void updateBallPhysics(double deltaTime, FrameVector<BlockHandle>& destroyedBlocks);
 
-	void updateParticles(double deltaTime, const std::vector<Block*>& destroyedBlocks) const;
+	void emitParticles(const FrameVector<BlockHandle>& destroyedBlocks) const;
 
 	void checkGameEndConditions();
 
+	void finishTick(Uint64 frameDeltaNs);
+
+	void dumpFlightRecorder(const char* reason) const;
+
+	uint32_t computeStateChecksum() const;
+
 	void render() const;
 
 	void renderGameObjects() const;
@@ -55,37 +111,108 @@ private:
 
 	void createWalls();
 
+	void placeWalls();
+
+	void scrollView(double deltaTime);
+
+	LevelGenConfig makeLevelGenConfig();
+
 	void generateLevel();
 
+	void generateEndlessLevel();
+
+	void loadLevel(const std::string& path);
+
+	void addBlock(BlockArrays& blocks, const LevelGrid& grid, const LevelBlock& levelBlock);
+
 	void spawnPlatform();
 
 	void spawnBall();
 
+	bool isIdle() const;
+
 	void setGameState(GameState newState);
 
 	void playSound(SoundPlayer::SoundId soundId) const;
 
+	GameOptions mOptions;
+
 	// Main loop
 	bool mIsRunning = false;
+	uint64_t mFrameIndex = 0;
+
+	// Idle power mode: menus and pause screens block on events and redraw only when something changed
+	static constexpr Sint32 kIdleWaitTimeoutMs = 500;
+	bool mNeedsRedraw = true;
 
 	// Window
 	SDL_Window* mWindow = nullptr;
+	SDL_Surface* mOffscreenSurface = nullptr; // Render target of DisplayMode::Offscreen
 	int mWindowWidth = 800;
 	int mWindowHeight = 800;
 	int kMinWindowSize = 400;
 
 	// Size of the logical game area
-	Vector2 mLogicalSize{ 800.0f, 800.0f };
+	Vector2 mLogicalSize{ GameConfig::kViewSize, GameConfig::kViewSize };
 
 	// Input handling
 	InputManager mInputManager;
+	std::unique_ptr<InputSampler> mInputSampler;
+	Uint64 mFrameTimeNs = 0; // Time the current frame is simulated up to
+
+	// Deterministic replay: the recorder captures, or the reader supplies, every tick's clock and input
+	std::unique_ptr<ReplayRecorder> mReplayRecorder;
+	std::unique_ptr<ReplayReader> mReplayReader;
+	ReplayTick mReplayTick; // Input of the tick being recorded (for a replay or the flight recorder) or played back
+	static constexpr size_t kReservedKeyEventCount = 64; // Platform key transitions per tick, far more than a hand can press
+	size_t mReplayEventIndex = 0; // Next key event of mReplayTick to play back
+	std::optional<uint64_t> mReplayDivergenceTick; // First tick whose state checksum did not match the recording
+
+	// Autoplay: steers through synthetic arrow key events at the start of each tick, so its sessions record and replay like live ones
+	std::unique_ptr<AutoplayController> mAutoplay;
+	std::array<InputEvent, 2> mAutoplayEvents{};
+	size_t mAutoplayEventCount = 0;
+	size_t mAutoplayEventIndex = 0; // Next synthetic event handed out by popInputEvent
+
+	// Always-on flight recorder of recent ticks, dumped with F9, on hitches and on crashes
+	static constexpr const char* kCrashDumpPath = "flight_recorder_crash.csv";
+	std::unique_ptr<FlightRecorder> mFlightRecorder;
+	FlightRecord mFlightRecord; // Tick being recorded
+	std::optional<uint64_t> mLastHitchDumpFrame;
+
+	// Transient per-frame data, released at the end of every frame
+	static constexpr size_t kFrameArenaCapacity = 64 * 1024;
+	FrameArena mFrameArena{ kFrameArenaCapacity };
+
+	// Allocation tracking (instrumentation builds only)
+	static constexpr uint32_t kAllocationWarmupFrames = 120; // Running frames before steady state is assumed
+	uint32_t mRunningFrameCount = 0;
+	uint64_t mTrackedFrameCount = 0;
+	FrameAllocations mLastFrameAllocations{};
+	FrameAllocations mTotalAllocations{};
+	FrameAllocations mMaxFrameAllocations{};
+
+	// Update scheduling
+	std::unique_ptr<ThreadPool> mThreadPool;
+	TaskGraph mUpdateGraph;
+	double mUpdateDeltaTime = 0.0; // Frame time the update graph is currently simulating
+	FrameVector<BlockHandle> mDestroyedBlocks{ FrameAllocator<BlockHandle>(mFrameArena) };
 
 	// Renderer
 	std::unique_ptr<Renderer> mRenderer;
 	static constexpr double kTargetFrameTime = 1.0 / 60.0; // 16.67 ms
+	static constexpr Uint64 kTargetFrameTimeNs = 1'000'000'000 / 60;
+	static constexpr size_t kReservedFrameTimeCount = 60 * 60 * 10; // Ten minutes of live frames for collectFrameTimes
 
 	// UI
 	std::unique_ptr<UI> mUI;
+	std::unique_ptr<PerfOverlay> mPerfOverlay; // Toggled with F3
+	std::unique_ptr<TelemetryPublisher> mTelemetry;
+	mutable Uint64 mUIRenderTicks = 0;
+	std::vector<float> mFrameTimesMs;
+	uint32_t mCcdIterationCount = 0; // CCD steps of the last ball update
+	bool mCcdBudgetExhausted = false; // The last ball update ran out of CCD steps
+	CcdStats mCcdStats;
 
 	// Sound player
 	std::unique_ptr<SoundPlayer> mSoundPlayer;
@@ -93,24 +220,17 @@ private:
 	// Game objects
 	static constexpr size_t kWallCount = 3;
 	std::vector<Wall> mWalls;
-	std::unique_ptr<Platform> mPlatform;
-	std::unique_ptr<Ball> mBall;
-	std::vector<Block> mBlocks;
+	Playfield mPlayfield;
 
 	// Particle system
 	std::unique_ptr<ParticleSystem> mParticleSystem;
 
 	// Collisions
 	CollisionContext mCollisionContext;
+	Vector2 mPlatformTickStart; // Platform position before updatePlatform moved it this tick
 
-	// Game state
-	uint32_t mScore;
-	uint32_t mMaxScore;
-	GameState mGameState = GameState::NotStarted;
-	uint32_t mLifeCount;
-	bool mHitWallPreviously = false;
-	bool mHasMoved = false;
-
-	// Random numbers
-	std::mt19937 mRng;
+	// Game state, including the ball, platform and random numbers
+	SimulationState mState;
+	float mLowestBlockBottom = 0.f;
+	uint32_t mRngSeed = 0;
 };
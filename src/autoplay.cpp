@@ -0,0 +1,101 @@
+#include "autoplay.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "physics.hpp"
+#include "replay.hpp"
+
+uint8_t AutoplayController::chooseCommands(const SimulationState& state)
+{
+	switch (state.gameState)
+	{
+		case GameState::NotStarted:
+		case GameState::AwaitingServe:
+			mTicksWithoutScore = 0;
+			return ReplayCommand::kSpace;
+		case GameState::GameOver:
+		case GameState::Won:
+			(state.gameState == GameState::Won ? mStats.gamesWon : mStats.gamesLost)++;
+			mStats.totalScore += state.score;
+			mTicksWithoutScore = 0;
+			return ReplayCommand::kSpace;
+		case GameState::Running:
+			break;
+		case GameState::Paused:
+			// Someone paused on purpose; leave resuming to them
+			return 0;
+	}
+
+	if (state.score != mLastScore)
+	{
+		mLastScore = state.score;
+		mTicksWithoutScore = 0;
+	}
+	else if (++mTicksWithoutScore >= kStallTicks)
+	{
+		// Pure reflections can settle into a loop that never reaches the last blocks
+		mStats.gamesStalled++;
+		mStats.totalScore += state.score;
+		mTicksWithoutScore = 0;
+		return ReplayCommand::kRestart;
+	}
+	return 0;
+}
+
+MoveDirection AutoplayController::chooseDirection(const SimulationState& state, const CollisionContext& context, float deltaTime)
+{
+	if (!state.ball || !state.platform)
+		return MoveDirection::None;
+
+	const Ball& ball = *state.ball;
+	const Platform& platform = *state.platform;
+	const float interceptY = platform.getAABB().min.y - ball.getRadius();
+	const float targetX = predictInterceptX(ball, context, interceptY).value_or(ball.getPosition().x);
+
+	// Stop once within a frame's travel or a quarter of the platform, whichever is larger, so it does not oscillate
+	const float deadZone = std::max(platform.getSpeed() * deltaTime, platform.getSize().x * 0.25f);
+	const float offset = targetX - platform.getPosition().x;
+	if (std::abs(offset) <= deadZone)
+		return MoveDirection::None;
+
+	return offset < 0.f ? MoveDirection::Left : MoveDirection::Right;
+}
+
+std::optional<float> AutoplayController::predictInterceptX(const Ball& ball, const CollisionContext& context, float interceptY)
+{
+	// Follow the ball along straight segments between bounces. Blocks are treated as if they survive,
+	// the prediction is redone every tick anyway.
+	Ball probe = ball;
+	Vector2 position = ball.getPosition();
+	for (uint32_t step = 0; step < kMaxPredictionSteps; ++step)
+	{
+		const Vector2 direction = probe.getDirection();
+		if (direction.y > 0.f && position.y > interceptY)
+			return std::nullopt; // Already below the platform line
+
+		const Vector2 moveVector = direction * kPredictionStepLength;
+		const PhysicsHitResult hit = Physics::simulateBallStep(probe, moveVector, position, context);
+		const Vector2 end = position + moveVector * hit.traveled;
+
+		if (hit.hitPlatform)
+			return end.x;
+
+		if (direction.y > 0.f && end.y >= interceptY)
+			return position.x + (interceptY - position.y) / direction.y * direction.x;
+
+		position = hit.newPosition;
+		probe.setDirection(hit.newDirection);
+	}
+	return std::nullopt;
+}
+
+const AutoplayStats& AutoplayController::getStats() const
+{
+	return mStats;
+}
+
+uint32_t AutoplayController::getFinishedGameCount() const
+{
+	return mStats.gamesWon + mStats.gamesLost + mStats.gamesStalled;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+#include "ball.hpp"
+#include "collisionContext.hpp"
+#include "platform.hpp"
+#include "simulationState.hpp"
+
+struct AutoplayStats
+{
+	uint32_t gamesWon = 0;
+	uint32_t gamesLost = 0;
+	uint32_t gamesStalled = 0; // Restarted because the ball stopped scoring
+	uint64_t totalScore = 0;
+};
+
+// Built-in player for unattended benchmark and soak runs. It steers the platform with the same
+// MoveDirection a held arrow key gives and issues the same commands as SPACE and R, so everything
+// it does goes through the regular input path and is recorded like a human session.
+class AutoplayController final
+{
+public:
+	// Commands for this frame: serves, starts the next game once one ended, and restarts a game
+	// whose ball has not scored for kStallTicks
+	uint8_t chooseCommands(const SimulationState& state);
+
+	// Moves towards where the ball will cross the platform line, predicted by running the physics
+	// step forward through the current collision context
+	MoveDirection chooseDirection(const SimulationState& state, const CollisionContext& context, float deltaTime);
+
+	// Ball center x where it will next come down to the platform, if it gets there within the prediction budget
+	static std::optional<float> predictInterceptX(const Ball& ball, const CollisionContext& context, float interceptY);
+
+	const AutoplayStats& getStats() const;
+
+	uint32_t getFinishedGameCount() const;
+
+private:
+	static constexpr uint32_t kStallTicks = 60 * 60; // One minute of 60 Hz ticks without a score change
+	static constexpr uint32_t kMaxPredictionSteps = 32; // Bounces followed before giving up
+	static constexpr float kPredictionStepLength = 2000.f; // Longer than any straight path inside the view
+
+	AutoplayStats mStats;
+	uint32_t mLastScore = 0;
+	uint32_t mTicksWithoutScore = 0;
+};
@@ -8,9 +8,9 @@ class Ball final : public DynamicGameObject
 public:
 	Ball(const Vector2& position, float radius, float defaultSpeed);
 
-	void render(const Renderer& renderer) const override;
+	void render(const Renderer& renderer) const;
 
-	AABB getAABB() const override;
+	AABB getAABB() const;
 
 	float getRadius() const;
 
@@ -0,0 +1,355 @@
+#include "batchSimulation.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <format>
+#include <stdexcept>
+
+#include "ball.hpp"
+#include "block.hpp"
+#include "gameRules.hpp"
+#include "math.hpp"
+#include "physics.hpp"
+
+namespace
+{
+	constexpr float kPlatformY = GameConfig::kDefaultPlatformStartPosition.y;
+	constexpr float kPlatformHalfWidth = GameConfig::kPlatformSize.x * 0.5f;
+	constexpr float kPlatformHalfHeight = GameConfig::kPlatformSize.y * 0.5f;
+
+	bool overlaps(const AABB& a, const AABB& b)
+	{
+		return a.min.x <= b.max.x && a.max.x >= b.min.x && a.min.y <= b.max.y && a.max.y >= b.min.y;
+	}
+
+	LevelGenConfig makeLevelConfig(std::span<const float> typeWeights)
+	{
+		LevelGenConfig config;
+		if (typeWeights.size() != config.typeWeights.size())
+			throw std::invalid_argument(std::format("Expected {} block type weights, got {}", config.typeWeights.size(), typeWeights.size()));
+
+		config.grid = {
+			.columns = GameConfig::kBlockColumnCount,
+			.rows = GameConfig::kBlockRowCount,
+			.cellSize = GameConfig::kBlockSize,
+			.origin = GameConfig::kLevelOrigin
+		};
+		std::ranges::copy(typeWeights, config.typeWeights.begin());
+		return config;
+	}
+}
+
+BatchSimulation::BatchSimulation(size_t gameCount, uint64_t seed, std::span<const float> typeWeights)
+	: mGameCount(gameCount), mLevelGenerator(makeLevelConfig(typeWeights))
+{
+	// Cell i of the alive mask is grid cell (i % columns, i / columns)
+	const LevelGrid& grid = mLevelGenerator.getConfig().grid;
+	for (uint16_t row = 0; row < grid.rows; ++row)
+	{
+		for (uint16_t column = 0; column < grid.columns; ++column)
+		{
+			const Vector2 center = getCellCenter(grid, column, row);
+			AABB& cell = mCellAABBs[static_cast<size_t>(row) * grid.columns + column];
+			cell = { .min = center - 0.5f * grid.cellSize, .max = center + 0.5f * grid.cellSize };
+			mBlockRowsBottom = std::max(mBlockRowsBottom, cell.max.y);
+		}
+	}
+
+	mCollisionContext.walls = GameRules::getWalls();
+	mCollisionContext.blockAABBs.reserve(kMaxBlocks);
+	mCollisionContext.blockHandles.reserve(kMaxBlocks);
+
+	mBallX.resize(gameCount);
+	mBallY.resize(gameCount);
+	mBallDirectionX.resize(gameCount);
+	mBallDirectionY.resize(gameCount);
+	mBallSpeed.resize(gameCount);
+	mPlatformX.resize(gameCount, GameConfig::kDefaultPlatformStartPosition.x);
+	mAliveBlocks.resize(gameCount);
+	mHitPoints.resize(gameCount * kMaxBlocks);
+	mBlockTypes.resize(gameCount * kMaxBlocks);
+	mScore.resize(gameCount);
+	mMaxScore.resize(gameCount);
+	mLives.resize(gameCount);
+	mRewards.resize(gameCount);
+	mPlatformMoveX.resize(gameCount);
+	mDone.resize(gameCount);
+	mNarrowPhaseGames.reserve(gameCount);
+	mLevelBlocks.reserve(kMaxBlocks);
+
+	const CounterRng gameSeeds(seed);
+	mRngs.reserve(gameCount);
+	for (size_t game = 0; game < gameCount; ++game)
+	{
+		mRngs.emplace_back(gameSeeds.at(game));
+		resetGame(game);
+	}
+}
+
+void BatchSimulation::step(std::span<const MoveDirection> actions)
+{
+	if (actions.size() != mGameCount)
+		throw std::invalid_argument(std::format("Expected {} actions, got {}", mGameCount, actions.size()));
+
+	std::ranges::fill(mRewards, 0.f);
+	std::ranges::fill(mDone, uint8_t{ 0 });
+
+	// Platforms, clamped between the walls
+	const float platformMinX = GameConfig::kWallThickness + kPlatformHalfWidth;
+	const float platformMaxX = GameConfig::kViewSize - GameConfig::kWallThickness - kPlatformHalfWidth;
+	for (size_t game = 0; game < mGameCount; ++game)
+	{
+		const float direction = static_cast<float>(actions[game] == MoveDirection::Right) - static_cast<float>(actions[game] == MoveDirection::Left);
+		const float x = std::clamp(mPlatformX[game] + direction * GameConfig::kPlatformSpeed * kTickSeconds, platformMinX, platformMaxX);
+		mPlatformMoveX[game] = x - mPlatformX[game];
+		mPlatformX[game] = x;
+	}
+
+	// Broad phase: a ball whose swept circle stays clear of the walls, the block rows and the platform
+	// line cannot hit anything and simply moves. Written without branches so it vectorizes.
+	// The margin keeps freely moved balls off every surface; the exact test misses a sweep starting in contact.
+	const float margin = GameConfig::kBallRadius + kBroadPhaseMargin;
+	const float clearMinX = GameConfig::kWallThickness + margin;
+	const float clearMaxX = GameConfig::kViewSize - GameConfig::kWallThickness - margin;
+	const float clearMinY = std::max(GameConfig::kWallThickness, mBlockRowsBottom) + margin;
+	const float clearMaxY = kPlatformY - kPlatformHalfHeight - margin;
+	for (size_t game = 0; game < mGameCount; ++game)
+	{
+		const float distance = mBallSpeed[game] * kTickSeconds;
+		const float x = mBallX[game];
+		const float y = mBallY[game];
+		const float nextX = x + mBallDirectionX[game] * distance;
+		const float nextY = y + mBallDirectionY[game] * distance;
+		const bool near = std::min(x, nextX) < clearMinX || std::max(x, nextX) > clearMaxX ||
+			std::min(y, nextY) < clearMinY || std::max(y, nextY) > clearMaxY;
+
+		mBallX[game] = near ? x : nextX;
+		mBallY[game] = near ? y : nextY;
+		mDone[game] = near; // Reused as the narrow phase flag until the end of the step
+	}
+
+	mNarrowPhaseGames.clear();
+	for (size_t game = 0; game < mGameCount; ++game)
+	{
+		if (mDone[game])
+			mNarrowPhaseGames.push_back(static_cast<uint32_t>(game));
+	}
+	std::ranges::fill(mDone, uint8_t{ 0 });
+	mNarrowPhaseCount += mNarrowPhaseGames.size();
+
+	for (const uint32_t game : mNarrowPhaseGames)
+	{
+		const float direction = static_cast<float>(actions[game] == MoveDirection::Right) - static_cast<float>(actions[game] == MoveDirection::Left);
+		collideBall(game, direction * GameConfig::kPlatformSpeed);
+	}
+
+	for (size_t game = 0; game < mGameCount; ++game)
+		checkGameEnd(game);
+
+	mEnvironmentSteps += mGameCount;
+}
+
+void BatchSimulation::reset()
+{
+	std::ranges::fill(mRewards, 0.f);
+	std::ranges::fill(mDone, uint8_t{ 0 });
+	for (size_t game = 0; game < mGameCount; ++game)
+		resetGame(game);
+}
+
+size_t BatchSimulation::getGameCount() const
+{
+	return mGameCount;
+}
+
+uint64_t BatchSimulation::getEnvironmentSteps() const
+{
+	return mEnvironmentSteps;
+}
+
+std::span<const float> BatchSimulation::getBallX() const
+{
+	return mBallX;
+}
+
+std::span<const float> BatchSimulation::getBallY() const
+{
+	return mBallY;
+}
+
+std::span<const float> BatchSimulation::getBallDirectionX() const
+{
+	return mBallDirectionX;
+}
+
+std::span<const float> BatchSimulation::getBallDirectionY() const
+{
+	return mBallDirectionY;
+}
+
+std::span<const float> BatchSimulation::getBallSpeed() const
+{
+	return mBallSpeed;
+}
+
+std::span<const float> BatchSimulation::getPlatformX() const
+{
+	return mPlatformX;
+}
+
+std::span<const uint64_t> BatchSimulation::getAliveBlocks() const
+{
+	return mAliveBlocks;
+}
+
+std::span<const float> BatchSimulation::getRewards() const
+{
+	return mRewards;
+}
+
+std::span<const uint8_t> BatchSimulation::getDone() const
+{
+	return mDone;
+}
+
+uint64_t BatchSimulation::getFinishedGameCount() const
+{
+	return mFinishedGames;
+}
+
+uint64_t BatchSimulation::getWonGameCount() const
+{
+	return mWonGames;
+}
+
+uint64_t BatchSimulation::getNarrowPhaseCount() const
+{
+	return mNarrowPhaseCount;
+}
+
+void BatchSimulation::resetGame(size_t game)
+{
+	// One generator reseeded per level, so a game restarting inside step() allocates nothing
+	const LevelGrid& grid = mLevelGenerator.getConfig().grid;
+	mLevelGenerator.reseed(mRngs[game].next());
+	mLevelBlocks.clear();
+	mLevelGenerator.generateRows(0, grid.rows, mLevelBlocks);
+
+	uint64_t alive = 0;
+	uint32_t maxScore = 0;
+	uint8_t* hitPoints = &mHitPoints[game * kMaxBlocks];
+	uint8_t* types = &mBlockTypes[game * kMaxBlocks];
+	for (const LevelBlock& block : mLevelBlocks)
+	{
+		const size_t cell = static_cast<size_t>(block.row) * grid.columns + block.column;
+		alive |= uint64_t{ 1 } << cell;
+		hitPoints[cell] = block.hitPoints;
+		types[cell] = static_cast<uint8_t>(block.type);
+		maxScore += getBlockScore(block.type);
+	}
+
+	mAliveBlocks[game] = alive;
+	mScore[game] = 0;
+	mMaxScore[game] = maxScore;
+	mLives[game] = 3;
+	serve(game);
+}
+
+void BatchSimulation::serve(size_t game)
+{
+	// Same launch as Arkanoid::spawnBall, with the angle drawn from the game's own stream
+	const Vector2 position = GameRules::getServePosition({ mPlatformX[game], kPlatformY });
+	const Vector2 direction = GameRules::getServeDirection((mRngs[game].nextUniform() * 2.f - 1.f) * GameConfig::kServeSpreadDegrees);
+
+	mBallX[game] = position.x;
+	mBallY[game] = position.y;
+	mBallDirectionX[game] = direction.x;
+	mBallDirectionY[game] = direction.y;
+	mBallSpeed[game] = GameConfig::kDefaultBallSpeed;
+}
+
+void BatchSimulation::collideBall(size_t game, float platformVelocity)
+{
+	const Vector2 position{ mBallX[game], mBallY[game] };
+
+	// The game's platform at the end of the tick and its live blocks, front rows first as in Arkanoid::updateCollisionContext.
+	// Whatever it bounces off, the ball cannot reach a block further away than its move plus the platform's carry,
+	// so only those go into the context.
+	CollisionContext& context = mCollisionContext;
+	context.platform = AABB{
+		.min = { mPlatformX[game] - kPlatformHalfWidth, kPlatformY - kPlatformHalfHeight },
+		.max = { mPlatformX[game] + kPlatformHalfWidth, kPlatformY + kPlatformHalfHeight }
+	};
+	context.platformDirection = { platformVelocity, 0.f };
+	context.platformDisplacement = { mPlatformMoveX[game], 0.f };
+	context.blockAABBs.clear();
+	context.blockHandles.clear();
+	const float reach = mBallSpeed[game] * kTickSeconds + std::abs(mPlatformMoveX[game]) + GameConfig::kBallRadius + kBroadPhaseMargin;
+	const AABB reachBounds{ .min = position - Vector2{ reach }, .max = position + Vector2{ reach } };
+	for (uint64_t cells = mAliveBlocks[game]; cells != 0;)
+	{
+		const auto cell = static_cast<uint32_t>(63 - std::countl_zero(cells));
+		cells &= ~(uint64_t{ 1 } << cell);
+		if (overlaps(mCellAABBs[cell], reachBounds))
+		{
+			context.blockAABBs.push_back(mCellAABBs[cell]);
+			context.blockHandles.push_back({ 0, cell });
+		}
+	}
+
+	Ball ball(position, GameConfig::kBallRadius, GameConfig::kDefaultBallSpeed);
+	ball.setDirection({ mBallDirectionX[game], mBallDirectionY[game] });
+	ball.setSpeed(mBallSpeed[game]);
+
+	// Same continuous collision loop, response and iteration budget as HeadlessGame::moveBall
+	Physics::moveBall(ball, ball.getSpeed() * kTickSeconds, context, kMaxCollisionIterations, [&](const PhysicsHitResult& hit)
+	{
+		if (hit.hitPlatform)
+			ball.resetSpeedAndColor();
+		else if (hit.hitBlock)
+		{
+			const uint32_t cell = context.blockHandles[*hit.hitBlock].index;
+			const size_t slot = game * kMaxBlocks + cell;
+			const auto type = static_cast<BlockType>(mBlockTypes[slot]);
+			if (--mHitPoints[slot] == 0)
+			{
+				mAliveBlocks[game] &= ~(uint64_t{ 1 } << cell);
+				context.removeBlock(*hit.hitBlock);
+				const uint32_t score = getBlockScore(type);
+				mScore[game] += score;
+				mRewards[game] += static_cast<float>(score);
+			}
+			if (type == BlockType::Booster)
+				ball.setSpeed(ball.getSpeed() + GameConfig::kBallSpeedIncrement);
+		}
+	});
+
+	mBallX[game] = ball.getPosition().x;
+	mBallY[game] = ball.getPosition().y;
+	mBallDirectionX[game] = ball.getDirection().x;
+	mBallDirectionY[game] = ball.getDirection().y;
+	mBallSpeed[game] = ball.getSpeed();
+}
+
+void BatchSimulation::checkGameEnd(size_t game)
+{
+	if (mScore[game] == mMaxScore[game])
+	{
+		mWonGames++;
+	}
+	else if (GameRules::isBallLost({ mBallX[game], mBallY[game] }))
+	{
+		if (--mLives[game] > 0)
+		{
+			serve(game);
+			return;
+		}
+	}
+	else
+		return;
+
+	mFinishedGames++;
+	mDone[game] = 1;
+	resetGame(game);
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "collisionContext.hpp"
+#include "counterRng.hpp"
+#include "gameConfig.hpp"
+#include "levelGenerator.hpp"
+#include "math.hpp"
+#include "platform.hpp"
+
+// Many independent games of Arkanoid's rules stepped in lockstep, as a training environment.
+// Games are stored as structure-of-arrays indexed by game, and a block field is a 64-bit alive mask
+// over the shared level grid plus per-cell hit points. Each step first moves every ball in a
+// branch-free loop over the game index, then runs the game's own Physics::moveBall only for the
+// few games whose swept ball comes near a wall, the platform or the block rows.
+// Serving is automatic, so every game always has a ball in play, and a finished game restarts on a
+// new level in the same step.
+class BatchSimulation final
+{
+public:
+	static constexpr float kTickSeconds = 1.f / 60.f;
+	static constexpr size_t kMaxBlocks = 64;
+
+	static_assert(GameConfig::kBlockColumnCount * GameConfig::kBlockRowCount <= kMaxBlocks,
+		"The level grid must fit the 64-bit alive mask");
+
+	// Games use levels generated with typeWeights; every game has its own random stream derived from seed
+	BatchSimulation(size_t gameCount, uint64_t seed, std::span<const float> typeWeights = GameConfig::kBlockTypeWeights);
+
+	// Advances every game by one tick, game i moving its platform in actions[i]
+	void step(std::span<const MoveDirection> actions);
+
+	// Restarts every game on a new level
+	void reset();
+
+	size_t getGameCount() const;
+
+	// Game ticks simulated so far, summed over all games
+	uint64_t getEnvironmentSteps() const;
+
+	// Observations, one entry per game. The arrays never move for the lifetime of the simulation.
+	std::span<const float> getBallX() const;
+	std::span<const float> getBallY() const;
+	std::span<const float> getBallDirectionX() const;
+	std::span<const float> getBallDirectionY() const;
+	std::span<const float> getBallSpeed() const;
+	std::span<const float> getPlatformX() const;
+	std::span<const uint64_t> getAliveBlocks() const;
+
+	// Score gained in the last step
+	std::span<const float> getRewards() const;
+
+	// 1 where the game ended in the last step; those games already restarted
+	std::span<const uint8_t> getDone() const;
+
+	uint64_t getFinishedGameCount() const;
+
+	uint64_t getWonGameCount() const;
+
+	// Ball moves that needed the exact collision test, summed over all games
+	uint64_t getNarrowPhaseCount() const;
+
+private:
+	void resetGame(size_t game);
+
+	void serve(size_t game);
+
+	// Exact continuous collision of one ball against walls, platform and live blocks
+	void collideBall(size_t game, float platformVelocity);
+
+	void checkGameEnd(size_t game);
+
+	static constexpr uint32_t kMaxCollisionIterations = GameConfig::kCcdIterationBudget;
+	static constexpr float kBroadPhaseMargin = 1.f;
+
+	size_t mGameCount = 0;
+	LevelGenerator mLevelGenerator;
+	std::array<AABB, kMaxBlocks> mCellAABBs{};
+	float mBlockRowsBottom = 0.f; // Lowest edge of the grid
+
+	// Per game
+	std::vector<float> mBallX;
+	std::vector<float> mBallY;
+	std::vector<float> mBallDirectionX;
+	std::vector<float> mBallDirectionY;
+	std::vector<float> mBallSpeed;
+	std::vector<float> mPlatformX;
+	std::vector<uint64_t> mAliveBlocks;
+	std::vector<uint8_t> mHitPoints;  // kMaxBlocks per game
+	std::vector<uint8_t> mBlockTypes; // kMaxBlocks per game
+	std::vector<uint32_t> mScore;
+	std::vector<uint32_t> mMaxScore;
+	std::vector<uint8_t> mLives;
+	std::vector<CounterRng> mRngs;
+	std::vector<float> mRewards;
+	std::vector<uint8_t> mDone;
+
+	// Scratch
+	std::vector<float> mPlatformMoveX; // Platform movement of the current step
+	std::vector<uint32_t> mNarrowPhaseGames;
+	std::vector<LevelBlock> mLevelBlocks;
+	CollisionContext mCollisionContext; // Walls, plus the platform and live blocks of the game in collideBall
+
+	uint64_t mEnvironmentSteps = 0;
+	uint64_t mFinishedGames = 0;
+	uint64_t mWonGames = 0;
+	uint64_t mNarrowPhaseCount = 0;
+};
@@ -1,82 +1,114 @@
 #include "block.hpp"
-#include "color.hpp"
 
-Block::Block(const Vector2& position, const Vector2& size, BlockType type)
-	: GameObject(position, getColorForType(type)), mSize(size), mType(type)
+#include <algorithm>
+#include <stdexcept>
+
+SDL_Color getBlockColor(BlockType type)
 {
-	if (type == BlockType::Reinforced)
+	switch (type)
 	{
-		mLifeCount = 3;
+		case BlockType::Normal: return Color::Cyan;
+		case BlockType::Booster: return Color::Magenta;
+		case BlockType::Reinforced: return Color::Blue;
+		default: return Color::White; // Fallback color
 	}
 }
 
-void Block::render(const Renderer& renderer) const
+uint32_t getBlockScore(BlockType type)
 {
-	if (mIsDestroyed)
-		return;
-
-	SDL_Color renderColor = mColor;
-
-	if (mType == BlockType::Reinforced)
+	switch (type)
 	{
-		// Assuming max life count is 3
-		const float brightness = 0.4f + 0.2f * static_cast<float>(mLifeCount);
-		renderColor.r = static_cast<Uint8>(renderColor.r * brightness);
-		renderColor.g = static_cast<Uint8>(renderColor.g * brightness);
-		renderColor.b = static_cast<Uint8>(renderColor.b * brightness);
+		case BlockType::Normal: return 1;
+		case BlockType::Booster: return 2;
+		case BlockType::Reinforced: return 3;
+		default: return 0; // Fallback
 	}
+}
 
-	renderer.drawFilledRectangle(mPosition, mSize, renderColor);
-	renderer.drawRectangle(mPosition, mSize, Color::Black);
+void BlockArrays::reset(std::span<uint8_t> hitPointStorage)
+{
+	clear();
+	mHitPoints = hitPointStorage;
+	mAABBs.reserve(hitPointStorage.size());
+	mTypes.reserve(hitPointStorage.size());
 }
 
-const Vector2& Block::getSize() const
+void BlockArrays::clear()
 {
-	return mSize;
+	mAABBs.clear();
+	mTypes.clear();
 }
 
-AABB Block::getAABB() const
+size_t BlockArrays::size() const
 {
-	return { mPosition - 0.5f * mSize, mPosition + 0.5f * mSize };
+	return mTypes.size();
 }
 
-BlockType Block::getType() const
+void BlockArrays::add(const Vector2& position, const Vector2& size, BlockType type, uint8_t hitPoints)
 {
-	return mType;
+	const size_t index = mTypes.size();
+	if (index == mHitPoints.size())
+		throw std::runtime_error("Block storage is full");
+
+	mHitPoints[index] = hitPoints;
+	mAABBs.push_back({ position - 0.5f * size, position + 0.5f * size });
+	mTypes.push_back(type);
 }
 
-bool Block::isDestroyed() const
+bool BlockArrays::hit(size_t index)
 {
-	return mIsDestroyed;
+	if (mHitPoints[index] == 0)
+		return false;
+
+	mHitPoints[index]--;
+	return mHitPoints[index] == 0;
 }
 
-void Block::tryDestroy()
+bool BlockArrays::isDestroyed(size_t index) const
 {
-	mLifeCount--;
-	if (mLifeCount == 0)
-	{
-		mIsDestroyed = true;
-	}
+	return mHitPoints[index] == 0;
+}
+
+BlockType BlockArrays::getType(size_t index) const
+{
+	return mTypes[index];
 }
 
-uint32_t Block::getScore() const
+void BlockArrays::render(const Renderer& renderer) const
 {
-	switch (mType)
+	for (size_t i = 0; i < mAABBs.size(); ++i)
 	{
-		case BlockType::Normal: return 1;
-		case BlockType::Booster: return 2;
-		case BlockType::Reinforced: return 3;
-		default: return 0; // Fallback
+		if (mHitPoints[i] == 0)
+			continue;
+
+		renderer.queueFilledRectangle(mAABBs[i], getShadedColor(mTypes[i], mHitPoints[i]));
+		renderer.queueRectangle(mAABBs[i], Color::Black);
 	}
+	renderer.flushQueue();
 }
 
-SDL_Color Block::getColorForType(BlockType type)
+std::span<const AABB> BlockArrays::getAABBs() const
 {
-	switch (type)
+	return mAABBs;
+}
+
+std::span<const uint8_t> BlockArrays::getHitPoints() const
+{
+	return mHitPoints.first(size());
+}
+
+SDL_Color BlockArrays::getShadedColor(BlockType type, uint8_t hitPoints)
+{
+	SDL_Color color = getBlockColor(type);
+
+	if (type == BlockType::Reinforced)
 	{
-		case BlockType::Normal: return Color::Cyan;
-		case BlockType::Booster: return Color::Magenta;
-		case BlockType::Reinforced: return Color::Blue;
-		default: return Color::White; // Fallback color
+		// Brightness saturates at the default life count of 3
+		const float brightness = 0.4f + 0.2f * static_cast<float>(std::min<uint8_t>(hitPoints, 3));
+		color.r = static_cast<Uint8>(color.r * brightness);
+		color.g = static_cast<Uint8>(color.g * brightness);
+		color.b = static_cast<Uint8>(color.b * brightness);
 	}
+
+	return color;
 }
@@ -1,39 +1,51 @@
 #pragma once
+#include <span>
+#include <vector>
+
+#include "blockType.hpp"
 #include "color.hpp"
-#include "gameObject.hpp"
+#include "math.hpp"
+#include "renderer.hpp"
 
-enum class BlockType
-{
-	Normal,
-	Booster,
-	Reinforced,
-};
+SDL_Color getBlockColor(BlockType type);
+
+uint32_t getBlockScore(BlockType type);
 
-class Block final : public GameObject
+// Dense component arrays for blocks. A block is an index into every array.
+// Destroyed blocks keep their slot with zero hit points, so indices stay stable for a level.
+// Hit points, the only data that changes during play, live in storage owned by the caller
+// (the playfield keeps all chunks in one buffer so a snapshot copies them in one go).
+class BlockArrays final
 {
 public:
-	Block(const Vector2& position, const Vector2& size, BlockType type);
+	// Removes all blocks and binds the hit point storage, which also bounds the block count
+	void reset(std::span<uint8_t> hitPointStorage);
 
-	void render(const Renderer& renderer) const override;
+	// Removes all blocks, keeping the storage
+	void clear();
 
-	const Vector2& getSize() const;
+	size_t size() const;
 
-	AABB getAABB() const override;
+	void add(const Vector2& position, const Vector2& size, BlockType type, uint8_t hitPoints);
 
-	BlockType getType() const;
+	// Removes one hit point. Returns true when this destroyed the block.
+	bool hit(size_t index);
 
-	bool isDestroyed() const;
+	bool isDestroyed(size_t index) const;
 
-	void tryDestroy();
+	BlockType getType(size_t index) const;
 
-	uint32_t getScore() const;
+	// Draws all live blocks as one batch
+	void render(const Renderer& renderer) const;
 
-private:
+	std::span<const AABB> getAABBs() const;
+
+	std::span<const uint8_t> getHitPoints() const;
 
-	static SDL_Color getColorForType(BlockType type);
+private:
+	static SDL_Color getShadedColor(BlockType type, uint8_t hitPoints);
 
-	Vector2 mSize;
-	BlockType mType = BlockType::Normal;
-	uint8_t mLifeCount = 1;
-	bool mIsDestroyed = false;
-};
\ No newline at end of file
+	std::vector<AABB> mAABBs;
+	std::vector<BlockType> mTypes;
+	std::span<uint8_t> mHitPoints; // Storage for every block that fits; the first size() entries are used
+};
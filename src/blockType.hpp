@@ -0,0 +1,15 @@
+#pragma once
+#include <cstdint>
+
+enum class BlockType : uint8_t
+{
+	Normal,
+	Booster,
+	Reinforced,
+	Count
+};
+
+constexpr uint8_t getDefaultHitPoints(BlockType type)
+{
+	return type == BlockType::Reinforced ? 3 : 1;
+}
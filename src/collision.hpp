@@ -159,81 +159,3 @@ inline bool intersectSegmentCapsule(const Segment& seg, const Capsule& cap, floa
 	}
 	return false;
 }
-
-// Source: Real-Time Collision Detection by Christer Ericson
-inline std::optional<HitInfo> intersectMovingSphereAABB(const Sphere& s, const Vector2& d, const AABB& b)
-{
-	AABB e = b;
-	e.min.x -= s.radius;
-	e.min.y -= s.radius;
-	e.max.x += s.radius;
-	e.max.y += s.radius;
-
-	Vector2 p;
-	float t;
-	if (!intersectRayAABB(s.center, d, e, t, p) || t > 1.f)
-		return std::nullopt;
-
-	int u = 0, v = 0;
-	if (p.x < b.min.x) u |= 1;
-	if (p.x > b.max.x) v |= 1;
-	if (p.y < b.min.y) u |= 2;
-	if (p.y > b.max.y) v |= 2;
-
-	int m = u + v;
-	Segment seg{ s.center, s.center + d };
-
-	if (m == 3) // Vertex region
-	{
-		float tMin = FLT_MAX;
-		Vector2 bestNormal;
-		Vector2 bestPoint;
-
-		Capsule edge1{ b.corner(v), b.corner(v ^ 1), s.radius };
-		Capsule edge2{ b.corner(v), b.corner(v ^ 2), s.radius };
-
-		float tempT;
-		Vector2 p1, n1, p2, n2;
-
-		if (intersectSegmentCapsule(seg, edge1, tempT, p1, n1) && tempT < tMin)
-		{
-			tMin = tempT;
-			bestPoint = p1;
-			bestNormal = n1;
-		}
-		if (intersectSegmentCapsule(seg, edge2, tempT, p2, n2) && tempT < tMin)
-		{
-			tMin = tempT;
-			bestPoint = p2;
-			bestNormal = n2;
-		}
-
-		if (tMin == FLT_MAX)
-			return std::nullopt;
-
-		t = tMin;
-
-		return std::make_optional<HitInfo>(bestPoint, bestNormal, t);
-	}
-
-	if ((m & (m - 1)) == 0) // Face region
-	{
-		// Intersection point on expanded AABB is valid
-		Vector2 normal;
-		switch (m)
-		{
-			case 1: normal = Vector2{ -1, 0 }; break; // Left
-			case 2: normal = Vector2{ 0, -1 }; break; // Bottom
-			case 4: normal = Vector2{ 1, 0 }; break;  // Right
-			case 8: normal = Vector2{ 0, 1 }; break;  // Top
-		}
-		return std::make_optional<HitInfo>(p, normal, t);
-	}
-
-	Vector2 pt, n;
-	if (intersectSegmentCapsule(seg, Capsule{ b.corner(u ^ 3), b.corner(v), s.radius }, t, pt, n))
-	{
-		return std::make_optional<HitInfo>(pt, n, t);
-	}
-	return std::nullopt;
-}
\ No newline at end of file
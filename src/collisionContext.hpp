@@ -1,15 +1,37 @@
-﻿#pragma once
+#pragma once
 
 #include <vector>
 #include <array>
+#include <optional>
 
-#include "wall.hpp"
-#include "platform.hpp"
-#include "block.hpp"
+#include "distanceField.hpp"
+#include "math.hpp"
+#include "playfield.hpp"
 
+// Flattened copy of everything the ball can collide with, rebuilt every frame so the
+// physics step scans dense AABB arrays instead of chasing object pointers
 struct CollisionContext
 {
-	std::array<const Wall*, 3> walls; // left, top, right
-	const Platform* platform;
-	std::vector<Block*> blocks;
-};
\ No newline at end of file
+	std::array<AABB, 3> walls; // left, top, right
+	std::optional<AABB> platform; // At the end of the tick
+	Vector2 platformDirection;
+	Vector2 platformDisplacement; // Movement over the tick; the platform started it at platform - platformDisplacement
+
+	// Live blocks, front rows first
+	std::vector<AABB> blockAABBs;
+	std::vector<BlockHandle> blockHandles;
+
+	// Optional distance field over the walls and blocks. Moves it shows to be clear skip sweeping them;
+	// owned by whoever builds the context.
+	DistanceField* distanceField = nullptr;
+
+	void removeBlock(size_t index)
+	{
+		const AABB removed = blockAABBs[index];
+		blockAABBs.erase(blockAABBs.begin() + static_cast<std::ptrdiff_t>(index));
+		blockHandles.erase(blockHandles.begin() + static_cast<std::ptrdiff_t>(index));
+
+		if (distanceField)
+			distanceField->removeBox(removed, walls, blockAABBs);
+	}
+};
@@ -0,0 +1,68 @@
+#pragma once
+#include <cstdint>
+
+// Counter-based random number generator ("Squares", B. Widynski 2020).
+// Every output is a pure function of (key, counter), so any element of the stream can be produced
+// independently and in parallel, and the whole generator state is two integers.
+class CounterRng final
+{
+public:
+	constexpr CounterRng() : CounterRng(0) {}
+
+	constexpr explicit CounterRng(uint64_t seed) : mKey(makeKey(seed)) {}
+
+	// Random 64-bit value at a position of the stream
+	constexpr uint64_t at(uint64_t counter) const
+	{
+		uint64_t x = counter * mKey;
+		const uint64_t y = x;
+		const uint64_t z = y + mKey;
+
+		x = x * x + y; x = (x >> 32) | (x << 32);
+		x = x * x + z; x = (x >> 32) | (x << 32);
+		x = x * x + y; x = (x >> 32) | (x << 32);
+		const uint64_t high = x * x + z;
+		x = (high >> 32) | (high << 32);
+		return high ^ ((x * x + y) >> 32);
+	}
+
+	// Uniform float in [0, 1) at a position of the stream
+	constexpr float uniformAt(uint64_t counter) const
+	{
+		return static_cast<float>(at(counter) >> 40) * 0x1.0p-24f;
+	}
+
+	uint64_t next()
+	{
+		return at(mCounter++);
+	}
+
+	float nextUniform()
+	{
+		return uniformAt(mCounter++);
+	}
+
+	uint64_t getCounter() const
+	{
+		return mCounter;
+	}
+
+	void setCounter(uint64_t counter)
+	{
+		mCounter = counter;
+	}
+
+private:
+	// Squares needs a key with well-mixed nibbles; derive one from the seed with SplitMix64
+	static constexpr uint64_t makeKey(uint64_t seed)
+	{
+		uint64_t z = seed + 0x9E3779B97F4A7C15ull;
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		z ^= z >> 31;
+		return z | 1;
+	}
+
+	uint64_t mKey;
+	uint64_t mCounter = 0;
+};
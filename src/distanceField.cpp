@@ -0,0 +1,116 @@
+#include "distanceField.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	// The field is sampled at cell centers; any point of a cell is at most this far from its center
+	constexpr float kCellHalfDiagonal = DistanceField::kCellSize * 0.70710678f;
+
+	float distanceToBox(const Vector2& point, const AABB& box)
+	{
+		const float dx = std::max({ box.min.x - point.x, 0.f, point.x - box.max.x });
+		const float dy = std::max({ box.min.y - point.y, 0.f, point.y - box.max.y });
+		return std::sqrt(dx * dx + dy * dy);
+	}
+
+	AABB expand(const AABB& box, float margin)
+	{
+		return { box.min - Vector2{ margin, margin }, box.max + Vector2{ margin, margin } };
+	}
+
+	bool overlaps(const AABB& a, const AABB& b)
+	{
+		return a.min.x <= b.max.x && a.max.x >= b.min.x && a.min.y <= b.max.y && a.max.y >= b.min.y;
+	}
+}
+
+DistanceField::DistanceField(const AABB& bounds)
+	: mBounds(bounds)
+	, mColumns(static_cast<uint32_t>(std::ceil((bounds.max.x - bounds.min.x) / kCellSize)))
+	, mRows(static_cast<uint32_t>(std::ceil((bounds.max.y - bounds.min.y) / kCellSize)))
+	, mDistances(static_cast<size_t>(mColumns) * mRows, kMaxDistance)
+{
+}
+
+void DistanceField::build(std::span<const AABB> walls, std::span<const AABB> blocks)
+{
+	std::ranges::fill(mDistances, kMaxDistance);
+	for (const AABB& wall : walls)
+		stamp(wall, getCells(expand(wall, kMaxDistance)));
+	for (const AABB& block : blocks)
+		stamp(block, getCells(expand(block, kMaxDistance)));
+}
+
+void DistanceField::removeBox(const AABB& removed, std::span<const AABB> walls, std::span<const AABB> blocks)
+{
+	const AABB area = expand(removed, kMaxDistance);
+	const CellRange cells = getCells(area);
+	for (uint32_t row = cells.firstRow; row < cells.lastRow; ++row)
+		std::fill_n(mDistances.begin() + row * mColumns + cells.firstColumn, cells.lastColumn - cells.firstColumn, kMaxDistance);
+
+	// Everything that reaches into the cleared cells draws itself again, restricted to them
+	auto restamp = [&](const AABB& box)
+	{
+		if (overlaps(expand(box, kMaxDistance), area))
+			stamp(box, cells);
+	};
+	std::ranges::for_each(walls, restamp);
+	std::ranges::for_each(blocks, restamp);
+}
+
+float DistanceField::getClearance(const Vector2& point) const
+{
+	const float x = (point.x - mBounds.min.x) / kCellSize;
+	const float y = (point.y - mBounds.min.y) / kCellSize;
+	if (!(x >= 0.f && y >= 0.f && x < static_cast<float>(mColumns) && y < static_cast<float>(mRows)))
+		return 0.f;
+
+	const float distance = mDistances[static_cast<size_t>(y) * mColumns + static_cast<size_t>(x)];
+	return std::max(distance - kCellHalfDiagonal, 0.f);
+}
+
+uint32_t DistanceField::getColumnCount() const
+{
+	return mColumns;
+}
+
+uint32_t DistanceField::getRowCount() const
+{
+	return mRows;
+}
+
+DistanceField::CellRange DistanceField::getCells(const AABB& area) const
+{
+	// Cell i has its center at min + (i + 0.5) * kCellSize
+	auto first = [](float from, uint32_t count)
+	{
+		return static_cast<uint32_t>(std::clamp(std::ceil(from / kCellSize - 0.5f), 0.f, static_cast<float>(count)));
+	};
+	auto last = [](float to, uint32_t count)
+	{
+		return static_cast<uint32_t>(std::clamp(std::floor(to / kCellSize - 0.5f) + 1.f, 0.f, static_cast<float>(count)));
+	};
+
+	CellRange cells;
+	cells.firstColumn = first(area.min.x - mBounds.min.x, mColumns);
+	cells.lastColumn = std::max(cells.firstColumn, last(area.max.x - mBounds.min.x, mColumns));
+	cells.firstRow = first(area.min.y - mBounds.min.y, mRows);
+	cells.lastRow = std::max(cells.firstRow, last(area.max.y - mBounds.min.y, mRows));
+	return cells;
+}
+
+void DistanceField::stamp(const AABB& box, const CellRange& cells)
+{
+	for (uint32_t row = cells.firstRow; row < cells.lastRow; ++row)
+	{
+		const float y = mBounds.min.y + (static_cast<float>(row) + 0.5f) * kCellSize;
+		float* distances = mDistances.data() + static_cast<size_t>(row) * mColumns;
+		for (uint32_t column = cells.firstColumn; column < cells.lastColumn; ++column)
+		{
+			const Vector2 center{ mBounds.min.x + (static_cast<float>(column) + 0.5f) * kCellSize, y };
+			distances[column] = std::min(distances[column], distanceToBox(center, box));
+		}
+	}
+}
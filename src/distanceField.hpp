@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "math.hpp"
+
+// Low-resolution distance field over static boxes (walls and blocks), sampled at cell centers and
+// capped at kMaxDistance. Each box only touches the cells within kMaxDistance of it, so the field is
+// built once per level and patched locally when a block goes away.
+class DistanceField final
+{
+public:
+	static constexpr float kCellSize = 8.f;
+	static constexpr float kMaxDistance = 64.f;
+
+	// Covers bounds; boxes outside it are ignored and points outside it have no clearance
+	explicit DistanceField(const AABB& bounds);
+
+	void build(std::span<const AABB> walls, std::span<const AABB> blocks);
+
+	// Recomputes the cells around a box that was removed; walls and blocks no longer contain it
+	void removeBox(const AABB& removed, std::span<const AABB> walls, std::span<const AABB> blocks);
+
+	// Lower bound of the distance from point to the nearest box, between 0 and about kMaxDistance
+	float getClearance(const Vector2& point) const;
+
+	uint32_t getColumnCount() const;
+
+	uint32_t getRowCount() const;
+
+private:
+	struct CellRange
+	{
+		uint32_t firstColumn = 0;
+		uint32_t lastColumn = 0; // Exclusive
+		uint32_t firstRow = 0;
+		uint32_t lastRow = 0;    // Exclusive
+	};
+
+	// Cells whose centers lie inside area
+	CellRange getCells(const AABB& area) const;
+
+	void stamp(const AABB& box, const CellRange& cells);
+
+	AABB mBounds;
+	uint32_t mColumns = 0;
+	uint32_t mRows = 0;
+	std::vector<float> mDistances; // Row-major
+};
@@ -8,8 +8,6 @@ public:
 
 	DynamicGameObject(const Vector2& position, const SDL_Color& color);
 
-	~DynamicGameObject() override = default;
-
 	const Vector2& getDirection() const;
 
 	float getSpeed() const;
@@ -0,0 +1,263 @@
+#include "flightRecorder.hpp"
+
+#include <algorithm>
+#include <csignal>
+#include <cstring>
+
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	std::atomic<const FlightRecorder*> sCrashRecorder{ nullptr };
+
+#if defined(SIGBUS)
+	constexpr std::array kCrashSignals = { SIGSEGV, SIGABRT, SIGFPE, SIGILL, SIGBUS };
+#else
+	constexpr std::array kCrashSignals = { SIGSEGV, SIGABRT, SIGFPE, SIGILL };
+#endif
+
+	using SignalHandler = void (*)(int);
+	std::array<SignalHandler, kCrashSignals.size()> sPreviousHandlers{};
+
+#if defined(_WIN32)
+	int openDumpFile(const char* path)
+	{
+		return _open(path, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+	}
+
+	bool writeAll(int fd, const char* data, size_t size)
+	{
+		return _write(fd, data, static_cast<unsigned int>(size)) == static_cast<int>(size);
+	}
+
+	void closeDumpFile(int fd)
+	{
+		_close(fd);
+	}
+#else
+	int openDumpFile(const char* path)
+	{
+		return open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	}
+
+	bool writeAll(int fd, const char* data, size_t size)
+	{
+		while (size > 0)
+		{
+			const ssize_t written = write(fd, data, size);
+			if (written < 0)
+				return false;
+
+			data += written;
+			size -= static_cast<size_t>(written);
+		}
+		return true;
+	}
+
+	void closeDumpFile(int fd)
+	{
+		close(fd);
+	}
+#endif
+
+	// Formats into a fixed buffer and writes it out whenever it fills up. No allocation, locale or stdio,
+	// so it can run inside a signal handler.
+	class DumpWriter final
+	{
+	public:
+		explicit DumpWriter(int fd) : mFd(fd) {}
+
+		void text(const char* value)
+		{
+			while (*value)
+				character(*value++);
+		}
+
+		void character(char value)
+		{
+			if (mSize == mBuffer.size())
+				flush();
+			mBuffer[mSize++] = value;
+		}
+
+		void unsignedValue(uint64_t value)
+		{
+			char digits[20];
+			size_t count = 0;
+			do
+			{
+				digits[count++] = static_cast<char>('0' + value % 10);
+				value /= 10;
+			} while (value > 0);
+
+			while (count > 0)
+				character(digits[--count]);
+		}
+
+		void hexValue(uint32_t value)
+		{
+			text("0x");
+			for (int shift = 28; shift >= 0; shift -= 4)
+				character("0123456789abcdef"[(value >> shift) & 0xF]);
+		}
+
+		// Three decimals; negative and non-finite values are written as 0
+		void milliseconds(float value)
+		{
+			const auto microseconds = value >= 0.f && value < 1e12f ? static_cast<uint64_t>(value * 1000.f + 0.5f) : 0;
+			unsignedValue(microseconds / 1000);
+			character('.');
+			const auto fraction = microseconds % 1000;
+			character(static_cast<char>('0' + fraction / 100));
+			character(static_cast<char>('0' + fraction / 10 % 10));
+			character(static_cast<char>('0' + fraction % 10));
+		}
+
+		bool flush()
+		{
+			mFailed |= !writeAll(mFd, mBuffer.data(), mSize);
+			mSize = 0;
+			return !mFailed;
+		}
+
+	private:
+		int mFd;
+		std::array<char, 4096> mBuffer;
+		size_t mSize = 0;
+		bool mFailed = false;
+	};
+
+	const char* getGameStateName(GameState state)
+	{
+		switch (state)
+		{
+			case GameState::NotStarted: return "NotStarted";
+			case GameState::Running: return "Running";
+			case GameState::Paused: return "Paused";
+			case GameState::AwaitingServe: return "AwaitingServe";
+			case GameState::GameOver: return "GameOver";
+			case GameState::Won: return "Won";
+		}
+		return "Unknown";
+	}
+}
+
+FlightRecorder::FlightRecorder(size_t capacity, std::string crashDumpPath)
+	: mRecords(std::max<size_t>(capacity, 1)), mCrashDumpPath(std::move(crashDumpPath))
+{
+}
+
+FlightRecorder::~FlightRecorder()
+{
+	if (!mOwnsCrashHandler)
+		return;
+
+	for (size_t i = 0; i < kCrashSignals.size(); ++i)
+		std::signal(kCrashSignals[i], sPreviousHandlers[i]);
+	sCrashRecorder = nullptr;
+}
+
+void FlightRecorder::record(const FlightRecord& record)
+{
+	// Single writer; the count is published after the slot, so a dump sees at most the slot being overwritten torn
+	const uint64_t count = mRecordCount.load(std::memory_order_relaxed);
+	mRecords[count % mRecords.size()] = record;
+	mRecordCount.store(count + 1, std::memory_order_release);
+}
+
+bool FlightRecorder::dump(const char* path, const char* reason) const
+{
+	const int fd = openDumpFile(path);
+	if (fd < 0)
+		return false;
+
+	const uint64_t count = mRecordCount.load(std::memory_order_acquire);
+	const uint64_t stored = std::min<uint64_t>(count, mRecords.size());
+
+	DumpWriter writer(fd);
+	writer.text("# Arkanoid flight recorder, reason: ");
+	writer.text(reason);
+	writer.text(", ticks: ");
+	writer.unsignedValue(stored);
+	writer.text("\nframe,delta_us,state,commands,checksum,frame_ms,update_ms,render_ms,key_events\n");
+
+	for (uint64_t i = count - stored; i < count; ++i)
+	{
+		const FlightRecord& record = mRecords[i % mRecords.size()];
+		writer.unsignedValue(record.frameIndex);
+		writer.character(',');
+		writer.unsignedValue(record.frameDeltaNs / 1000);
+		writer.character(',');
+		writer.text(getGameStateName(record.gameState));
+		writer.character(',');
+		writer.unsignedValue(record.commands);
+		writer.character(',');
+		writer.hexValue(record.stateChecksum);
+		writer.character(',');
+		writer.milliseconds(record.frameMs);
+		writer.character(',');
+		writer.milliseconds(record.updateMs);
+		writer.character(',');
+		writer.milliseconds(record.renderMs);
+		writer.character(',');
+
+		// Key transitions as <L|R><+|->@<offset us>, separated by spaces
+		const size_t keptEvents = std::min<size_t>(record.keyEventCount, FlightRecord::kMaxKeyEvents);
+		for (size_t k = 0; k < keptEvents; ++k)
+		{
+			const FlightKeyEvent& event = record.keyEvents[k];
+			if (k > 0)
+				writer.character(' ');
+			writer.character(event.right ? 'R' : 'L');
+			writer.character(event.down ? '+' : '-');
+			writer.character('@');
+			writer.unsignedValue(event.offsetNs / 1000);
+		}
+		if (record.keyEventCount > keptEvents)
+			writer.text(" ...");
+		writer.character('\n');
+	}
+
+	const bool written = writer.flush();
+	closeDumpFile(fd);
+	return written;
+}
+
+void FlightRecorder::installCrashHandler()
+{
+	const FlightRecorder* expected = nullptr;
+	if (!sCrashRecorder.compare_exchange_strong(expected, this))
+		return;
+
+	for (size_t i = 0; i < kCrashSignals.size(); ++i)
+		sPreviousHandlers[i] = std::signal(kCrashSignals[i], &FlightRecorder::onCrashSignal);
+	mOwnsCrashHandler = true;
+}
+
+size_t FlightRecorder::getCapacity() const
+{
+	return mRecords.size();
+}
+
+uint64_t FlightRecorder::getRecordCount() const
+{
+	return mRecordCount.load(std::memory_order_relaxed);
+}
+
+void FlightRecorder::onCrashSignal(int signal)
+{
+	// Restore the default action first, so a fault while dumping terminates instead of recursing
+	std::signal(signal, SIG_DFL);
+
+	if (const FlightRecorder* recorder = sCrashRecorder.load())
+		recorder->dump(recorder->mCrashDumpPath.c_str(), "crash");
+
+	std::raise(signal);
+}
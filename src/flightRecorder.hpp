@@ -0,0 +1,69 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "gameState.hpp"
+
+// Key transition inside a tick, relative to the start of the tick
+struct FlightKeyEvent
+{
+	uint32_t offsetNs = 0;
+	bool right = false; // SDLK_RIGHT, otherwise SDLK_LEFT
+	bool down = false;
+};
+
+// Everything kept about one tick. Fixed size, so recording is a plain copy into the ring.
+struct FlightRecord
+{
+	static constexpr size_t kMaxKeyEvents = 4;
+
+	uint64_t frameIndex = 0;
+	uint64_t frameDeltaNs = 0;
+	uint32_t stateChecksum = 0;
+	float frameMs = 0.f; // CPU time of the frame, without frame limiting
+	float updateMs = 0.f;
+	float renderMs = 0.f;
+	GameState gameState = GameState::NotStarted;
+	uint8_t commands = 0; // ReplayCommand bits
+	uint8_t keyEventCount = 0; // Key transitions of the tick; only the first kMaxKeyEvents are kept
+	std::array<FlightKeyEvent, kMaxKeyEvents> keyEvents{};
+};
+
+// Always-on ring of the last ticks, dumped as CSV on request, on hitches and from a crash handler.
+// Dumping only uses preallocated memory and raw file writes, so it is safe inside a signal handler.
+class FlightRecorder final
+{
+public:
+	FlightRecorder(size_t capacity, std::string crashDumpPath);
+
+	// Uninstalls the crash handler if this recorder installed it
+	~FlightRecorder();
+
+	FlightRecorder(const FlightRecorder&) = delete;
+	FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+	void record(const FlightRecord& record);
+
+	// Writes the stored ticks oldest first. Returns false when the file could not be written.
+	bool dump(const char* path, const char* reason) const;
+
+	// Dumps to the crash dump path on SIGSEGV, SIGABRT, SIGFPE, SIGILL (and SIGBUS where it exists),
+	// then lets the default handler terminate the process
+	void installCrashHandler();
+
+	size_t getCapacity() const;
+
+	uint64_t getRecordCount() const;
+
+private:
+	static void onCrashSignal(int signal);
+
+	std::vector<FlightRecord> mRecords;
+	std::atomic<uint64_t> mRecordCount{ 0 };
+	std::string mCrashDumpPath;
+	bool mOwnsCrashHandler = false;
+};
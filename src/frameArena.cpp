@@ -0,0 +1,78 @@
+#include "frameArena.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+
+FrameArena::FrameArena(size_t capacity)
+	: mBuffer(std::make_unique<std::byte[]>(capacity)), mCapacity(capacity)
+{
+}
+
+void* FrameArena::allocate(size_t size, size_t alignment)
+{
+	const auto base = reinterpret_cast<uintptr_t>(mBuffer.get());
+
+	size_t offset = mOffset.load(std::memory_order_relaxed);
+	for (;;)
+	{
+		const size_t alignedOffset = ((base + offset + alignment - 1) & ~(alignment - 1)) - base;
+		const size_t end = alignedOffset + size;
+		if (end > mCapacity)
+			return allocateOverflow(size, alignment);
+
+		if (mOffset.compare_exchange_weak(offset, end, std::memory_order_relaxed))
+			return mBuffer.get() + alignedOffset;
+	}
+}
+
+void FrameArena::reset()
+{
+	const size_t used = getUsed();
+	mHighWaterMark = std::max(mHighWaterMark, used);
+
+	if (!mOverflowBlocks.empty())
+	{
+		// Grow so a frame like this one fits without overflowing next time
+		mCapacity = std::bit_ceil(mHighWaterMark + mHighWaterMark / 4);
+		mBuffer = std::make_unique<std::byte[]>(mCapacity);
+		mOverflowBlocks.clear();
+		mOverflowBytes = 0;
+		mOverflowCount++;
+	}
+
+	mOffset.store(0, std::memory_order_relaxed);
+}
+
+size_t FrameArena::getCapacity() const
+{
+	return mCapacity;
+}
+
+size_t FrameArena::getUsed() const
+{
+	return std::min(mOffset.load(std::memory_order_relaxed), mCapacity) + mOverflowBytes;
+}
+
+size_t FrameArena::getHighWaterMark() const
+{
+	return std::max(mHighWaterMark, getUsed());
+}
+
+size_t FrameArena::getOverflowCount() const
+{
+	return mOverflowCount;
+}
+
+void* FrameArena::allocateOverflow(size_t size, size_t alignment)
+{
+	std::scoped_lock lock(mOverflowMutex);
+
+	auto block = std::make_unique<std::byte[]>(size + alignment - 1);
+	const auto address = reinterpret_cast<uintptr_t>(block.get());
+	void* aligned = block.get() + (((address + alignment - 1) & ~(alignment - 1)) - address);
+
+	mOverflowBlocks.push_back(std::move(block));
+	mOverflowBytes += size;
+	return aligned;
+}
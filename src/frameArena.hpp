@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Linear allocator for data that lives for one frame. Allocation is a lock-free bump of an offset
+// and individual frees are no-ops; reset() releases everything at once at the end of the frame.
+// Requests that do not fit fall back to the heap, and the next reset() grows the arena so the
+// following frames fit again. After warm-up a frame therefore never touches the global heap.
+class FrameArena final
+{
+public:
+	explicit FrameArena(size_t capacity);
+
+	FrameArena(const FrameArena&) = delete;
+	FrameArena& operator=(const FrameArena&) = delete;
+
+	// Safe to call from several threads at once
+	void* allocate(size_t size, size_t alignment);
+
+	// Frees every allocation. Must not run concurrently with allocate().
+	void reset();
+
+	size_t getCapacity() const;
+
+	// Bytes handed out since the last reset, including overflow allocations
+	size_t getUsed() const;
+
+	// Largest getUsed() seen at any reset
+	size_t getHighWaterMark() const;
+
+	// Frames in which the arena overflowed to the heap
+	size_t getOverflowCount() const;
+
+private:
+	void* allocateOverflow(size_t size, size_t alignment);
+
+	std::unique_ptr<std::byte[]> mBuffer;
+	size_t mCapacity = 0;
+	std::atomic<size_t> mOffset{ 0 };
+
+	std::mutex mOverflowMutex;
+	std::vector<std::unique_ptr<std::byte[]>> mOverflowBlocks;
+	size_t mOverflowBytes = 0;
+	size_t mOverflowCount = 0;
+
+	size_t mHighWaterMark = 0;
+};
+
+// Standard allocator adapter so containers can draw from a FrameArena. Containers using it must
+// not outlive the frame they were created in.
+template <typename T>
+class FrameAllocator
+{
+public:
+	using value_type = T;
+
+	explicit FrameAllocator(FrameArena& arena) noexcept
+		: mArena(&arena)
+	{
+	}
+
+	template <typename U>
+	FrameAllocator(const FrameAllocator<U>& other) noexcept
+		: mArena(other.getArena())
+	{
+	}
+
+	T* allocate(size_t count)
+	{
+		return static_cast<T*>(mArena->allocate(count * sizeof(T), alignof(T)));
+	}
+
+	void deallocate(T*, size_t) noexcept
+	{
+	}
+
+	FrameArena* getArena() const noexcept
+	{
+		return mArena;
+	}
+
+	template <typename U>
+	bool operator==(const FrameAllocator<U>& other) const noexcept
+	{
+		return mArena == other.getArena();
+	}
+
+private:
+	FrameArena* mArena;
+};
+
+template <typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
@@ -1,17 +1,35 @@
 #pragma once
+#include <array>
+#include <cstdint>
+
+#include "math.hpp"
 
 namespace GameConfig
 {
+	// View
+	constexpr float kViewSize = 800.f; // Logical size of the square game area
+	constexpr float kWallThickness = 10.f;
 	// Block
 	constexpr Vector2 kBlockSize{ 65.f, 30.f };
 	constexpr size_t kBlockColumnCount = 12;
 	constexpr size_t kBlockRowCount = 5;
+	constexpr Vector2 kLevelOrigin{ 10.f, 10.f };
+	constexpr std::array kBlockTypeWeights = { 0.7f, 0.2f, 0.1f }; // Normal, Booster, Reinforced
 	constexpr uint32_t kParticlesPerBlock = 40;
+	constexpr size_t kReservedParticleCount = 8192; // Particle and batch storage reserved up front
+	// Endless mode
+	constexpr float kEndlessScrollSpeed = 12.f;
+	constexpr float kEndlessNoiseScale = 6.f;
+	constexpr float kEndlessNoiseThreshold = 0.35f;
 	// Ball
 	constexpr float kDefaultBallSpeed = 500.f;
 	constexpr float kBallSpeedIncrement = 100.f;
 	constexpr float kBallRadius = 10.f;
+	constexpr float kServeSpreadDegrees = 30.f; // Largest launch angle off vertical
+	// Physics
+	constexpr uint32_t kCcdIterationBudget = 16; // Collision steps per ball update before the rest of the move is dropped
 	// Platform
 	constexpr Vector2 kPlatformSize = { 60, 10 };
 	constexpr Vector2 kDefaultPlatformStartPosition = { 400, 700 };
+	constexpr float kPlatformSpeed = 500.f;
 }
\ No newline at end of file
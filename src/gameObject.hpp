@@ -3,17 +3,13 @@
 #include "math.hpp"
 #include "renderer.hpp"
 
+// Shared state of the singleton game objects (ball, platform, walls). Not polymorphic:
+// blocks and particles live in dense component arrays instead.
 class GameObject
 {
 public:
 	GameObject(Vector2 position, SDL_Color color);
 
-	virtual ~GameObject() = default;
-
-	virtual void render(const Renderer& renderer) const = 0;
-
-	virtual AABB getAABB() const = 0;
-
 	const Vector2& getPosition() const;
 
 	const SDL_Color& getColor() const;
@@ -0,0 +1,42 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "gameConfig.hpp"
+
+enum class DisplayMode : uint8_t
+{
+	Window,
+	Offscreen, // Software rendering into a surface that is never shown
+	None       // Simulation only
+};
+
+struct FrameRange
+{
+	uint64_t first = 0;
+	uint64_t last = 0;
+};
+
+// Command-line configurable game settings
+struct GameOptions
+{
+	std::string levelPath;             // Level file (.arkl) to play instead of generated levels
+	std::optional<uint64_t> levelSeed; // Fixed seed for generated levels, random per game when empty
+	bool endless = false;              // Vertically scrolling, streamed block field
+	bool assertNoAllocations = false;  // Abort on heap allocations in steady-state Running frames (allocation tracking builds)
+	std::optional<FrameRange> traceFrames; // Frames exported as a Chrome trace (profiling builds)
+	std::string tracePath = "arkanoid_trace.json";
+	bool publishTelemetry = false;     // Per-frame stats in shared memory for TelemetryMonitor
+	std::string recordPath;            // Replay file (.arkr) the session is recorded to
+	std::string replayPath;            // Replay file (.arkr) played back instead of live input
+	DisplayMode display = DisplayMode::Window; // Anything but Window also runs without audio
+	bool limitFrameRate = true;        // Wait out the rest of the 60 Hz frame budget
+	bool tiledRenderer = false;        // Rasterize frames on the CPU in parallel tiles instead of drawing through SDL_Renderer
+	bool collectFrameTimes = false;    // Keep the CPU time of every frame for Arkanoid::getFrameTimesMs
+	uint32_t flightRecorderSeconds = 10; // History of the always-on flight recorder, 0 disables it
+	float hitchDumpMs = 100.f;         // Frame time that dumps the flight recorder, 0 disables hitch dumps
+	bool autoplay = false;             // The built-in controller serves and steers instead of the arrow keys
+	uint32_t autoplayGames = 0;        // Games autoplay finishes before quitting, 0 plays until closed
+	uint32_t ccdIterationBudget = GameConfig::kCcdIterationBudget; // Collision steps per ball update
+};
@@ -0,0 +1,38 @@
+#include "gameRules.hpp"
+
+#include <cmath>
+
+#include "gameConfig.hpp"
+
+std::array<AABB, 3> GameRules::getWalls(float viewTop)
+{
+	using GameConfig::kViewSize;
+	using GameConfig::kWallThickness;
+	return {
+		AABB{ .min = { 0.f, viewTop }, .max = { kWallThickness, viewTop + kViewSize } },
+		AABB{ .min = { 0.f, viewTop }, .max = { kViewSize, viewTop + kWallThickness } },
+		AABB{ .min = { kViewSize - kWallThickness, viewTop }, .max = { kViewSize, viewTop + kViewSize } }
+	};
+}
+
+Vector2 GameRules::getServePosition(const Vector2& platformPosition)
+{
+	return { platformPosition.x, platformPosition.y - GameConfig::kBallRadius - GameConfig::kPlatformSize.y * 0.5f - 1.f };
+}
+
+Vector2 GameRules::getServeDirection(float angleDegrees)
+{
+	const float angleRad = angleDegrees * (pi / 180.0f);
+	return { std::sin(angleRad), -std::cos(angleRad) };
+}
+
+Vector2 GameRules::drawServeDirection(std::mt19937& rng)
+{
+	std::uniform_real_distribution angleDist(-GameConfig::kServeSpreadDegrees, GameConfig::kServeSpreadDegrees);
+	return getServeDirection(angleDist(rng));
+}
+
+bool GameRules::isBallLost(const Vector2& ballPosition, float viewTop)
+{
+	return ballPosition.y > viewTop + GameConfig::kViewSize;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <array>
+#include <random>
+
+#include "math.hpp"
+
+// Play area and serve rules shared by Arkanoid and its headless simulations, so they agree on
+// where the walls are, how the ball is launched and when it is lost
+namespace GameRules
+{
+	// Left, top and right wall of the view whose top edge is at viewTop
+	std::array<AABB, 3> getWalls(float viewTop = 0.f);
+
+	// Where a served ball starts, just above the platform centered at platformPosition
+	Vector2 getServePosition(const Vector2& platformPosition);
+
+	// Launch direction angleDegrees off vertical, upwards
+	Vector2 getServeDirection(float angleDegrees);
+
+	// Launch direction with an angle drawn uniformly within GameConfig::kServeSpreadDegrees
+	Vector2 drawServeDirection(std::mt19937& rng);
+
+	// A ball below the bottom of the view is lost
+	bool isBallLost(const Vector2& ballPosition, float viewTop = 0.f);
+}
@@ -0,0 +1,170 @@
+#include "headlessGame.hpp"
+
+#include <algorithm>
+
+#include "color.hpp"
+#include "gameConfig.hpp"
+#include "gameRules.hpp"
+#include "physics.hpp"
+
+HeadlessGame::HeadlessGame(const LevelGenConfig& config, uint32_t rngSeed, bool useDistanceField)
+{
+	mState.rng.seed(rngSeed);
+	mState.lifeCount = 3;
+	mState.gameState = GameState::AwaitingServe;
+	mState.platform.emplace(GameConfig::kDefaultPlatformStartPosition, GameConfig::kPlatformSize, Color::White);
+
+	const std::vector<LevelBlock> levelBlocks = LevelGenerator(config).generate();
+	BlockArrays& blocks = mPlayfield.resetStatic(levelBlocks.size());
+	for (const LevelBlock& levelBlock : levelBlocks)
+	{
+		blocks.add(getCellCenter(config.grid, levelBlock.column, levelBlock.row), config.grid.cellSize, levelBlock.type, levelBlock.hitPoints);
+		mState.maxScore += getBlockScore(levelBlock.type);
+	}
+
+	// Same wall layout as Arkanoid. The view never scrolls, so the context is built once and only
+	// loses blocks after that.
+	mCollisionContext.walls = GameRules::getWalls();
+
+	// Reverse order, front rows first, as in Arkanoid::updateCollisionContext
+	const auto aabbs = blocks.getAABBs();
+	mCollisionContext.blockAABBs.reserve(aabbs.size());
+	mCollisionContext.blockHandles.reserve(aabbs.size());
+	for (size_t i = aabbs.size(); i-- > 0;)
+	{
+		mCollisionContext.blockAABBs.push_back(aabbs[i]);
+		mCollisionContext.blockHandles.push_back({ 0, static_cast<uint32_t>(i) });
+	}
+	mCollisionContext.platform = mState.platform->getAABB();
+
+	if (useDistanceField)
+	{
+		mDistanceField = std::make_unique<DistanceField>(AABB{ .min = { 0.f, 0.f }, .max = { GameConfig::kViewSize, GameConfig::kViewSize } });
+		mDistanceField->build(mCollisionContext.walls, mCollisionContext.blockAABBs);
+		mCollisionContext.distanceField = mDistanceField.get();
+	}
+
+	// A level without scoring blocks is won before it starts
+	if (mState.maxScore == 0)
+		mState.gameState = GameState::Won;
+}
+
+void HeadlessGame::serve()
+{
+	if (mState.gameState != GameState::AwaitingServe)
+		return;
+
+	mState.ball.emplace(GameRules::getServePosition(mState.platform->getPosition()), GameConfig::kBallRadius, GameConfig::kDefaultBallSpeed);
+	mState.ball->setDirection(GameRules::drawServeDirection(mState.rng));
+
+	mState.gameState = GameState::Running;
+}
+
+void HeadlessGame::step(MoveDirection direction)
+{
+	if (isFinished())
+		return;
+
+	mStats.ticks++;
+	movePlatform(direction);
+	moveBall();
+	checkGameEndConditions();
+}
+
+bool HeadlessGame::isFinished() const
+{
+	return mState.gameState == GameState::GameOver || mState.gameState == GameState::Won;
+}
+
+const SimulationState& HeadlessGame::getState() const
+{
+	return mState;
+}
+
+const CollisionContext& HeadlessGame::getCollisionContext() const
+{
+	return mCollisionContext;
+}
+
+const HeadlessGameStats& HeadlessGame::getStats() const
+{
+	return mStats;
+}
+
+void HeadlessGame::movePlatform(MoveDirection direction)
+{
+	Platform& platform = *mState.platform;
+	platform.handleInput(direction);
+
+	const Vector2 start = platform.getPosition();
+	const float halfWidth = platform.getSize().x * 0.5f;
+	Vector2 position = platform.getPosition() + platform.getDirection() * kTickSeconds;
+	position.x = std::clamp(position.x, GameConfig::kWallThickness + halfWidth, GameConfig::kViewSize - GameConfig::kWallThickness - halfWidth);
+	platform.setPosition(position);
+
+	mCollisionContext.platform = platform.getAABB();
+	mCollisionContext.platformDirection = platform.getDirection();
+	mCollisionContext.platformDisplacement = position - start;
+}
+
+void HeadlessGame::moveBall()
+{
+	if (!mState.ball)
+		return;
+
+	Ball& ball = *mState.ball;
+	const float tickDistance = ball.getSpeed() * kTickSeconds;
+
+	// Same continuous collision loop and iteration budget as Arkanoid::updateBallPhysics
+	const CcdResult ccd = Physics::moveBall(ball, tickDistance, mCollisionContext, GameConfig::kCcdIterationBudget,
+		[&](const PhysicsHitResult& hit)
+	{
+		if (hit.hitPlatform)
+		{
+			ball.resetSpeedAndColor();
+			mStats.platformBounces++;
+		}
+		else if (hit.hitWall)
+			mStats.wallBounces++;
+		else if (hit.hitBlock)
+		{
+			mStats.blockBounces++;
+
+			const BlockHandle handle = mCollisionContext.blockHandles[*hit.hitBlock];
+			BlockArrays& blocks = mPlayfield.getChunk(handle.chunk).blocks;
+			const BlockType type = blocks.getType(handle.index);
+
+			if (blocks.hit(handle.index))
+			{
+				mState.score += getBlockScore(type);
+				mStats.blocksDestroyed++;
+				mCollisionContext.removeBlock(*hit.hitBlock);
+			}
+			if (type == BlockType::Booster)
+			{
+				ball.setSpeed(ball.getSpeed() + GameConfig::kBallSpeedIncrement);
+				mStats.boosterHits++;
+			}
+		}
+	});
+	mStats.ccd.record(ccd);
+}
+
+void HeadlessGame::checkGameEndConditions()
+{
+	if (!mState.ball)
+		return;
+
+	if (mState.score == mState.maxScore)
+	{
+		mState.gameState = GameState::Won;
+		mState.ball.reset();
+	}
+	else if (GameRules::isBallLost(mState.ball->getPosition()))
+	{
+		mState.lifeCount--;
+		mStats.livesLost++;
+		mState.ball.reset();
+		mState.gameState = mState.lifeCount == 0 ? GameState::GameOver : GameState::AwaitingServe;
+	}
+}
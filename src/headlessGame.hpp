@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "collisionContext.hpp"
+#include "distanceField.hpp"
+#include "levelGenerator.hpp"
+#include "physics.hpp"
+#include "platform.hpp"
+#include "playfield.hpp"
+#include "simulationState.hpp"
+
+struct HeadlessGameStats
+{
+	uint64_t ticks = 0;
+	uint32_t livesLost = 0;
+	uint32_t platformBounces = 0;
+	uint32_t wallBounces = 0;
+	uint32_t blockBounces = 0;
+	uint32_t boosterHits = 0;
+	uint32_t blocksDestroyed = 0;
+	CcdStats ccd;
+};
+
+// One game of Arkanoid's rules on a generated level, without window, audio, particles or clock.
+// Every tick is exactly 1/60 s and all state, including the random numbers, lives in the instance,
+// so any number of games can run side by side on different threads.
+class HeadlessGame final
+{
+public:
+	static constexpr float kTickSeconds = 1.f / 60.f;
+
+	// Generates the level from config and starts the game awaiting the first serve. With useDistanceField
+	// moves through open space are checked against a distance field over walls and blocks instead of sweeping them.
+	HeadlessGame(const LevelGenConfig& config, uint32_t rngSeed, bool useDistanceField = false);
+
+	// Launches the ball when the game is awaiting a serve
+	void serve();
+
+	// Advances one tick with the platform moving in direction for the whole tick
+	void step(MoveDirection direction);
+
+	bool isFinished() const;
+
+	const SimulationState& getState() const;
+
+	// Walls, platform and live blocks as the physics sees them; the input for AutoplayController
+	const CollisionContext& getCollisionContext() const;
+
+	const HeadlessGameStats& getStats() const;
+
+private:
+	void movePlatform(MoveDirection direction);
+
+	void moveBall();
+
+	void checkGameEndConditions();
+
+	SimulationState mState;
+	Playfield mPlayfield;
+	CollisionContext mCollisionContext;
+	std::unique_ptr<DistanceField> mDistanceField; // Behind a pointer so the context's reference survives moves
+	HeadlessGameStats mStats;
+};
@@ -1,36 +1,66 @@
 #include "inputManager.hpp"
 
+#include <algorithm>
+
+InputManager::InputManager()
+{
+	mKeys.reserve(kReservedKeyCount);
+}
+
 void InputManager::handleEvent(const SDL_Event& e)
 {
 	if (e.type == SDL_EVENT_KEY_DOWN && !e.key.repeat)
 	{
-		mKeyHeld[e.key.key] = true;
-		mKeyPressed[e.key.key] = true;
+		KeyState& state = getKeyState(e.key.key);
+		state.isHeld = true;
+		state.isPressed = true;
 	}
 	else if (e.type == SDL_EVENT_KEY_UP)
 	{
-		mKeyHeld[e.key.key] = false;
-		mKeyReleased[e.key.key] = true;
+		KeyState& state = getKeyState(e.key.key);
+		state.isHeld = false;
+		state.isReleased = true;
 	}
 }
 
 bool InputManager::isKeyPressed(SDL_Keycode key) const
 {
-	return mKeyPressed.contains(key) && mKeyPressed.at(key);
+	const KeyState* state = findKeyState(key);
+	return state && state->isPressed;
 }
 
 bool InputManager::isKeyReleased(SDL_Keycode key) const
 {
-	return mKeyReleased.contains(key) && mKeyReleased.at(key);
+	const KeyState* state = findKeyState(key);
+	return state && state->isReleased;
 }
 
 bool InputManager::isKeyHeld(SDL_Keycode key) const
 {
-	return mKeyHeld.contains(key) && mKeyHeld.at(key);
+	const KeyState* state = findKeyState(key);
+	return state && state->isHeld;
 }
 
 void InputManager::clear()
 {
-	mKeyPressed.clear();
-	mKeyReleased.clear();
+	for (KeyState& state : mKeys)
+	{
+		state.isPressed = false;
+		state.isReleased = false;
+	}
+}
+
+InputManager::KeyState& InputManager::getKeyState(SDL_Keycode key)
+{
+	auto it = std::ranges::find(mKeys, key, &KeyState::key);
+	if (it != mKeys.end())
+		return *it;
+
+	return mKeys.emplace_back(KeyState{ .key = key });
+}
+
+const InputManager::KeyState* InputManager::findKeyState(SDL_Keycode key) const
+{
+	auto it = std::ranges::find(mKeys, key, &KeyState::key);
+	return it != mKeys.end() ? &*it : nullptr;
 }
@@ -1,11 +1,13 @@
 #pragma once
 
 #include <SDL3/SDL.h>
-#include <unordered_map>
+#include <vector>
 
 class InputManager
 {
 public:
+	InputManager();
+
 	void handleEvent(const SDL_Event& e);
 
 	bool isKeyPressed(SDL_Keycode key) const;
@@ -15,7 +17,20 @@ public:
 	void clear(); // To be called every frame to reset per-frame flags
 
 private:
-	std::unordered_map<SDL_Keycode, bool> mKeyHeld;
-	std::unordered_map<SDL_Keycode, bool> mKeyPressed;
-	std::unordered_map<SDL_Keycode, bool> mKeyReleased;
+	struct KeyState
+	{
+		SDL_Keycode key = 0;
+		bool isHeld = false;
+		bool isPressed = false;
+		bool isReleased = false;
+	};
+
+	KeyState& getKeyState(SDL_Keycode key);
+
+	const KeyState* findKeyState(SDL_Keycode key) const;
+
+	// Only a handful of keys are ever seen, so a flat list beats a hash map and, with its
+	// reserved capacity, never allocates while playing
+	static constexpr size_t kReservedKeyCount = 64;
+	std::vector<KeyState> mKeys;
 };
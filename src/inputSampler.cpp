@@ -0,0 +1,88 @@
+#include "inputSampler.hpp"
+
+#include <algorithm>
+
+InputSampler::InputSampler()
+{
+	SDL_AddEventWatch(&InputSampler::onEvent, this);
+}
+
+InputSampler::~InputSampler()
+{
+	SDL_RemoveEventWatch(&InputSampler::onEvent, this);
+}
+
+void InputSampler::sampleUntil(Uint64 deadlineNs) const
+{
+	constexpr Uint64 samplePeriodNs = 1'000'000'000 / kSampleRateHz;
+
+	while (true)
+	{
+		// Event watches run while events are pumped, which timestamps and queues new transitions
+		SDL_PumpEvents();
+
+		const Uint64 now = SDL_GetTicksNS();
+		if (now >= deadlineNs)
+			break;
+
+		SDL_DelayNS(std::min(samplePeriodNs, deadlineNs - now));
+	}
+}
+
+bool InputSampler::popEventBefore(Uint64 timeNs, InputEvent& event)
+{
+	if (!mEvents.peek(event) || event.timestampNs > timeNs)
+		return false;
+
+	return mEvents.tryPop(event);
+}
+
+void InputSampler::markApplied(const InputEvent& event)
+{
+	if (mPendingCount < kMaxPendingLatencySamples)
+		mPendingTimestamps[mPendingCount++] = event.timestampNs;
+}
+
+void InputSampler::markPresented(Uint64 presentNs)
+{
+	for (size_t i = 0; i < mPendingCount; ++i)
+	{
+		const double latencyMs = static_cast<double>(presentNs - std::min(presentNs, mPendingTimestamps[i])) / 1'000'000.0;
+
+		mLatencyStats.sampleCount++;
+		mLatencyStats.lastMs = latencyMs;
+		mLatencyStats.averageMs += (latencyMs - mLatencyStats.averageMs) / static_cast<double>(mLatencyStats.sampleCount);
+		mLatencyStats.maxMs = std::max(mLatencyStats.maxMs, latencyMs);
+	}
+	mPendingCount = 0;
+}
+
+const InputLatencyStats& InputSampler::getLatencyStats() const
+{
+	return mLatencyStats;
+}
+
+uint64_t InputSampler::getDroppedEventCount() const
+{
+	return mDroppedEvents.load(std::memory_order_relaxed);
+}
+
+bool SDLCALL InputSampler::onEvent(void* userdata, SDL_Event* event)
+{
+	auto* sampler = static_cast<InputSampler*>(userdata);
+
+	const bool isKeyTransition = (event->type == SDL_EVENT_KEY_DOWN && !event->key.repeat) || event->type == SDL_EVENT_KEY_UP;
+	if (isKeyTransition)
+	{
+		const InputEvent inputEvent{
+			.timestampNs = event->key.timestamp,
+			.key = event->key.key,
+			.down = event->type == SDL_EVENT_KEY_DOWN
+		};
+		if (!sampler->mEvents.tryPush(inputEvent))
+			sampler->mDroppedEvents.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	// Return value is ignored for event watches
+	return true;
+}
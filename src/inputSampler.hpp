@@ -0,0 +1,67 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "SDL3/SDL.h"
+#include "spscRing.hpp"
+
+// A single key transition together with the time (SDL_GetTicksNS timebase) it happened
+struct InputEvent
+{
+	Uint64 timestampNs = 0;
+	SDL_Keycode key = 0;
+	bool down = false;
+};
+
+struct InputLatencyStats
+{
+	uint64_t sampleCount = 0;
+	double lastMs = 0.0;
+	double averageMs = 0.0;
+	double maxMs = 0.0;
+};
+
+// Captures timestamped key transitions into a lock-free ring as soon as SDL receives them.
+// SDL only allows pumping OS events on the thread that owns the video subsystem, so instead of a
+// separate thread the sampler pumps at kSampleRateHz on the main thread while it would otherwise sleep.
+class InputSampler final
+{
+public:
+	static constexpr Uint64 kSampleRateHz = 1000;
+
+	InputSampler();
+
+	~InputSampler();
+
+	InputSampler(const InputSampler&) = delete;
+	InputSampler& operator=(const InputSampler&) = delete;
+
+	// Pumps the OS event queue at kSampleRateHz until the deadline (SDL_GetTicksNS timebase)
+	void sampleUntil(Uint64 deadlineNs) const;
+
+	// Pops the oldest transition that happened at or before the given time
+	bool popEventBefore(Uint64 timeNs, InputEvent& event);
+
+	// Remembers an applied input so its latency can be measured once the frame is presented
+	void markApplied(const InputEvent& event);
+
+	// Closes latency measurement for every input applied since the last present
+	void markPresented(Uint64 presentNs);
+
+	const InputLatencyStats& getLatencyStats() const;
+
+	uint64_t getDroppedEventCount() const;
+
+private:
+	static bool SDLCALL onEvent(void* userdata, SDL_Event* event);
+
+	SpscRing<InputEvent, 256> mEvents;
+	std::atomic<uint64_t> mDroppedEvents{ 0 };
+
+	static constexpr size_t kMaxPendingLatencySamples = 16;
+	std::array<Uint64, kMaxPendingLatencySamples> mPendingTimestamps{};
+	size_t mPendingCount = 0;
+	InputLatencyStats mLatencyStats;
+};
@@ -0,0 +1,195 @@
+#include "levelFormat.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <format>
+#include <stdexcept>
+
+namespace
+{
+	void putU16(std::vector<uint8_t>& out, uint16_t value)
+	{
+		out.push_back(static_cast<uint8_t>(value));
+		out.push_back(static_cast<uint8_t>(value >> 8));
+	}
+
+	void putU32(std::vector<uint8_t>& out, uint32_t value)
+	{
+		for (int shift = 0; shift < 32; shift += 8)
+			out.push_back(static_cast<uint8_t>(value >> shift));
+	}
+
+	void putF32(std::vector<uint8_t>& out, float value)
+	{
+		putU32(out, std::bit_cast<uint32_t>(value));
+	}
+
+	uint32_t getU32(const uint8_t* data)
+	{
+		return static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8) |
+			(static_cast<uint32_t>(data[2]) << 16) | (static_cast<uint32_t>(data[3]) << 24);
+	}
+
+	float getF32(const uint8_t* data)
+	{
+		return std::bit_cast<float>(getU32(data));
+	}
+
+	uint8_t packTypeAndHitPoints(const LevelBlock& block)
+	{
+		return static_cast<uint8_t>((static_cast<uint8_t>(block.type) << 5) | block.hitPoints);
+	}
+
+	bool continuesRun(const LevelBlock& runStart, uint16_t runCount, const LevelBlock& block)
+	{
+		return block.row == runStart.row && block.column == runStart.column + runCount &&
+			block.type == runStart.type && block.hitPoints == runStart.hitPoints && runCount < UINT16_MAX;
+	}
+}
+
+void writeLevelFile(const std::string& path, const LevelGrid& grid, std::span<const LevelBlock> blocks, bool runLength)
+{
+	std::vector<uint8_t> records;
+	records.reserve(blocks.size() * LevelFormat::kRecordSize);
+
+	uint32_t recordCount = 0;
+	for (size_t i = 0; i < blocks.size();)
+	{
+		const LevelBlock& block = blocks[i];
+		if (block.column >= grid.columns || block.row >= grid.rows)
+			throw std::runtime_error(std::format("Block at ({}, {}) is outside the {}x{} level grid", block.column, block.row, grid.columns, grid.rows));
+		if (block.hitPoints == 0 || block.hitPoints > LevelFormat::kMaxHitPoints || block.type >= BlockType::Count)
+			throw std::runtime_error(std::format("Block at ({}, {}) has an invalid type or hit points", block.column, block.row));
+
+		uint16_t runCount = 1;
+		if (runLength)
+		{
+			while (i + runCount < blocks.size() && continuesRun(block, runCount, blocks[i + runCount]))
+				runCount++;
+		}
+
+		putU16(records, block.column);
+		putU16(records, block.row);
+		records.push_back(packTypeAndHitPoints(block));
+		if (runLength)
+			putU16(records, runCount);
+
+		recordCount++;
+		i += runCount;
+	}
+
+	std::vector<uint8_t> header;
+	header.reserve(LevelFormat::kHeaderSize);
+	header.insert(header.end(), LevelFormat::kMagic.begin(), LevelFormat::kMagic.end());
+	putU16(header, LevelFormat::kVersion);
+	putU16(header, runLength ? LevelFormat::kFlagRunLength : 0);
+	putU16(header, grid.columns);
+	putU16(header, grid.rows);
+	putU32(header, static_cast<uint32_t>(blocks.size()));
+	putU32(header, recordCount);
+	putF32(header, grid.cellSize.x);
+	putF32(header, grid.cellSize.y);
+	putF32(header, grid.origin.x);
+	putF32(header, grid.origin.y);
+
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file)
+		throw std::runtime_error(std::format("Failed to open level file {} for writing", path));
+
+	file.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+	file.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(records.size()));
+	if (!file)
+		throw std::runtime_error(std::format("Failed to write level file {}", path));
+}
+
+LevelReader::LevelReader(const std::string& path)
+	: mPath(path), mFile(path, std::ios::binary), mBuffer(kBufferSize)
+{
+	if (!mFile)
+		throw std::runtime_error(std::format("Failed to open level file {}", path));
+
+	std::array<uint8_t, LevelFormat::kHeaderSize> header;
+	if (!mFile.read(reinterpret_cast<char*>(header.data()), header.size()))
+		throwCorrupt("truncated header");
+
+	if (!std::equal(LevelFormat::kMagic.begin(), LevelFormat::kMagic.end(), header.begin()))
+		throwCorrupt("bad magic");
+
+	const uint16_t version = readU16(&header[4]);
+	if (version != LevelFormat::kVersion)
+		throw std::runtime_error(std::format("Level file {} has unsupported version {}", path, version));
+
+	mHeader.flags = readU16(&header[6]);
+	mHeader.grid.columns = readU16(&header[8]);
+	mHeader.grid.rows = readU16(&header[10]);
+	mHeader.blockCount = getU32(&header[12]);
+	mHeader.recordCount = getU32(&header[16]);
+	mHeader.grid.cellSize = { getF32(&header[20]), getF32(&header[24]) };
+	mHeader.grid.origin = { getF32(&header[28]), getF32(&header[32]) };
+
+	// The block count sizes storage before any record is read, so it has to be backed by the grid and the
+	// records actually in the file: every record is at least one block, a run at most a row
+	const bool runLength = (mHeader.flags & LevelFormat::kFlagRunLength) != 0;
+	const uint64_t recordSize = runLength ? LevelFormat::kRunLengthRecordSize : LevelFormat::kRecordSize;
+	const uint64_t maxRun = runLength ? mHeader.grid.columns : 1;
+	const uint64_t cellCount = static_cast<uint64_t>(mHeader.grid.columns) * mHeader.grid.rows;
+
+	const std::streampos recordsStart = mFile.tellg();
+	mFile.seekg(0, std::ios::end);
+	const auto recordBytes = static_cast<uint64_t>(mFile.tellg() - recordsStart);
+	mFile.seekg(recordsStart);
+
+	if (static_cast<uint64_t>(mHeader.recordCount) * recordSize > recordBytes)
+		throwCorrupt("truncated block records");
+	if (mHeader.recordCount > mHeader.blockCount || mHeader.blockCount > static_cast<uint64_t>(mHeader.recordCount) * maxRun)
+		throwCorrupt("block count does not match the records");
+	if (mHeader.blockCount > cellCount)
+		throwCorrupt("more blocks than level grid cells");
+}
+
+const LevelHeader& LevelReader::getHeader() const
+{
+	return mHeader;
+}
+
+const uint8_t* LevelReader::nextRecord(size_t recordSize)
+{
+	if (mBufferEnd - mBufferPos < recordSize)
+	{
+		// Move the partial record to the front and refill the rest of the buffer
+		const size_t leftover = mBufferEnd - mBufferPos;
+		std::memmove(mBuffer.data(), mBuffer.data() + mBufferPos, leftover);
+		mFile.read(reinterpret_cast<char*>(mBuffer.data() + leftover), static_cast<std::streamsize>(mBuffer.size() - leftover));
+		mBufferPos = 0;
+		mBufferEnd = leftover + static_cast<size_t>(mFile.gcount());
+
+		if (mBufferEnd < recordSize)
+			throwCorrupt("truncated block records");
+	}
+
+	const uint8_t* record = mBuffer.data() + mBufferPos;
+	mBufferPos += recordSize;
+	return record;
+}
+
+LevelBlock LevelReader::decodeRecord(const uint8_t* record, uint16_t runCount) const
+{
+	LevelBlock block;
+	block.column = readU16(record);
+	block.row = readU16(record + 2);
+	block.type = static_cast<BlockType>(record[4] >> 5);
+	block.hitPoints = record[4] & LevelFormat::kMaxHitPoints;
+
+	if (runCount == 0 || block.column + runCount > mHeader.grid.columns || block.row >= mHeader.grid.rows)
+		throwCorrupt("block outside level grid");
+	if (block.type >= BlockType::Count || block.hitPoints == 0)
+		throwCorrupt("invalid block type or hit points");
+
+	return block;
+}
+
+void LevelReader::throwCorrupt(const char* reason) const
+{
+	throw std::runtime_error(std::format("Level file {} is corrupt: {}", mPath, reason));
+}
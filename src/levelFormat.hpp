@@ -0,0 +1,122 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "blockType.hpp"
+#include "math.hpp"
+
+// Binary level file (.arkl), all values little-endian:
+//   header   magic "ARKL", u16 version, u16 flags, u16 columns, u16 rows,
+//            u32 block count, u32 record count, f32 cell size x/y, f32 origin x/y
+//   records  u16 column, u16 row, u8 (type << 5 | hit points) [, u16 run length if RLE]
+// A run-length record expands to consecutive columns in the same row.
+namespace LevelFormat
+{
+	constexpr std::array<char, 4> kMagic = { 'A', 'R', 'K', 'L' };
+	constexpr uint16_t kVersion = 1;
+	constexpr uint16_t kFlagRunLength = 1 << 0;
+
+	constexpr size_t kHeaderSize = 36;
+	constexpr size_t kRecordSize = 5;
+	constexpr size_t kRunLengthRecordSize = 7;
+	constexpr uint8_t kMaxHitPoints = 31;
+}
+
+// Grid the blocks of a level are placed on, in logical game units
+struct LevelGrid
+{
+	uint16_t columns = 0;
+	uint16_t rows = 0;
+	Vector2 cellSize;
+	Vector2 origin;
+};
+
+struct LevelHeader
+{
+	LevelGrid grid;
+	uint32_t blockCount = 0;
+	uint32_t recordCount = 0;
+	uint16_t flags = 0;
+};
+
+struct LevelBlock
+{
+	uint16_t column = 0;
+	uint16_t row = 0;
+	BlockType type = BlockType::Normal;
+	uint8_t hitPoints = 1;
+};
+
+inline Vector2 getCellCenter(const LevelGrid& grid, uint16_t column, uint16_t row)
+{
+	return {
+		grid.origin.x + (static_cast<float>(column) + 0.5f) * grid.cellSize.x,
+		grid.origin.y + (static_cast<float>(row) + 0.5f) * grid.cellSize.y
+	};
+}
+
+// Writes blocks (expected in row-major order for best run-length compression) to a level file
+void writeLevelFile(const std::string& path, const LevelGrid& grid, std::span<const LevelBlock> blocks, bool runLength);
+
+// Streams a level file through a fixed-size buffer, so even huge levels are decoded without
+// holding the whole file or an intermediate block list in memory
+class LevelReader final
+{
+public:
+	explicit LevelReader(const std::string& path);
+
+	const LevelHeader& getHeader() const;
+
+	// Calls fn(const LevelBlock&) for every block in file order
+	template <typename Fn>
+	void forEachBlock(Fn&& fn)
+	{
+		const bool runLength = (mHeader.flags & LevelFormat::kFlagRunLength) != 0;
+		const size_t recordSize = runLength ? LevelFormat::kRunLengthRecordSize : LevelFormat::kRecordSize;
+
+		uint32_t emitted = 0;
+		for (uint32_t i = 0; i < mHeader.recordCount; ++i)
+		{
+			const uint8_t* record = nextRecord(recordSize);
+			const uint16_t runCount = runLength ? readU16(record + 5) : 1;
+
+			LevelBlock block = decodeRecord(record, runCount);
+			if (emitted + runCount > mHeader.blockCount)
+				throwCorrupt("more blocks than declared in header");
+
+			for (uint16_t run = 0; run < runCount; ++run, ++block.column)
+				fn(static_cast<const LevelBlock&>(block));
+
+			emitted += runCount;
+		}
+
+		if (emitted != mHeader.blockCount)
+			throwCorrupt("fewer blocks than declared in header");
+	}
+
+private:
+	const uint8_t* nextRecord(size_t recordSize);
+
+	LevelBlock decodeRecord(const uint8_t* record, uint16_t runCount) const;
+
+	[[noreturn]] void throwCorrupt(const char* reason) const;
+
+	static uint16_t readU16(const uint8_t* data)
+	{
+		return static_cast<uint16_t>(data[0] | (data[1] << 8));
+	}
+
+	static constexpr size_t kBufferSize = 64 * 1024;
+
+	std::string mPath;
+	std::ifstream mFile;
+	LevelHeader mHeader;
+	std::vector<uint8_t> mBuffer;
+	size_t mBufferPos = 0;
+	size_t mBufferEnd = 0;
+};
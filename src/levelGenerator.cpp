@@ -0,0 +1,144 @@
+#include "levelGenerator.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+
+LevelGenerator::LevelGenerator(const LevelGenConfig& config)
+	: mConfig(config), mTypeTable(config.typeWeights), mTypeRng(config.seed), mNoiseRng(config.seed ^ kNoiseSeedSalt)
+{
+}
+
+std::vector<LevelBlock> LevelGenerator::generate() const
+{
+	const uint32_t rows = mConfig.grid.rows;
+	const uint32_t chunkCount = (rows + kRowsPerChunk - 1) / kRowsPerChunk;
+
+	uint32_t threadCount = mConfig.threadCount != 0 ? mConfig.threadCount : std::max(1u, std::thread::hardware_concurrency());
+	threadCount = std::min(threadCount, chunkCount);
+
+	std::vector<LevelBlock> blocks;
+	if (threadCount <= 1)
+	{
+		blocks.reserve(static_cast<size_t>(mConfig.grid.columns) * rows);
+		generateRows(0, rows, blocks);
+		return blocks;
+	}
+
+	// Workers pull row chunks from a shared counter; chunks are concatenated in order afterwards,
+	// so the result does not depend on the thread count
+	std::vector<std::vector<LevelBlock>> chunks(chunkCount);
+	std::atomic<uint32_t> nextChunk{ 0 };
+	auto worker = [&]
+	{
+		for (uint32_t chunk = nextChunk++; chunk < chunkCount; chunk = nextChunk++)
+		{
+			const uint32_t firstRow = chunk * kRowsPerChunk;
+			const uint32_t rowCount = std::min(kRowsPerChunk, rows - firstRow);
+			chunks[chunk].reserve(static_cast<size_t>(mConfig.grid.columns) * rowCount);
+			generateRows(firstRow, rowCount, chunks[chunk]);
+		}
+	};
+
+	{
+		std::vector<std::jthread> workers;
+		workers.reserve(threadCount - 1);
+		for (uint32_t i = 1; i < threadCount; ++i)
+			workers.emplace_back(worker);
+		worker();
+	}
+
+	size_t total = 0;
+	for (const auto& chunk : chunks)
+		total += chunk.size();
+
+	blocks.reserve(total);
+	for (const auto& chunk : chunks)
+		blocks.insert(blocks.end(), chunk.begin(), chunk.end());
+
+	return blocks;
+}
+
+void LevelGenerator::generateRows(uint32_t firstRow, uint32_t rowCount, std::vector<LevelBlock>& out) const
+{
+	const uint32_t columns = mConfig.grid.columns;
+	const bool hasSymmetry = mConfig.symmetry != LevelSymmetry::None;
+	const bool hasNoise = mConfig.noiseScale > 0.f;
+
+	out.reserve(out.size() + static_cast<size_t>(columns) * rowCount);
+
+	for (uint32_t row = firstRow; row < firstRow + rowCount; ++row)
+	{
+		for (uint32_t column = 0; column < columns; ++column)
+		{
+			// Symmetric patterns draw every cell from its canonical cell
+			uint32_t sourceColumn = column;
+			uint32_t sourceRow = row;
+			if (hasSymmetry)
+				applySymmetry(sourceColumn, sourceRow);
+
+			if (hasNoise && sampleNoise(sourceColumn, sourceRow) < mConfig.noiseThreshold)
+				continue;
+
+			const uint64_t cellIndex = static_cast<uint64_t>(sourceRow) * columns + sourceColumn;
+			const auto type = static_cast<BlockType>(mTypeTable.sample(mTypeRng.at(cellIndex)));
+			out.push_back(LevelBlock{
+				.column = static_cast<uint16_t>(column),
+				.row = static_cast<uint16_t>(row),
+				.type = type,
+				.hitPoints = getDefaultHitPoints(type)
+			});
+		}
+	}
+}
+
+void LevelGenerator::reseed(uint64_t seed)
+{
+	mConfig.seed = seed;
+	mTypeRng = CounterRng(seed);
+	mNoiseRng = CounterRng(seed ^ kNoiseSeedSalt);
+}
+
+const LevelGenConfig& LevelGenerator::getConfig() const
+{
+	return mConfig;
+}
+
+float LevelGenerator::sampleNoise(uint32_t column, uint32_t row) const
+{
+	// Bilinear value noise over a hashed lattice with smoothstep interpolation
+	const float x = static_cast<float>(column) / mConfig.noiseScale;
+	const float y = static_cast<float>(row) / mConfig.noiseScale;
+	const auto x0 = static_cast<uint64_t>(x);
+	const auto y0 = static_cast<uint64_t>(y);
+	const float fx = x - static_cast<float>(x0);
+	const float fy = y - static_cast<float>(y0);
+	const float sx = fx * fx * (3.f - 2.f * fx);
+	const float sy = fy * fy * (3.f - 2.f * fy);
+
+	auto lattice = [this](uint64_t lx, uint64_t ly)
+	{
+		return mNoiseRng.uniformAt((ly << 32) ^ lx);
+	};
+
+	const float top = lattice(x0, y0) + (lattice(x0 + 1, y0) - lattice(x0, y0)) * sx;
+	const float bottom = lattice(x0, y0 + 1) + (lattice(x0 + 1, y0 + 1) - lattice(x0, y0 + 1)) * sx;
+	return top + (bottom - top) * sy;
+}
+
+void LevelGenerator::applySymmetry(uint32_t& column, uint32_t& row) const
+{
+	const uint32_t columns = mConfig.grid.columns;
+	const uint32_t rows = std::max<uint32_t>(mConfig.grid.rows, 1);
+
+	if (mConfig.symmetry == LevelSymmetry::MirrorX || mConfig.symmetry == LevelSymmetry::MirrorXY)
+		column = std::min(column, columns - 1 - column);
+
+	// Rows beyond the grid repeat the mirrored pattern every grid height
+	if (mConfig.symmetry == LevelSymmetry::MirrorY || mConfig.symmetry == LevelSymmetry::MirrorXY)
+	{
+		const uint32_t rowInGrid = row % rows;
+		row = row - rowInGrid + std::min(rowInGrid, rows - 1 - rowInGrid);
+	}
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "aliasTable.hpp"
+#include "blockType.hpp"
+#include "counterRng.hpp"
+#include "gameConfig.hpp"
+#include "levelFormat.hpp"
+
+enum class LevelSymmetry : uint8_t
+{
+	None,
+	MirrorX,  // Left half mirrored to the right
+	MirrorY,  // Top half mirrored to the bottom
+	MirrorXY
+};
+
+struct LevelGenConfig
+{
+	uint64_t seed = 0;
+	LevelGrid grid;
+	std::array<float, static_cast<size_t>(BlockType::Count)> typeWeights = GameConfig::kBlockTypeWeights;
+	LevelSymmetry symmetry = LevelSymmetry::None;
+
+	// Value-noise field carving holes into the grid. Cells whose noise is below the threshold stay empty.
+	// The scale is the size of one noise lattice cell in grid cells, 0 disables the field.
+	float noiseScale = 0.f;
+	float noiseThreshold = 0.f;
+
+	// Worker threads used by generate(); 0 picks the hardware concurrency
+	uint32_t threadCount = 1;
+};
+
+// Seeded procedural level generator. Every cell is a pure function of (seed, column, row), so
+// levels are reproducible and any set of rows can be generated independently and in parallel.
+class LevelGenerator final
+{
+public:
+	explicit LevelGenerator(const LevelGenConfig& config);
+
+	// Generates the whole grid in row-major order
+	std::vector<LevelBlock> generate() const;
+
+	// Appends rows [firstRow, firstRow + rowCount) in row-major order. Rows may lie outside the
+	// configured grid, which lets streaming playfields extend the field indefinitely.
+	void generateRows(uint32_t firstRow, uint32_t rowCount, std::vector<LevelBlock>& out) const;
+
+	// Switches to another level seed, keeping the rest of the configuration. Unlike constructing a
+	// new generator this allocates nothing.
+	void reseed(uint64_t seed);
+
+	const LevelGenConfig& getConfig() const;
+
+private:
+	float sampleNoise(uint32_t column, uint32_t row) const;
+
+	void applySymmetry(uint32_t& column, uint32_t& row) const;
+
+	static constexpr uint32_t kRowsPerChunk = 64;
+	static constexpr uint64_t kNoiseSeedSalt = 0x6E6F697365ull; // "noise"
+
+	LevelGenConfig mConfig;
+	AliasTable mTypeTable;
+	CounterRng mTypeRng;
+	CounterRng mNoiseRng;
+};
@@ -1,19 +1,130 @@
 #include <exception>
+#include <format>
 #include <iostream>
+#include <stdexcept>
+#include <string_view>
 
+#include "allocationTracker.hpp"
 #include "arkanoid.hpp"
+#include "profiler.hpp"
+
+static FrameRange parseFrameRange(std::string_view text)
+{
+	const size_t separator = text.find(':');
+	if (separator == std::string_view::npos)
+		throw std::invalid_argument(std::format("Expected a frame range FIRST:LAST, got {}", text));
+
+	FrameRange range{
+		.first = std::stoull(std::string(text.substr(0, separator))),
+		.last = std::stoull(std::string(text.substr(separator + 1)))
+	};
+	if (range.last < range.first)
+		throw std::invalid_argument(std::format("Frame range {} ends before it starts", text));
+
+	return range;
+}
+
+// Usage: Arkanoid [level.arkl] [--seed N] [--endless] [--assert-no-alloc] [--trace FIRST:LAST [--trace-out FILE]] [--telemetry] [--record FILE | --replay FILE] [--flight-seconds N] [--hitch-ms MS] [--autoplay [--games N]] [--headless] [--tiled-renderer] [--ccd-budget N]
+static GameOptions parseGameOptions(int argc, char* argv[])
+{
+	GameOptions options;
+	bool hasFlightSeconds = false;
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string_view arg = argv[i];
+		if (arg == "--seed" && i + 1 < argc)
+			options.levelSeed = std::stoull(argv[++i]);
+		else if (arg == "--endless")
+			options.endless = true;
+		else if (arg == "--assert-no-alloc")
+			options.assertNoAllocations = true;
+		else if (arg == "--trace" && i + 1 < argc)
+			options.traceFrames = parseFrameRange(argv[++i]);
+		else if (arg == "--trace-out" && i + 1 < argc)
+			options.tracePath = argv[++i];
+		else if (arg == "--telemetry")
+			options.publishTelemetry = true;
+		else if (arg == "--record" && i + 1 < argc)
+			options.recordPath = argv[++i];
+		else if (arg == "--replay" && i + 1 < argc)
+			options.replayPath = argv[++i];
+		else if (arg == "--flight-seconds" && i + 1 < argc)
+		{
+			options.flightRecorderSeconds = static_cast<uint32_t>(std::stoul(argv[++i]));
+			hasFlightSeconds = true;
+		}
+		else if (arg == "--hitch-ms" && i + 1 < argc)
+			options.hitchDumpMs = std::stof(argv[++i]);
+		else if (arg == "--autoplay")
+			options.autoplay = true;
+		else if (arg == "--games" && i + 1 < argc)
+			options.autoplayGames = static_cast<uint32_t>(std::stoul(argv[++i]));
+		else if (arg == "--tiled-renderer")
+			options.tiledRenderer = true;
+		else if (arg == "--ccd-budget" && i + 1 < argc)
+			options.ccdIterationBudget = static_cast<uint32_t>(std::stoul(argv[++i]));
+		else if (arg == "--headless")
+		{
+			options.display = DisplayMode::None;
+			options.limitFrameRate = false;
+		}
+		else if (!arg.starts_with("--") && options.levelPath.empty())
+			options.levelPath = arg;
+		else
+			throw std::invalid_argument(std::format("Unknown argument: {}", arg));
+	}
+
+	// Headless runs are soak and timing runs; they only pay for the flight recorder and its hitch dumps when asked to
+	if (options.display == DisplayMode::None && !hasFlightSeconds)
+		options.flightRecorderSeconds = 0;
+
+	if (options.endless && !options.levelPath.empty())
+		throw std::invalid_argument("Endless mode streams generated levels and cannot play a level file");
+
+	if (!options.replayPath.empty() && (!options.recordPath.empty() || !options.levelPath.empty() || options.levelSeed || options.endless))
+		throw std::invalid_argument("A replay restores its own level and cannot be combined with --record, --seed, --endless or a level file");
+
+	if (options.autoplay && !options.replayPath.empty())
+		throw std::invalid_argument("--autoplay plays live and cannot drive a replay");
+
+	if (options.autoplayGames > 0 && !options.autoplay)
+		throw std::invalid_argument("--games needs --autoplay");
+
+	// Without a window nobody can press a key
+	if (options.display == DisplayMode::None && !options.autoplay && options.replayPath.empty())
+		throw std::invalid_argument("--headless needs --autoplay or --replay");
+
+	if (options.tiledRenderer && options.display == DisplayMode::None)
+		throw std::invalid_argument("--tiled-renderer needs a display; --headless draws nothing");
+
+	if (options.ccdIterationBudget == 0)
+		throw std::invalid_argument("--ccd-budget needs at least one collision step");
+
+	// The budget changes where the ball ends up, so replays only reproduce with the one they were recorded with
+	if (options.ccdIterationBudget != GameConfig::kCcdIterationBudget && (!options.recordPath.empty() || !options.replayPath.empty()))
+		throw std::invalid_argument("--ccd-budget cannot be combined with --record or --replay");
+
+	if (options.assertNoAllocations && !AllocationTracker::kEnabled)
+		throw std::invalid_argument("--assert-no-alloc needs a build configured with ARKANOID_TRACK_ALLOCATIONS=ON");
+
+	if (options.traceFrames && !Profiler::kEnabled)
+		throw std::invalid_argument("--trace needs a build configured with ARKANOID_PROFILING=ON");
+
+	return options;
+}
 
 int main(int argc, char* argv[])
 {
 	try
 	{
-		Arkanoid arkanoid;
+		Arkanoid arkanoid(parseGameOptions(argc, argv));
 		arkanoid.run();
 	}
 	catch (const std::exception& e)
 	{
+		// Unattended runs tell a failed run from a clean one by the exit code
 		std::cerr << e.what() << '\n';
-
+		return 1;
 	}
 
 	return 0;
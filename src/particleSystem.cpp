@@ -1,50 +1,76 @@
 #include "particleSystem.hpp"
 #include "math.hpp"
 #include "gameConfig.hpp"
+#include "profiler.hpp"
+#include "vectorBatch.hpp"
 
 ParticleSystem::ParticleSystem(std::mt19937& rng)
 	: mRng(rng)
 {
+	mPositions.reserve(GameConfig::kReservedParticleCount);
+	mSizes.reserve(GameConfig::kReservedParticleCount);
+	mVelocities.reserve(GameConfig::kReservedParticleCount);
+	mColors.reserve(GameConfig::kReservedParticleCount);
+	mLifetimes.reserve(GameConfig::kReservedParticleCount);
 }
 
 void ParticleSystem::update(double deltaTime)
 {
-	for (auto& p : mParticles)
-	{
-		p.setLifetime(p.getLifetime() - static_cast<float>(deltaTime));
-		if (p.getLifetime() > 0.f)
-		{
-			p.setPosition(p.getPosition() + p.getDirection() * p.getSpeed() * static_cast<float>(deltaTime));
-			p.setSize(p.getSize() * (1.f - static_cast<float>(deltaTime)));
-		}
-	}
+	PROFILE_ZONE("ParticleSystem::update");
+
+	const float dt = static_cast<float>(deltaTime);
+	const float shrink = 1.f - dt;
+
+	VectorBatch::multiplyAdd(mPositions, mVelocities, dt, mPositions);
+	VectorBatch::scale(mSizes, shrink, mSizes);
 
-	mTempBuffer.clear();
-	for (const auto& p : mParticles)
+	// Compact surviving particles in place, keeping their order
+	size_t alive = 0;
+	for (size_t i = 0; i < mLifetimes.size(); ++i)
 	{
-		if (p.getLifetime() > 0.f)
-			mTempBuffer.push_back(p);
+		const float lifetime = mLifetimes[i] - dt;
+		if (lifetime <= 0.f)
+			continue;
+
+		mPositions[alive] = mPositions[i];
+		mSizes[alive] = mSizes[i];
+		mVelocities[alive] = mVelocities[i];
+		mColors[alive] = mColors[i];
+		mLifetimes[alive] = lifetime;
+		alive++;
 	}
-	std::swap(mParticles, mTempBuffer);
+
+	mPositions.resize(alive);
+	mSizes.resize(alive);
+	mVelocities.resize(alive);
+	mColors.resize(alive);
+	mLifetimes.resize(alive);
 }
 
 void ParticleSystem::render(const Renderer& renderer) const
 {
-	for (const auto& p : mParticles)
-		p.render(renderer);
+	for (size_t i = 0; i < mPositions.size(); ++i)
+	{
+		const Vector2 halfSize = 0.5f * mSizes[i];
+		renderer.queueFilledRectangle({ mPositions[i] - halfSize, mPositions[i] + halfSize }, mColors[i]);
+	}
+	renderer.flushQueue();
 }
 
-void ParticleSystem::emitFromBlock(const Block& block)
+void ParticleSystem::emitFromBlock(const AABB& block, const SDL_Color& color)
 {
+	const Vector2 blockPosition = 0.5f * (block.min + block.max);
+	const Vector2 blockSize = block.max - block.min;
+
 	std::uniform_real_distribution rnd(0.f, 1.f);
 	for (uint32_t i = 0; i < GameConfig::kParticlesPerBlock; ++i)
 	{
 		float lifetime = 1.f + rnd(mRng) * 2.f;
-		Vector2 pos = block.getPosition() + randomPointInRectangle(block.getSize(), { rnd(mRng), rnd(mRng) });
+		Vector2 pos = blockPosition + randomPointInRectangle(blockSize, { rnd(mRng), rnd(mRng) });
 		Vector2 dir = { 0.f, 1.f };
 		Vector2 size = Vector2{ 2.f } + rnd(mRng) * Vector2 { 4.f };
 		float speed = 100.f + rnd(mRng) * 100.f;
-		mParticles.emplace_back(pos, size, block.getColor(), speed, dir, lifetime);
+		spawn(pos, size, color, dir * speed, lifetime);
 	}
 }
 
@@ -53,7 +79,7 @@ void ParticleSystem::emitFromBall(const Ball& ball)
 	std::uniform_real_distribution rnd(0.f, 1.f);
 	float lifetime = 0.5f + rnd(mRng) * 0.5f;
 	Vector2 pos = ball.getPosition() + randomPointInCircle(ball.getRadius(), { rnd(mRng), rnd(mRng) });
-	mParticles.emplace_back(pos, Vector2{ 4.f }, ball.getColor(), ball.getSpeed() * 0.1f, ball.getDirection(), lifetime);
+	spawn(pos, Vector2{ 4.f }, ball.getColor(), ball.getDirection() * (ball.getSpeed() * 0.1f), lifetime);
 }
 
 void ParticleSystem::emitFromPlatform(const Platform& platform)
@@ -65,5 +91,19 @@ void ParticleSystem::emitFromPlatform(const Platform& platform)
 	float lifetime = 0.1f + rnd(mRng) * 0.5f;
 	Vector2 pos = platform.getPosition() + randomPointInRectangle(platform.getSize(), { rnd(mRng), rnd(mRng) });
 	float speed = platform.getSpeed() * 0.1f;
-	mParticles.emplace_back(pos, Vector2{ 2.f }, platform.getColor(), speed, platform.getDirection(), lifetime);
+	spawn(pos, Vector2{ 2.f }, platform.getColor(), normalize(platform.getDirection()) * speed, lifetime);
+}
+
+size_t ParticleSystem::getParticleCount() const
+{
+	return mLifetimes.size();
+}
+
+void ParticleSystem::spawn(const Vector2& position, const Vector2& size, const SDL_Color& color, const Vector2& velocity, float lifetime)
+{
+	mPositions.push_back(position);
+	mSizes.push_back(size);
+	mVelocities.push_back(velocity);
+	mColors.push_back(color);
+	mLifetimes.push_back(lifetime);
 }
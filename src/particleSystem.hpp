@@ -2,12 +2,12 @@
 
 #include <vector>
 #include <random>
-#include "particle.hpp"
 #include "block.hpp"
 #include "ball.hpp"
 #include "platform.hpp"
 #include "renderer.hpp"
 
+// Particles are stored as dense component arrays; update and render iterate them linearly.
 class ParticleSystem
 {
 public:
@@ -17,14 +17,21 @@ public:
 
 	void render(const Renderer& renderer) const;
 
-	void emitFromBlock(const Block& block);
+	void emitFromBlock(const AABB& block, const SDL_Color& color);
 
 	void emitFromBall(const Ball& ball);
 
 	void emitFromPlatform(const Platform& platform);
 
+	size_t getParticleCount() const;
+
 private:
-	std::vector<Particle> mParticles;
-	std::vector<Particle> mTempBuffer;
+	void spawn(const Vector2& position, const Vector2& size, const SDL_Color& color, const Vector2& velocity, float lifetime);
+
+	std::vector<Vector2> mPositions;
+	std::vector<Vector2> mSizes;
+	std::vector<Vector2> mVelocities;
+	std::vector<SDL_Color> mColors;
+	std::vector<float> mLifetimes;
 	std::mt19937& mRng;
 };
@@ -0,0 +1,113 @@
+#include "perfOverlay.hpp"
+
+#include <algorithm>
+#include <format>
+
+#include "color.hpp"
+
+namespace PerfOverlayConfig
+{
+	inline constexpr Vector2 kPanelPos = { 20.f, 430.f };
+	inline constexpr Vector2 kPanelSize = { 260.f, 200.f };
+	inline constexpr Vector2 kGraphPos = { 30.f, 440.f };
+	inline constexpr Vector2 kGraphSize = { 240.f, 60.f };
+	inline constexpr float kGraphMaxMs = 33.3f; // Two frame budgets
+	inline constexpr float kBudgetMs = 1000.f / 60.f;
+	inline constexpr Vector2 kTextPos = { 30.f, 510.f };
+	inline constexpr float kLineSpacing = 22.f;
+	inline constexpr float kTextScale = 0.75f;
+	inline constexpr SDL_Color kPanelColor = { 20, 20, 30, 255 };
+}
+
+PerfOverlay::PerfOverlay(const Renderer& renderer)
+	: mRenderer(renderer)
+{
+}
+
+void PerfOverlay::toggle()
+{
+	mIsVisible = !mIsVisible;
+}
+
+bool PerfOverlay::isVisible() const
+{
+	return mIsVisible;
+}
+
+void PerfOverlay::record(const PerfFrameStats& stats)
+{
+	mFrameTimes[mNextHistoryIndex] = stats.frameMs;
+	mNextHistoryIndex = (mNextHistoryIndex + 1) % kHistoryLength;
+
+	mWindowSum.frameMs += stats.frameMs;
+	for (size_t i = 0; i < stats.phaseMs.size(); ++i)
+		mWindowSum.phaseMs[i] += stats.phaseMs[i];
+	mWindowSum.particleCount += stats.particleCount;
+	mWindowSum.blockCount += stats.blockCount;
+	mWindowSum.ccdIterations += stats.ccdIterations;
+	mWindowSum.drawCalls += stats.drawCalls;
+	mWindowMaxFrameMs = std::max(mWindowMaxFrameMs, stats.frameMs);
+
+	if (++mWindowFrameCount < kTextRefreshFrames)
+		return;
+
+	if (mIsVisible)
+		formatText();
+
+	mWindowSum = {};
+	mWindowMaxFrameMs = 0.f;
+	mWindowFrameCount = 0;
+}
+
+void PerfOverlay::render() const
+{
+	using namespace PerfOverlayConfig;
+
+	mRenderer.queueFilledRectangle({ kPanelPos, kPanelPos + kPanelSize }, kPanelColor);
+
+	// Oldest frame on the left
+	const float barWidth = kGraphSize.x / static_cast<float>(kHistoryLength);
+	const float graphBottom = kGraphPos.y + kGraphSize.y;
+	for (size_t i = 0; i < kHistoryLength; ++i)
+	{
+		const float frameMs = mFrameTimes[(mNextHistoryIndex + i) % kHistoryLength];
+		const float height = std::min(frameMs / kGraphMaxMs, 1.f) * kGraphSize.y;
+		const float x = kGraphPos.x + static_cast<float>(i) * barWidth;
+		const SDL_Color& color = frameMs <= kBudgetMs ? Color::Green : (frameMs <= kGraphMaxMs ? Color::Yellow : Color::Red);
+		mRenderer.queueFilledRectangle({ { x, graphBottom - height }, { x + barWidth, graphBottom } }, color);
+	}
+
+	const float budgetY = graphBottom - kBudgetMs / kGraphMaxMs * kGraphSize.y;
+	mRenderer.queueFilledRectangle({ { kGraphPos.x, budgetY }, { kGraphPos.x + kGraphSize.x, budgetY + 1.f } }, Color::White);
+	mRenderer.flushQueue();
+
+	for (size_t i = 0; i < kLineCount; ++i)
+	{
+		const Vector2 position = { kTextPos.x, kTextPos.y + static_cast<float>(i) * kLineSpacing };
+		mRenderer.queueAtlasText({ mLines[i].data(), mLineLengths[i] }, position, Color::White, kTextScale);
+	}
+	mRenderer.flushTextQueue();
+}
+
+void PerfOverlay::formatText()
+{
+	const float frames = static_cast<float>(mWindowFrameCount);
+	auto phaseMs = [&](FramePhase phase) { return mWindowSum.phaseMs[static_cast<size_t>(phase)] / frames; };
+
+	auto line = [this](size_t index) { return mLines[index].data(); };
+	auto setLength = [this](size_t index, std::ptrdiff_t length)
+	{
+		mLineLengths[index] = std::min(static_cast<size_t>(length), kLineCapacity);
+	};
+
+	setLength(0, std::format_to_n(line(0), kLineCapacity, "frame {:5.2f} ms  max {:5.2f}",
+		mWindowSum.frameMs / frames, mWindowMaxFrameMs).size);
+	setLength(1, std::format_to_n(line(1), kLineCapacity, "events {:4.2f}  update {:4.2f}",
+		phaseMs(FramePhase::Events), phaseMs(FramePhase::Update)).size);
+	setLength(2, std::format_to_n(line(2), kLineCapacity, "render {:4.2f}  ui {:4.2f}",
+		phaseMs(FramePhase::Render), phaseMs(FramePhase::UI)).size);
+	setLength(3, std::format_to_n(line(3), kLineCapacity, "particles {}  blocks {}",
+		mWindowSum.particleCount / mWindowFrameCount, mWindowSum.blockCount / mWindowFrameCount).size);
+	setLength(4, std::format_to_n(line(4), kLineCapacity, "ccd/tick {:.1f}  draws {}",
+		static_cast<float>(mWindowSum.ccdIterations) / frames, mWindowSum.drawCalls / mWindowFrameCount).size);
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "allocationTracker.hpp"
+#include "renderer.hpp"
+
+struct PerfFrameStats
+{
+	float frameMs = 0.f; // CPU time of the frame, without the frame limiter wait
+	std::array<float, static_cast<size_t>(FramePhase::Count)> phaseMs{};
+	uint32_t particleCount = 0;
+	uint32_t blockCount = 0;
+	uint32_t ccdIterations = 0;
+	uint32_t drawCalls = 0;
+};
+
+// Debug overlay with a rolling frame-time graph and per-frame counters. Recording only writes a
+// few numbers; text is formatted a few times per second into fixed buffers and drawn from the
+// renderer's glyph atlas, so the overlay costs two draw calls and never rasterizes text.
+class PerfOverlay final
+{
+public:
+	static constexpr size_t kHistoryLength = 120;
+
+	explicit PerfOverlay(const Renderer& renderer);
+
+	void toggle();
+
+	bool isVisible() const;
+
+	void record(const PerfFrameStats& stats);
+
+	void render() const;
+
+private:
+	void formatText();
+
+	static constexpr uint32_t kTextRefreshFrames = 15; // Text shows averages over this many frames
+	static constexpr size_t kLineCount = 5;
+	static constexpr size_t kLineCapacity = 48;
+
+	const Renderer& mRenderer;
+	bool mIsVisible = false;
+
+	std::array<float, kHistoryLength> mFrameTimes{};
+	size_t mNextHistoryIndex = 0;
+
+	// Sums over the current text refresh window
+	PerfFrameStats mWindowSum;
+	float mWindowMaxFrameMs = 0.f;
+	uint32_t mWindowFrameCount = 0;
+
+	std::array<std::array<char, kLineCapacity>, kLineCount> mLines{};
+	std::array<size_t, kLineCount> mLineLengths{};
+};
@@ -1,67 +1,266 @@
 #include "physics.hpp"
+#include <format>
 #include <optional>
 
 #include "collision.hpp"
+#include "profiler.hpp"
+
+namespace
+{
+	// Exact time of impact of a sphere swept into a box: the faces pushed out by the radius and a circle
+	// at every corner. Also holds for a start inside the box grown by the radius but next to a corner,
+	// which happens all the time with a platform moving in from the side.
+	std::optional<HitInfo> sweepRoundedBox(const Sphere& sphere, const Vector2& move, const AABB& box)
+	{
+		std::optional<HitInfo> best;
+		auto consider = [&](float t, const Vector2& normal)
+		{
+			if (t >= 0.f && t <= 1.f && dot(move, normal) < 0.f && (!best || t < best->t))
+				best = HitInfo{ sphere.center + move * t, normal, t };
+		};
+
+		for (int axis = 0; axis < 2; ++axis)
+		{
+			if (std::abs(move[axis]) < kEpsilon)
+				continue;
+
+			const int other = 1 - axis;
+			for (const float side : { -1.f, 1.f })
+			{
+				const float plane = side < 0.f ? box.min[axis] - sphere.radius : box.max[axis] + sphere.radius;
+				const float t = (plane - sphere.center[axis]) / move[axis];
+				const float along = sphere.center[other] + move[other] * t;
+				if (along >= box.min[other] && along <= box.max[other])
+				{
+					Vector2 normal;
+					normal[axis] = side;
+					consider(t, normal);
+				}
+			}
+		}
+
+		const float a = lengthSquared(move);
+		if (a < kEpsilon)
+			return best;
+
+		for (int corner = 0; corner < 4; ++corner)
+		{
+			const Vector2 offset = sphere.center - box.corner(corner);
+			const float b = dot(offset, move);
+			const float discriminant = b * b - a * (lengthSquared(offset) - sphere.radius * sphere.radius);
+			if (discriminant < 0.f)
+				continue;
+
+			const float t = (-b - std::sqrt(discriminant)) / a;
+			consider(t, (offset + move * t) / sphere.radius);
+		}
+		return best;
+	}
+
+	// Conservative advancement through the distance field: no box is closer than the field's clearance,
+	// so the sphere can move that far along moveVector without touching anything. True when the whole
+	// move is clear this way; false once the sphere gets near a surface, leaving the hit to the exact sweeps.
+	// Long moves grazing past boxes would take many small steps, so the walk gives up after a few.
+	bool isMoveClear(const DistanceField& field, const Sphere& sphere, const Vector2& moveVector)
+	{
+		constexpr float kNearSurface = 1.f;
+		constexpr uint32_t kMaxSamples = 4;
+
+		const float moveLength = length(moveVector);
+		float traveled = 0.f;
+		for (uint32_t sample = 0; sample < kMaxSamples; ++sample)
+		{
+			const float clearance = field.getClearance(sphere.center + moveVector * (traveled / std::max(moveLength, kEpsilon))) - sphere.radius;
+			if (clearance >= moveLength - traveled)
+				return true;
+			if (clearance < kNearSurface)
+				return false;
+			traveled += clearance;
+		}
+		return false;
+	}
+
+	// Where a sphere overlapping the box leaves it along the shallowest direction, or nothing if it does not overlap.
+	// Reported as a hit at t = 0.
+	std::optional<HitInfo> exitOverlap(const Sphere& sphere, const AABB& box)
+	{
+		const Vector2 closest{ std::clamp(sphere.center.x, box.min.x, box.max.x), std::clamp(sphere.center.y, box.min.y, box.max.y) };
+		const Vector2 offset = sphere.center - closest;
+		const float distanceSquared = lengthSquared(offset);
+		if (distanceSquared >= sphere.radius * sphere.radius)
+			return std::nullopt;
+
+		Vector2 normal;
+		if (distanceSquared > kEpsilon)
+			normal = offset / std::sqrt(distanceSquared);
+		else
+		{
+			// Center inside the box: leave through the nearest face
+			const float left = sphere.center.x - box.min.x;
+			const float right = box.max.x - sphere.center.x;
+			const float top = sphere.center.y - box.min.y;
+			const float bottom = box.max.y - sphere.center.y;
+			const float nearest = std::min({ left, right, top, bottom });
+			normal = nearest == top ? Vector2{ 0.f, -1.f } : nearest == bottom ? Vector2{ 0.f, 1.f } : nearest == left ? Vector2{ -1.f, 0.f } : Vector2{ 1.f, 0.f };
+		}
+
+		// Distance from the surface along the normal; for a center inside the box that is a face, for one outside the closest point
+		const Vector2 surface = distanceSquared > kEpsilon ? closest : Vector2{
+			normal.x < 0.f ? box.min.x : normal.x > 0.f ? box.max.x : sphere.center.x,
+			normal.y < 0.f ? box.min.y : normal.y > 0.f ? box.max.y : sphere.center.y
+		};
+		return HitInfo{ surface + normal * sphere.radius, normal, 0.f };
+	}
+
+	// Sphere already overlapping the box at the start of a sweep, which the ray test cannot see. A hit at
+	// t = 0 with the center pushed out, unless it is moving out anyway.
+	std::optional<HitInfo> resolveOverlap(const Sphere& sphere, const Vector2& moveVector, const AABB& box)
+	{
+		std::optional<HitInfo> hit = exitOverlap(sphere, box);
+		if (hit && dot(moveVector, hit->normal) >= 0.f)
+			return std::nullopt;
+		return hit;
+	}
+}
+
+std::optional<HitInfo> Physics::intersectMovingPlatform(const Sphere& sphere, const Vector2& moveVector, const AABB& platform, const Vector2& platformMove)
+{
+	// A sweep from inside would find the far side of the box, so an overlap is resolved on its own
+	const Vector2 relativeMove = moveVector - platformMove;
+	const Vector2 closest{ std::clamp(sphere.center.x, platform.min.x, platform.max.x), std::clamp(sphere.center.y, platform.min.y, platform.max.y) };
+	std::optional<HitInfo> hit = lengthSquared(sphere.center - closest) < sphere.radius * sphere.radius
+		? resolveOverlap(sphere, relativeMove, platform)
+		: sweepRoundedBox(sphere, relativeMove, platform);
+	if (!hit)
+		return std::nullopt;
+
+	// The platform has moved on by the time of impact, and the ball with it
+	hit->intersection += platformMove * hit->t;
+	return hit;
+}
+
+Vector2 Physics::reflectOffMovingPlatform(const Vector2& moveVector, const Vector2& platformMove, const Vector2& normal)
+{
+	Vector2 relative = moveVector - platformMove;
+	if (dot(relative, normal) < 0.f)
+		relative = reflect(relative, normal);
+
+	const Vector2 velocity = relative + platformMove;
+	return lengthSquared(velocity) > kEpsilon ? normalize(velocity) : normal;
+}
+
+std::optional<HitInfo> Physics::intersectStaticBox(const Sphere& sphere, const Vector2& moveVector, const AABB& box)
+{
+	// Most boxes are nowhere near the sweep
+	const Vector2 reach{ sphere.radius, sphere.radius };
+	const Vector2 sweepMin = Vector2{ std::min(sphere.center.x, sphere.center.x + moveVector.x), std::min(sphere.center.y, sphere.center.y + moveVector.y) } - reach;
+	const Vector2 sweepMax = Vector2{ std::max(sphere.center.x, sphere.center.x + moveVector.x), std::max(sphere.center.y, sphere.center.y + moveVector.y) } + reach;
+	if (sweepMax.x < box.min.x || sweepMin.x > box.max.x || sweepMax.y < box.min.y || sweepMin.y > box.max.y)
+		return std::nullopt;
+
+	const Vector2 closest{ std::clamp(sphere.center.x, box.min.x, box.max.x), std::clamp(sphere.center.y, box.min.y, box.max.y) };
+	return lengthSquared(sphere.center - closest) < sphere.radius * sphere.radius
+		? resolveOverlap(sphere, moveVector, box)
+		: sweepRoundedBox(sphere, moveVector, box);
+}
+
+void Physics::resolveStuckBall(Vector2& position, Vector2& direction, float radius, const std::optional<AABB>& platform, std::span<const AABB> staticBoxes)
+{
+	constexpr float pushOut = 0.001f;
+
+	// Nothing can push back against the platform, so a ball it caught is scooped up, at least 45 degrees upwards
+	if (platform && exitOverlap({ position, radius }, *platform))
+	{
+		position.y = platform->min.y - radius - pushOut;
+		direction = normalize(Vector2{ direction.x, -std::max(std::abs(direction.y), std::abs(direction.x)) });
+	}
+
+	for (const AABB& box : staticBoxes)
+	{
+		if (const std::optional<HitInfo> exit = exitOverlap({ position, radius }, box))
+		{
+			position = exit->intersection + exit->normal * pushOut;
+			if (dot(direction, exit->normal) < 0.f)
+				direction = reflect(direction, exit->normal);
+		}
+	}
+}
+
+void Physics::resolveStuckBall(Ball& ball, const CollisionContext& collisionContext)
+{
+	Vector2 position = ball.getPosition();
+	Vector2 direction = ball.getDirection();
+	resolveStuckBall(position, direction, ball.getRadius(), collisionContext.platform, collisionContext.walls);
+	resolveStuckBall(position, direction, ball.getRadius(), std::nullopt, collisionContext.blockAABBs);
+	ball.setPosition(position);
+	ball.setDirection(direction);
+}
 
 PhysicsHitResult Physics::simulateBallStep(
 	const Ball& ball,
 	const Vector2& moveVector,
 	const Vector2& currentPosition,
-	const CollisionContext& collisionContext)
+	const CollisionContext& collisionContext,
+	float remainingTickFraction)
 {
+	PROFILE_ZONE("Physics::simulateBallStep");
+
 	// Test swept-sphere vs. all static objects to find the closest hit
 
 	Sphere sphere{ currentPosition, ball.getRadius() };
 
 	std::optional<HitInfo> closestHit;
-	Block* hitBlock = nullptr;
+	std::optional<uint32_t> hitBlock;
 	bool hitPlatform = false;
 	bool hitWall = false;
 
-	// Walls
-	for (const Wall* wall : collisionContext.walls)
+	// A distance field lets moves through open space skip the walls and blocks entirely
+	if (!collisionContext.distanceField || !isMoveClear(*collisionContext.distanceField, sphere, moveVector))
 	{
-		if (!wall)
-			continue;
-		if (auto hit = intersectMovingSphereAABB(sphere, moveVector, wall->getAABB()); hit)
+		// Walls
+		for (const AABB& wall : collisionContext.walls)
 		{
-			if (!closestHit || lengthSquared(hit->intersection - currentPosition) < lengthSquared(closestHit->intersection - currentPosition))
+			if (auto hit = intersectStaticBox(sphere, moveVector, wall); hit)
 			{
-				closestHit = hit;
-				hitBlock = nullptr;
-				hitPlatform = false;
-				hitWall = true;
+				if (!closestHit || lengthSquared(hit->intersection - currentPosition) < lengthSquared(closestHit->intersection - currentPosition))
+				{
+					closestHit = hit;
+					hitBlock.reset();
+					hitPlatform = false;
+					hitWall = true;
+				}
 			}
 		}
-	}
-
-	// Blocks
-	for (Block* block : collisionContext.blocks)
-	{
-		if (block->isDestroyed())
-			continue;
 
-		if (auto hit = intersectMovingSphereAABB(sphere, moveVector, block->getAABB()); hit)
+		// Blocks
+		// The context only holds live blocks, so this is a straight scan over contiguous AABBs
+		const auto blockCount = static_cast<uint32_t>(collisionContext.blockAABBs.size());
+		for (uint32_t i = 0; i < blockCount; ++i)
 		{
-			if (!closestHit || lengthSquared(hit->intersection - currentPosition) < lengthSquared(closestHit->intersection - currentPosition))
+			if (auto hit = intersectStaticBox(sphere, moveVector, collisionContext.blockAABBs[i]); hit)
 			{
-				closestHit = hit;
-				hitBlock = block;
-				hitPlatform = false;
-				hitWall = false;
+				if (!closestHit || lengthSquared(hit->intersection - currentPosition) < lengthSquared(closestHit->intersection - currentPosition))
+				{
+					closestHit = hit;
+					hitBlock = i;
+					hitPlatform = false;
+					hitWall = false;
+				}
 			}
 		}
 	}
 
-	// Platform
+	// Platform, at the position it has reached at the start of this sweep and moving on from there
+	const Vector2 platformMove = collisionContext.platformDisplacement * remainingTickFraction;
 	if (collisionContext.platform)
 	{
-		if (auto hit = intersectMovingSphereAABB(sphere, moveVector, collisionContext.platform->getAABB()); hit)
+		const AABB platform{ collisionContext.platform->min - platformMove, collisionContext.platform->max - platformMove };
+		if (auto hit = intersectMovingPlatform(sphere, moveVector, platform, platformMove); hit)
 		{
 			if (!closestHit || lengthSquared(hit->intersection - currentPosition) < lengthSquared(closestHit->intersection - currentPosition))
 			{
 				closestHit = hit;
-				hitBlock = nullptr;
+				hitBlock.reset();
 				hitPlatform = true;
 				hitWall = false;
 			}
@@ -75,27 +274,56 @@ PhysicsHitResult Physics::simulateBallStep(
 			.newPosition = currentPosition + moveVector,
 			.newDirection = ball.getDirection(),
 			.traveled = 1.f,
-			.hitBlock = nullptr,
+			.hitBlock = std::nullopt,
 			.hitPlatform = false,
 			.hitWall = false
 		};
 	}
 
-	// Calculate normalized direction to impact point
+	// Push ball slightly outside the surface to avoid immediate re-collision
+	constexpr float pushOut = 0.001f;
+
+	if (hitPlatform)
+	{
+		// Bounce relative to the moving platform, then add slight influence from its movement to the reflection
+		Vector2 reflected = reflectOffMovingPlatform(moveVector, platformMove, closestHit->normal);
+		reflected = normalize(reflected + collisionContext.platformDirection * 0.001f);
+
+		// A platform moving faster than the ball along the normal carries it for the rest of the sweep,
+		// rather than hitting it again at every following step. Not into a wall though: a ball crushed
+		// there is left to the following steps and, once they run out, to resolveStuckBall.
+		Vector2 newPos = closestHit->intersection + closestHit->normal * pushOut;
+		float traveled = closestHit->t;
+		if (dot(reflected * length(moveVector) - platformMove, closestHit->normal) <= 0.f)
+		{
+			const Vector2 carried = newPos + platformMove * (1.f - closestHit->t);
+			const bool intoWall = std::ranges::any_of(collisionContext.walls,
+				[&](const AABB& wall) { return exitOverlap({ carried, sphere.radius }, wall).has_value(); });
+			if (!intoWall)
+			{
+				newPos = carried;
+				traveled = 1.f;
+			}
+		}
+
+		return PhysicsHitResult{
+			.newPosition = newPos,
+			.newDirection = reflected,
+			.traveled = traveled,
+			.hitBlock = std::nullopt,
+			.hitPlatform = true,
+			.hitWall = false
+		};
+	}
+
+	// Calculate normalized direction to impact point; an overlap resolved at t = 0 moved the ball out, not along its path
 	Vector2 rawDir = closestHit->intersection - currentPosition;
 	float rawLen = length(rawDir);
-	Vector2 dir = (rawLen > kEpsilon) ? rawDir / rawLen : ball.getDirection();
+	Vector2 dir = (rawLen > kEpsilon && closestHit->t > 0.f) ? rawDir / rawLen : ball.getDirection();
 
 	// Reflect movement vector around the hit surface normal
 	Vector2 reflected = reflect(dir, closestHit->normal);
 
-
-	// Add slight influence from moving platform to reflection
-	if (collisionContext.platform && hitPlatform)
-		reflected = normalize(reflected + collisionContext.platform->getDirection() * 0.001f);
-
-	// Push ball slightly outside the surface to avoid immediate re-collision
-	constexpr float pushOut = 0.001f;
 	Vector2 newPos = closestHit->intersection + reflected * pushOut;
 
 	return PhysicsHitResult{
@@ -107,3 +335,41 @@ PhysicsHitResult Physics::simulateBallStep(
 		.hitWall = hitWall
 	};
 }
+
+void CcdStats::record(const CcdResult& result)
+{
+	const auto bucket = std::ranges::lower_bound(kBucketLimits, result.iterations) - kBucketLimits.begin();
+	histogram[static_cast<size_t>(bucket)]++;
+	updates++;
+	iterations += result.iterations;
+	budgetExhausted += result.budgetExhausted;
+	maxIterations = std::max(maxIterations, result.iterations);
+}
+
+void CcdStats::merge(const CcdStats& other)
+{
+	for (size_t i = 0; i < histogram.size(); ++i)
+		histogram[i] += other.histogram[i];
+	updates += other.updates;
+	iterations += other.iterations;
+	budgetExhausted += other.budgetExhausted;
+	maxIterations = std::max(maxIterations, other.maxIterations);
+}
+
+std::string CcdStats::toString() const
+{
+	const double total = static_cast<double>(std::max<uint64_t>(updates, 1));
+	std::string text = std::format("{} updates, {:.2f} iterations on average, max {}, budget exhausted {}  |",
+		updates, static_cast<double>(iterations) / total, maxIterations, budgetExhausted);
+
+	for (size_t i = 0; i < histogram.size(); ++i)
+	{
+		const uint32_t lower = i == 0 ? 0 : kBucketLimits[i - 1] + 1;
+		const std::string range = i == kBucketLimits.size() ? std::format(">{}", kBucketLimits.back())
+			: i == 0 ? std::format("<={}", kBucketLimits[i])
+			: kBucketLimits[i] == lower ? std::format("{}", lower)
+			: std::format("{}-{}", lower, kBucketLimits[i]);
+		text += std::format(" {} {:.3f}%", range, 100.0 * static_cast<double>(histogram[i]) / total);
+	}
+	return text;
+}
@@ -1,6 +1,14 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+
 #include "ball.hpp"
+#include "collision.hpp"
 #include "collisionContext.hpp"
 
 struct PhysicsHitResult
@@ -8,16 +16,107 @@ struct PhysicsHitResult
 	Vector2 newPosition;
 	Vector2 newDirection;
 	float traveled;
-	Block* hitBlock = nullptr;
+	std::optional<uint32_t> hitBlock; // Index into the context's block arrays
 	bool hitPlatform = false;
 	bool hitWall = false;
 };
 
+// Outcome of one ball update's continuous collision loop
+struct CcdResult
+{
+	uint32_t iterations = 0;
+	bool budgetExhausted = false; // Distance was left over when the iteration budget ran out
+	float droppedDistance = 0.f;  // What was left over
+};
+
+// Distribution of CCD iterations per ball update
+struct CcdStats
+{
+	// Upper bounds of the histogram buckets; the last bucket holds everything above
+	static constexpr std::array<uint32_t, 6> kBucketLimits = { 1, 2, 3, 4, 8, 16 };
+
+	std::array<uint64_t, kBucketLimits.size() + 1> histogram{};
+	uint64_t updates = 0;
+	uint64_t iterations = 0;
+	uint64_t budgetExhausted = 0;
+	uint32_t maxIterations = 0;
+
+	void record(const CcdResult& result);
+
+	void merge(const CcdStats& other);
+
+	std::string toString() const;
+};
+
 namespace Physics
 {
+	// remainingTickFraction is the share of the tick this sweep covers, which is also the share of the
+	// context's platformDisplacement still ahead. The default treats the platform as already in place.
 	PhysicsHitResult simulateBallStep(
 		const Ball& ball,
 		const Vector2& moveVector,
 		const Vector2& currentPosition,
-		const CollisionContext& collisionContext);
-}
\ No newline at end of file
+		const CollisionContext& collisionContext,
+		float remainingTickFraction = 0.f);
+
+	// Sphere swept by moveVector against a platform that moves by platformMove over the same time, tested
+	// in the platform's frame so the time of impact accounts for both motions. platform is the box at the
+	// start of the sweep; the hit point is the sphere's center at impact in world space. A sphere that
+	// already overlaps the platform and moves further into it hits at t = 0 and is pushed to its surface.
+	std::optional<HitInfo> intersectMovingPlatform(const Sphere& sphere, const Vector2& moveVector, const AABB& platform, const Vector2& platformMove);
+
+	// Unit direction after bouncing off a moving platform: the velocity relative to the platform is
+	// reflected and the platform's movement added back, as for a frictionless wall
+	Vector2 reflectOffMovingPlatform(const Vector2& moveVector, const Vector2& platformMove, const Vector2& normal);
+
+	// Hit of a sphere swept against a static box, including a start touching or overlapping the box,
+	// which a plain swept test lets the sphere slip through.
+	std::optional<HitInfo> intersectStaticBox(const Sphere& sphere, const Vector2& moveVector, const AABB& box);
+
+	// Last resort once a ball update ran out of iterations, typically for a ball crushed between the platform
+	// and a wall: lifts a ball overlapping the platform onto it and sends it upwards, then pushes it out of
+	// every static box it overlaps
+	void resolveStuckBall(Vector2& position, Vector2& direction, float radius, const std::optional<AABB>& platform, std::span<const AABB> staticBoxes);
+	void resolveStuckBall(Ball& ball, const CollisionContext& collisionContext);
+
+	// Moves the ball by distance over one tick, one simulateBallStep per contact, and calls onHit with
+	// every bounce. Grazing and wedged contacts can shrink the steps without bound, so after iterationBudget
+	// steps the rest of the distance is dropped and the ball resolved with resolveStuckBall.
+	template <typename OnHit>
+	CcdResult moveBall(Ball& ball, float distance, const CollisionContext& collisionContext, uint32_t iterationBudget, OnHit&& onHit)
+	{
+		CcdResult result;
+		float remainingDistance = distance;
+		while (remainingDistance > 0.f)
+		{
+			if (result.iterations == iterationBudget)
+			{
+				result.budgetExhausted = true;
+				result.droppedDistance = remainingDistance;
+				resolveStuckBall(ball, collisionContext);
+				break;
+			}
+			result.iterations++;
+
+			const PhysicsHitResult hit = simulateBallStep(
+				ball,
+				ball.getDirection() * remainingDistance,
+				ball.getPosition(),
+				collisionContext,
+				remainingDistance / distance);
+
+			ball.setPosition(hit.newPosition);
+			ball.setDirection(hit.newDirection);
+
+			// Reduce remaining distance by how far the ball moved before the collision (fractional)
+			remainingDistance -= hit.traveled * remainingDistance;
+			remainingDistance = std::max(remainingDistance, 0.f); // avoid negative values
+
+			if (!hit.hitBlock && !hit.hitPlatform && !hit.hitWall)
+				break;
+
+			onHit(hit);
+		}
+		return result;
+	}
+}
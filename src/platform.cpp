@@ -1,11 +1,12 @@
 #include "platform.hpp"
 
+#include "gameConfig.hpp"
 #include "math.hpp"
 
 Platform::Platform(const Vector2& position, const Vector2& size, const SDL_Color& color)
 	: DynamicGameObject(position, color), mSize(size)
 {
-	mSpeed = 500.f;
+	mSpeed = GameConfig::kPlatformSpeed;
 }
 
 void Platform::render(const Renderer& renderer) const
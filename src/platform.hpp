@@ -16,11 +16,11 @@ class Platform final : public DynamicGameObject
 public:
 	Platform(const Vector2& position, const Vector2& size, const SDL_Color& color);
 
-	void render(const Renderer& renderer) const override;
+	void render(const Renderer& renderer) const;
 
 	void handleInput(const MoveDirection& moveDirection);
 
-	AABB getAABB() const override;
+	AABB getAABB() const;
 
 	const Vector2& getSize() const;
 
@@ -0,0 +1,161 @@
+#include "playfield.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cstring>
+#include <stdexcept>
+
+BlockArrays& Playfield::resetStatic(size_t blockCount)
+{
+	mGenerator.reset();
+	// A finite level only uses the first slot
+	resetHitPoints(0);
+	mHitPoints.resize(blockCount);
+
+	PlayfieldChunk& chunk = mChunks[0];
+	chunk.index = 0;
+	chunk.top = -FLT_MAX;
+	chunk.bottom = FLT_MAX;
+	chunk.isResident = true;
+	chunk.blocks.reset(mHitPoints);
+	return chunk.blocks;
+}
+
+void Playfield::resetEndless(const LevelGenConfig& config)
+{
+	mGenerator.emplace(config);
+	mNextChunkIndex = 0;
+
+	// Size every slot up front so streaming never reallocates
+	const size_t blocksPerChunk = static_cast<size_t>(config.grid.columns) * kChunkRows;
+	resetHitPoints(blocksPerChunk);
+	mGeneratedBlocks.reserve(blocksPerChunk);
+}
+
+void Playfield::update(float viewTop, float viewBottom)
+{
+	if (!mGenerator)
+		return;
+
+	for (auto& chunk : mChunks)
+	{
+		if (chunk.isResident && chunk.top >= viewBottom)
+			chunk.isResident = false;
+	}
+
+	const float streamTop = viewTop - getChunkHeight();
+	while (getChunkBottom(mNextChunkIndex) > streamTop)
+	{
+		auto freeSlot = std::ranges::find(mChunks, false, &PlayfieldChunk::isResident);
+		if (freeSlot == mChunks.end())
+			break;
+
+		loadChunk(*freeSlot, mNextChunkIndex++);
+	}
+}
+
+bool Playfield::isEndless() const
+{
+	return mGenerator.has_value();
+}
+
+size_t Playfield::getResidentChunkCount() const
+{
+	return static_cast<size_t>(std::ranges::count(mChunks, true, &PlayfieldChunk::isResident));
+}
+
+PlayfieldChunk& Playfield::getChunk(uint32_t slot)
+{
+	return mChunks[slot];
+}
+
+const PlayfieldChunk& Playfield::getChunk(uint32_t slot) const
+{
+	return mChunks[slot];
+}
+
+std::span<const uint8_t> Playfield::getHitPoints() const
+{
+	return mHitPoints;
+}
+
+void Playfield::saveState(PlayfieldState& state) const
+{
+	state.levelSerial = mLevelSerial;
+	state.nextChunkIndex = mNextChunkIndex;
+	for (size_t slot = 0; slot < kMaxResidentChunks; ++slot)
+		state.chunks[slot] = { mChunks[slot].index, mChunks[slot].isResident };
+}
+
+void Playfield::restoreState(const PlayfieldState& state, std::span<const uint8_t> hitPoints)
+{
+	if (state.levelSerial != mLevelSerial || hitPoints.size() != mHitPoints.size())
+		throw std::invalid_argument("Playfield state was saved on a different level");
+
+	if (mGenerator)
+	{
+		for (size_t slot = 0; slot < kMaxResidentChunks; ++slot)
+		{
+			PlayfieldChunk& chunk = mChunks[slot];
+			const PlayfieldState::Chunk& saved = state.chunks[slot];
+			if (!saved.isResident)
+				chunk.isResident = false;
+			else if (!chunk.isResident || chunk.index != saved.index)
+				loadChunk(chunk, saved.index);
+		}
+		mNextChunkIndex = state.nextChunkIndex;
+	}
+
+	// Chunk contents are a pure function of their index, so only the hit points need copying back
+	if (!hitPoints.empty())
+		std::memcpy(mHitPoints.data(), hitPoints.data(), hitPoints.size());
+}
+
+void Playfield::resetHitPoints(size_t chunkCapacity)
+{
+	mLevelSerial++;
+	mHitPoints.assign(chunkCapacity * kMaxResidentChunks, 0);
+	for (size_t slot = 0; slot < kMaxResidentChunks; ++slot)
+	{
+		mChunks[slot].isResident = false;
+		mChunks[slot].blocks.reset(std::span(mHitPoints).subspan(slot * chunkCapacity, chunkCapacity));
+	}
+}
+
+void Playfield::loadChunk(PlayfieldChunk& chunk, int64_t index)
+{
+	const LevelGrid& grid = mGenerator->getConfig().grid;
+
+	// Generator rows count upwards through the field; rows inside a chunk still run top to bottom
+	const auto firstRow = static_cast<uint32_t>(index * kChunkRows);
+	mGeneratedBlocks.clear();
+	mGenerator->generateRows(firstRow, kChunkRows, mGeneratedBlocks);
+
+	chunk.index = index;
+	chunk.bottom = getChunkBottom(index);
+	chunk.top = chunk.bottom - getChunkHeight();
+	chunk.isResident = true;
+	chunk.blocks.clear();
+
+	for (const LevelBlock& levelBlock : mGeneratedBlocks)
+	{
+		// Block rows are 16 bit and wrap in very long sessions; the difference to the first row does not
+		const auto localRow = static_cast<uint16_t>(levelBlock.row - static_cast<uint16_t>(firstRow));
+		const Vector2 position = {
+			grid.origin.x + (static_cast<float>(levelBlock.column) + 0.5f) * grid.cellSize.x,
+			chunk.top + (static_cast<float>(localRow) + 0.5f) * grid.cellSize.y
+		};
+		chunk.blocks.add(position, grid.cellSize, levelBlock.type, levelBlock.hitPoints);
+	}
+}
+
+float Playfield::getChunkHeight() const
+{
+	return static_cast<float>(kChunkRows) * mGenerator->getConfig().grid.cellSize.y;
+}
+
+float Playfield::getChunkBottom(int64_t index) const
+{
+	const float fieldBottom = mGenerator->getConfig().grid.origin.y + getChunkHeight();
+	return fieldBottom - static_cast<float>(index) * getChunkHeight();
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "block.hpp"
+#include "levelGenerator.hpp"
+
+// A horizontal band of the block field. World y grows downwards, so endless chunks with higher
+// indices lie further up.
+struct PlayfieldChunk
+{
+	int64_t index = 0;
+	float top = 0.f;
+	float bottom = 0.f;
+	bool isResident = false;
+	BlockArrays blocks;
+};
+
+// Identifies a block by chunk slot and index inside the chunk's arrays
+struct BlockHandle
+{
+	uint32_t chunk = 0;
+	uint32_t index = 0;
+};
+
+struct PlayfieldState;
+
+// Owns all blocks of the current level, split into chunks. A finite level is a single chunk.
+// An endless field streams chunks in ahead of the view and evicts them once they scrolled out
+// below it, reusing a fixed set of chunk slots so memory stays bounded.
+class Playfield final
+{
+public:
+	static constexpr uint32_t kChunkRows = 10;
+	static constexpr size_t kMaxResidentChunks = 6;
+
+	// Starts a finite level. Returns the storage of its chunk, reserved for blockCount blocks.
+	BlockArrays& resetStatic(size_t blockCount);
+
+	// Starts an endless field extending upwards from the bottom of the first kChunkRows rows of the grid
+	void resetEndless(const LevelGenConfig& config);
+
+	// Evicts chunks below the view and streams in chunks up to one chunk above it
+	void update(float viewTop, float viewBottom);
+
+	bool isEndless() const;
+
+	size_t getResidentChunkCount() const;
+
+	PlayfieldChunk& getChunk(uint32_t slot);
+
+	const PlayfieldChunk& getChunk(uint32_t slot) const;
+
+	// Hit points of every chunk slot in one contiguous buffer, the only block data that changes during play
+	std::span<const uint8_t> getHitPoints() const;
+
+	void saveState(PlayfieldState& state) const;
+
+	// Restores a state saved on the current level; endless chunks it had resident are regenerated if evicted since.
+	// Throws std::invalid_argument for states and hit points of another level.
+	void restoreState(const PlayfieldState& state, std::span<const uint8_t> hitPoints);
+
+	// Calls fn(uint32_t slot, PlayfieldChunk& chunk) for every resident chunk
+	template <typename Fn>
+	void forEachChunk(Fn&& fn)
+	{
+		for (uint32_t slot = 0; slot < kMaxResidentChunks; ++slot)
+		{
+			if (mChunks[slot].isResident)
+				fn(slot, mChunks[slot]);
+		}
+	}
+
+	template <typename Fn>
+	void forEachChunk(Fn&& fn) const
+	{
+		for (uint32_t slot = 0; slot < kMaxResidentChunks; ++slot)
+		{
+			if (mChunks[slot].isResident)
+				fn(slot, mChunks[slot]);
+		}
+	}
+
+private:
+	void loadChunk(PlayfieldChunk& chunk, int64_t index);
+
+	float getChunkHeight() const;
+
+	float getChunkBottom(int64_t index) const;
+
+	void resetHitPoints(size_t chunkCapacity);
+
+	std::array<PlayfieldChunk, kMaxResidentChunks> mChunks;
+	std::vector<uint8_t> mHitPoints; // Chunk slot i owns the range starting at i * chunk capacity
+	std::optional<LevelGenerator> mGenerator;
+	std::vector<LevelBlock> mGeneratedBlocks;
+	int64_t mNextChunkIndex = 0; // Lowest endless chunk that has not been streamed in yet
+	uint64_t mLevelSerial = 0; // Counts level resets so snapshots of other levels are rejected
+};
+
+// Chunk placement of a playfield besides its block hit points, trivially copyable for snapshots
+struct PlayfieldState
+{
+	struct Chunk
+	{
+		int64_t index = 0;
+		bool isResident = false;
+	};
+
+	uint64_t levelSerial = 0;
+	int64_t nextChunkIndex = 0;
+	std::array<Chunk, Playfield::kMaxResidentChunks> chunks{};
+};
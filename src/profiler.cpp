@@ -0,0 +1,143 @@
+#include "profiler.hpp"
+
+#ifdef ARKANOID_PROFILING
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+	struct ZoneEvent
+	{
+		const char* name;
+		uint64_t startNs;
+		uint64_t endNs;
+		uint64_t frame;
+	};
+
+	// Written only by its own thread; the write index is published for the exporter
+	struct ThreadRing
+	{
+		const char* name = nullptr;
+		uint32_t threadId = 0;
+		std::atomic<uint64_t> writeIndex{ 0 };
+		std::array<ZoneEvent, Profiler::kRingCapacity> events;
+	};
+
+	// Rings outlive their threads so traces still include workers that have exited
+	std::mutex gRingsMutex;
+	std::vector<std::unique_ptr<ThreadRing>> gRings;
+
+	std::atomic<uint64_t> gCurrentFrame{ 0 };
+	const auto gStartTime = std::chrono::steady_clock::now();
+
+	thread_local ThreadRing* tRing = nullptr;
+
+	ThreadRing& getThreadRing()
+	{
+		if (!tRing)
+		{
+			std::scoped_lock lock(gRingsMutex);
+			auto ring = std::make_unique<ThreadRing>();
+			ring->threadId = static_cast<uint32_t>(gRings.size());
+			tRing = ring.get();
+			gRings.push_back(std::move(ring));
+		}
+		return *tRing;
+	}
+
+	void writeJsonString(std::ofstream& out, const char* text)
+	{
+		out << '"';
+		for (const char* c = text; *c; ++c)
+		{
+			if (*c == '"' || *c == '\\')
+				out << '\\';
+			out << *c;
+		}
+		out << '"';
+	}
+}
+
+uint64_t Profiler::getTimeNs()
+{
+	using namespace std::chrono;
+	return static_cast<uint64_t>(duration_cast<nanoseconds>(steady_clock::now() - gStartTime).count());
+}
+
+void Profiler::recordZone(const char* name, uint64_t startNs, uint64_t endNs)
+{
+	ThreadRing& ring = getThreadRing();
+	const uint64_t index = ring.writeIndex.load(std::memory_order_relaxed);
+	ring.events[index % kRingCapacity] = { name, startNs, endNs, gCurrentFrame.load(std::memory_order_relaxed) };
+	ring.writeIndex.store(index + 1, std::memory_order_release);
+}
+
+void Profiler::setThreadName(const char* name)
+{
+	getThreadRing().name = name;
+}
+
+void Profiler::beginFrame(uint64_t frameIndex)
+{
+	gCurrentFrame.store(frameIndex, std::memory_order_relaxed);
+}
+
+bool Profiler::writeChromeTrace(const std::string& path, uint64_t firstFrame, uint64_t lastFrame)
+{
+	std::ofstream out(path);
+	if (!out)
+		return false;
+
+	std::scoped_lock lock(gRingsMutex);
+
+	out << std::fixed << std::setprecision(3);
+	out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	bool isFirst = true;
+	auto separate = [&]
+	{
+		if (!isFirst)
+			out << ",\n";
+		isFirst = false;
+	};
+
+	for (const auto& ring : gRings)
+	{
+		if (ring->name)
+		{
+			separate();
+			out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << ring->threadId << ",\"args\":{\"name\":";
+			writeJsonString(out, ring->name);
+			out << "}}";
+		}
+
+		const uint64_t end = ring->writeIndex.load(std::memory_order_acquire);
+		const uint64_t begin = end > kRingCapacity ? end - kRingCapacity : 0;
+		for (uint64_t i = begin; i < end; ++i)
+		{
+			const ZoneEvent& event = ring->events[i % kRingCapacity];
+			if (event.frame < firstFrame || event.frame > lastFrame)
+				continue;
+
+			// Complete events with microsecond timestamps
+			separate();
+			out << "{\"name\":";
+			writeJsonString(out, event.name);
+			out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << ring->threadId
+				<< ",\"ts\":" << static_cast<double>(event.startNs) / 1000.0
+				<< ",\"dur\":" << static_cast<double>(event.endNs - event.startNs) / 1000.0
+				<< ",\"args\":{\"frame\":" << event.frame << "}}";
+		}
+	}
+
+	out << "]}\n";
+	return static_cast<bool>(out);
+}
+
+#endif
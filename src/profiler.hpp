@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Scoped hot-path profiler. Zones record begin and end timestamps into a ring buffer owned by the
+// recording thread, so recording takes no locks. The macros compile to nothing unless the build
+// defines ARKANOID_PROFILING. Zone and thread names must be string literals.
+//
+//   PROFILE_ZONE("Arkanoid::update");   // Times the enclosing scope
+//   PROFILE_THREAD("worker");           // Names the calling thread in exported traces
+//   PROFILE_FRAME(frameIndex);          // Tags the following zones with a frame index
+#ifdef ARKANOID_PROFILING
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) const Profiler::Zone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_THREAD(name) Profiler::setThreadName(name)
+#define PROFILE_FRAME(index) Profiler::beginFrame(index)
+
+namespace Profiler
+{
+	inline constexpr bool kEnabled = true;
+
+	// Events kept per thread; older events are overwritten
+	inline constexpr size_t kRingCapacity = 1 << 16;
+
+	uint64_t getTimeNs();
+
+	void recordZone(const char* name, uint64_t startNs, uint64_t endNs);
+
+	void setThreadName(const char* name);
+
+	void beginFrame(uint64_t frameIndex);
+
+	// Writes every zone recorded in frames [firstFrame, lastFrame] as Chrome trace_event JSON, which
+	// chrome://tracing and Perfetto open directly. Call while no other thread is recording, for
+	// example between frames. Returns false if the file could not be written.
+	bool writeChromeTrace(const std::string& path, uint64_t firstFrame, uint64_t lastFrame);
+
+	class Zone final
+	{
+	public:
+		explicit Zone(const char* name)
+			: mName(name), mStartNs(getTimeNs())
+		{
+		}
+
+		~Zone()
+		{
+			recordZone(mName, mStartNs, getTimeNs());
+		}
+
+		Zone(const Zone&) = delete;
+		Zone& operator=(const Zone&) = delete;
+
+	private:
+		const char* mName;
+		uint64_t mStartNs;
+	};
+}
+
+#else
+
+#define PROFILE_ZONE(name) ((void)0)
+#define PROFILE_THREAD(name) ((void)0)
+#define PROFILE_FRAME(index) ((void)0)
+
+namespace Profiler
+{
+	inline constexpr bool kEnabled = false;
+
+	inline bool writeChromeTrace(const std::string&, uint64_t, uint64_t) { return false; }
+}
+
+#endif
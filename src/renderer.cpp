@@ -1,8 +1,13 @@
 #include "renderer.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cstring>
 #include <filesystem>
 
-Renderer::Renderer(SDL_Window* window, const Vector2& logicalSize, const Vector2& screenSize)
+#include "profiler.hpp"
+
+Renderer::Renderer(SDL_Window* window, const Vector2& logicalSize, const Vector2& screenSize, RenderBackend backend)
 {
 	if (!TTF_Init())
 	{
@@ -15,13 +20,66 @@ Renderer::Renderer(SDL_Window* window, const Vector2& logicalSize, const Vector2
 		throw std::runtime_error(std::format("SDL_CreateRenderer Error: {}", SDL_GetError()));
 	}
 
+	if (backend == RenderBackend::Tiled)
+		mRasterizer = std::make_unique<TileRasterizer>(static_cast<int32_t>(screenSize.x), static_cast<int32_t>(screenSize.y));
+
+	initialize(logicalSize, screenSize);
+}
+
+Renderer::Renderer(SDL_Surface* target, const Vector2& logicalSize, RenderBackend backend)
+{
+	if (!TTF_Init())
+	{
+		throw std::runtime_error("TTF_Init failed.");
+	}
+
+	if (backend == RenderBackend::Tiled)
+	{
+		if (target->format != SDL_PIXELFORMAT_XRGB8888)
+			throw std::invalid_argument(std::format("The tiled renderer needs an XRGB8888 surface, got {}", SDL_GetPixelFormatName(target->format)));
+
+		// The surface is written directly, no SDL_Renderer involved
+		mTargetSurface = target;
+		mRasterizer = std::make_unique<TileRasterizer>(target->w, target->h);
+	}
+	else
+	{
+		mRenderer = SDL_CreateSoftwareRenderer(target);
+		if (!mRenderer)
+		{
+			throw std::runtime_error(std::format("SDL_CreateSoftwareRenderer Error: {}", SDL_GetError()));
+		}
+	}
+
+	initialize(logicalSize, { static_cast<float>(target->w), static_cast<float>(target->h) });
+}
+
+void Renderer::initialize(const Vector2& logicalSize, const Vector2& screenSize)
+{
 	loadFont();
 
 	setLogicalResolution(logicalSize, screenSize);
+
+	if (mRasterizer && !mTargetSurface)
+		createFrameTexture();
+
+	mQueuedVertices.reserve(kReservedQuadCount * 4);
+	mQuadIndices.reserve(kReservedQuadCount * 6);
+	mQueuedOutlines.reserve(kReservedQuadCount);
+	mQueuedOutlineColors.reserve(kReservedQuadCount);
+	mQueuedTextVertices.reserve(kReservedGlyphCount * 4);
 }
 
 Renderer::~Renderer()
 {
+	destroyGlyphAtlas();
+
+	if (mFrameTexture)
+	{
+		SDL_DestroyTexture(mFrameTexture);
+		mFrameTexture = nullptr;
+	}
+
 	if (mFont)
 	{
 		TTF_CloseFont(mFont);
@@ -39,20 +97,57 @@ Renderer::~Renderer()
 
 void Renderer::clearScreen() const
 {
+	mDrawCallCount = 0;
+	if (mRasterizer)
+	{
+		mRasterizer->clear(0xFF000000);
+		return;
+	}
+
 	SDL_SetRenderDrawColor(mRenderer, 0, 0, 0, 255);
 	SDL_RenderClear(mRenderer);
 }
 
 void Renderer::presentFrame() const
 {
-	SDL_RenderPresent(mRenderer);
+	if (mTargetSurface)
+	{
+		SDL_LockSurface(mTargetSurface);
+		mRasterizer->rasterize(static_cast<uint32_t*>(mTargetSurface->pixels), mTargetSurface->pitch / 4);
+		SDL_UnlockSurface(mTargetSurface);
+	}
+	else if (mRasterizer)
+	{
+		// Rasterize straight into the locked texture, so the frame is copied exactly once on upload
+		void* pixels = nullptr;
+		int pitch = 0;
+		if (mFrameTexture && SDL_LockTexture(mFrameTexture, nullptr, &pixels, &pitch))
+		{
+			mRasterizer->rasterize(static_cast<uint32_t*>(pixels), pitch / 4);
+			SDL_UnlockTexture(mFrameTexture);
+			SDL_RenderTexture(mRenderer, mFrameTexture, nullptr, nullptr);
+		}
+		SDL_RenderPresent(mRenderer);
+	}
+	else
+		SDL_RenderPresent(mRenderer);
+
+	mLastFrameDrawCallCount = mDrawCallCount;
 }
 
 void Renderer::drawFilledCircle(const Vector2& position, float radius, const SDL_Color& color) const
 {
+	if (mRasterizer)
+	{
+		const Vector2 center = toScreen(position);
+		mRasterizer->fillCircle(center.x, center.y, radius * mScale.x, toARGB(color));
+		mDrawCallCount++;
+		return;
+	}
+
 	constexpr int segments = 32;
-	std::vector<SDL_Vertex> vertices(segments + 1);
-	std::vector<int> indices;
+	std::array<SDL_Vertex, segments + 1> vertices{};
+	std::array<int, segments * 3> indices{};
 
 	const SDL_FColor fColor = toFColor(color);
 
@@ -74,33 +169,191 @@ void Renderer::drawFilledCircle(const Vector2& position, float radius, const SDL
 
 	for (int i = 0; i < segments; ++i)
 	{
-		indices.push_back(0);
-		indices.push_back(i + 1);
-		indices.push_back((i + 1) % segments + 1);
+		indices[i * 3] = 0;
+		indices[i * 3 + 1] = i + 1;
+		indices[i * 3 + 2] = (i + 1) % segments + 1;
 	}
 
 	SDL_RenderGeometry(mRenderer, nullptr, vertices.data(), static_cast<int>(vertices.size()),
 		indices.data(), static_cast<int>(indices.size()));
+	mDrawCallCount++;
 }
 
 void Renderer::drawRectangle(const Vector2& position, const Vector2& size, const SDL_Color& color) const
 {
-	setDrawColor(color);
 	Vector2 screenPos = toScreen(position);
 	Vector2 screenSize = size * mScale;
 
 	SDL_FRect rect{ screenPos.x - screenSize.x * 0.5f, screenPos.y - screenSize.y * 0.5f, screenSize.x, screenSize.y };
-	SDL_RenderRect(mRenderer, &rect);
+	if (mRasterizer)
+		mRasterizer->strokeRectangle(rect.x, rect.y, rect.w, rect.h, toARGB(color));
+	else
+	{
+		setDrawColor(color);
+		SDL_RenderRect(mRenderer, &rect);
+	}
+	mDrawCallCount++;
 }
 
 void Renderer::drawFilledRectangle(const Vector2& position, const Vector2& size, const SDL_Color& color) const
 {
-	setDrawColor(color);
 	Vector2 screenPos = toScreen(position);
 	Vector2 screenSize = size * mScale;
 
 	SDL_FRect rect{ screenPos.x - screenSize.x * 0.5f, screenPos.y - screenSize.y * 0.5f, screenSize.x, screenSize.y };
-	SDL_RenderFillRect(mRenderer, &rect);
+	if (mRasterizer)
+		mRasterizer->fillRectangle(rect.x, rect.y, rect.w, rect.h, toARGB(color));
+	else
+	{
+		setDrawColor(color);
+		SDL_RenderFillRect(mRenderer, &rect);
+	}
+	mDrawCallCount++;
+}
+
+void Renderer::queueFilledRectangle(const AABB& bounds, const SDL_Color& color) const
+{
+	const SDL_FRect rect = toScreenRect(bounds);
+	const SDL_FColor fColor = toFColor(color);
+
+	mQueuedVertices.push_back({ .position = { rect.x, rect.y }, .color = fColor, .tex_coord = {} });
+	mQueuedVertices.push_back({ .position = { rect.x + rect.w, rect.y }, .color = fColor, .tex_coord = {} });
+	mQueuedVertices.push_back({ .position = { rect.x + rect.w, rect.y + rect.h }, .color = fColor, .tex_coord = {} });
+	mQueuedVertices.push_back({ .position = { rect.x, rect.y + rect.h }, .color = fColor, .tex_coord = {} });
+}
+
+void Renderer::queueRectangle(const AABB& bounds, const SDL_Color& color) const
+{
+	mQueuedOutlines.push_back(toScreenRect(bounds));
+	mQueuedOutlineColors.push_back(color);
+}
+
+void Renderer::flushQueue() const
+{
+	const size_t quadCount = mQueuedVertices.size() / 4;
+	if (mRasterizer)
+	{
+		// Same order as the SDL path: all fills, then all outlines
+		for (size_t quad = 0; quad < quadCount; ++quad)
+		{
+			const SDL_Vertex& topLeft = mQueuedVertices[quad * 4];
+			const SDL_Vertex& bottomRight = mQueuedVertices[quad * 4 + 2];
+			mRasterizer->fillRectangle(topLeft.position.x, topLeft.position.y,
+				bottomRight.position.x - topLeft.position.x, bottomRight.position.y - topLeft.position.y, toARGB(topLeft.color));
+		}
+		for (size_t i = 0; i < mQueuedOutlines.size(); ++i)
+		{
+			const SDL_FRect& rect = mQueuedOutlines[i];
+			mRasterizer->strokeRectangle(rect.x, rect.y, rect.w, rect.h, toARGB(mQueuedOutlineColors[i]));
+		}
+		mDrawCallCount += static_cast<uint32_t>(quadCount + mQueuedOutlines.size());
+		mQueuedVertices.clear();
+		mQueuedOutlines.clear();
+		mQueuedOutlineColors.clear();
+		return;
+	}
+
+	if (quadCount > 0)
+	{
+		// The index pattern never changes, so it only has to grow
+		for (size_t quad = mQuadIndices.size() / 6; quad < quadCount; ++quad)
+		{
+			const int base = static_cast<int>(quad * 4);
+			mQuadIndices.insert(mQuadIndices.end(), { base, base + 1, base + 2, base, base + 2, base + 3 });
+		}
+
+		SDL_RenderGeometry(mRenderer, nullptr, mQueuedVertices.data(), static_cast<int>(mQueuedVertices.size()),
+			mQuadIndices.data(), static_cast<int>(quadCount * 6));
+		mDrawCallCount++;
+		mQueuedVertices.clear();
+	}
+
+	for (size_t runStart = 0; runStart < mQueuedOutlines.size();)
+	{
+		const SDL_Color& color = mQueuedOutlineColors[runStart];
+		size_t runEnd = runStart + 1;
+		while (runEnd < mQueuedOutlines.size() && std::memcmp(&mQueuedOutlineColors[runEnd], &color, sizeof(SDL_Color)) == 0)
+			runEnd++;
+
+		setDrawColor(color);
+		SDL_RenderRects(mRenderer, mQueuedOutlines.data() + runStart, static_cast<int>(runEnd - runStart));
+		mDrawCallCount++;
+		runStart = runEnd;
+	}
+	mQueuedOutlines.clear();
+	mQueuedOutlineColors.clear();
+}
+
+void Renderer::queueAtlasText(std::string_view text, const Vector2& position, const SDL_Color& color, float scale) const
+{
+	if (mGlyphAtlasSize.x <= 0.f)
+		return;
+
+	const SDL_FColor fColor = toFColor(color);
+	const Vector2 start = toScreen(position);
+	const float height = mGlyphAtlasSize.y * scale;
+
+	float x = start.x;
+	for (char c : text)
+	{
+		if (c < kFirstAtlasGlyph || c > kLastAtlasGlyph)
+			c = '?';
+
+		const AtlasGlyph& glyph = mAtlasGlyphs[c - kFirstAtlasGlyph];
+		const float width = glyph.width * scale;
+		const float u0 = glyph.x / mGlyphAtlasSize.x;
+		const float u1 = (glyph.x + glyph.width) / mGlyphAtlasSize.x;
+
+		mQueuedTextVertices.push_back({ .position = { x, start.y }, .color = fColor, .tex_coord = { u0, 0.f } });
+		mQueuedTextVertices.push_back({ .position = { x + width, start.y }, .color = fColor, .tex_coord = { u1, 0.f } });
+		mQueuedTextVertices.push_back({ .position = { x + width, start.y + height }, .color = fColor, .tex_coord = { u1, 1.f } });
+		mQueuedTextVertices.push_back({ .position = { x, start.y + height }, .color = fColor, .tex_coord = { u0, 1.f } });
+		x += width;
+	}
+}
+
+void Renderer::flushTextQueue() const
+{
+	const size_t quadCount = mQueuedTextVertices.size() / 4;
+	if (quadCount == 0)
+		return;
+
+	if (mRasterizer)
+	{
+		for (size_t quad = 0; quad < quadCount; ++quad)
+		{
+			const SDL_Vertex& topLeft = mQueuedTextVertices[quad * 4];
+			const SDL_Vertex& bottomRight = mQueuedTextVertices[quad * 4 + 2];
+			mRasterizer->blitGlyph(topLeft.position.x, topLeft.position.y,
+				bottomRight.position.x - topLeft.position.x, bottomRight.position.y - topLeft.position.y,
+				topLeft.tex_coord.x * mGlyphAtlasSize.x, (bottomRight.tex_coord.x - topLeft.tex_coord.x) * mGlyphAtlasSize.x,
+				toARGB(topLeft.color));
+		}
+		mDrawCallCount += static_cast<uint32_t>(quadCount);
+		mQueuedTextVertices.clear();
+		return;
+	}
+
+	for (size_t quad = mQuadIndices.size() / 6; quad < quadCount; ++quad)
+	{
+		const int base = static_cast<int>(quad * 4);
+		mQuadIndices.insert(mQuadIndices.end(), { base, base + 1, base + 2, base, base + 2, base + 3 });
+	}
+
+	SDL_RenderGeometry(mRenderer, mGlyphAtlas, mQueuedTextVertices.data(), static_cast<int>(mQueuedTextVertices.size()),
+		mQuadIndices.data(), static_cast<int>(quadCount * 6));
+	mDrawCallCount++;
+	mQueuedTextVertices.clear();
+}
+
+uint32_t Renderer::getDrawCallCount() const
+{
+	return mDrawCallCount;
+}
+
+uint32_t Renderer::getLastFrameDrawCallCount() const
+{
+	return mLastFrameDrawCallCount;
 }
 
 void Renderer::setDrawColor(const SDL_Color& color) const
@@ -108,6 +361,17 @@ void Renderer::setDrawColor(const SDL_Color& color) const
 	SDL_SetRenderDrawColor(mRenderer, color.r, color.g, color.b, color.a);
 }
 
+uint32_t Renderer::toARGB(const SDL_Color& c)
+{
+	return static_cast<uint32_t>(c.a) << 24 | static_cast<uint32_t>(c.r) << 16 | static_cast<uint32_t>(c.g) << 8 | c.b;
+}
+
+uint32_t Renderer::toARGB(const SDL_FColor& c)
+{
+	auto channel = [](float value) { return static_cast<uint32_t>(std::clamp(value, 0.f, 1.f) * 255.f + 0.5f); };
+	return channel(c.a) << 24 | channel(c.r) << 16 | channel(c.g) << 8 | channel(c.b);
+}
+
 SDL_FColor Renderer::toFColor(const SDL_Color& c)
 {
 	return SDL_FColor{
@@ -118,19 +382,40 @@ SDL_FColor Renderer::toFColor(const SDL_Color& c)
 	};
 }
 
-void Renderer::drawText(const std::string& text, const Vector2& position, const SDL_Color& color, TextAlign align) const
+void Renderer::drawText(std::string_view text, const Vector2& position, const SDL_Color& color, TextAlign align) const
 {
+	PROFILE_ZONE("Renderer::drawText");
+
 	if (!mFont || text.empty()) return;
 
-	SDL_Surface* surface = TTF_RenderText_Blended(mFont, text.c_str(), text.size(), color);
-	if (!surface) return;
+	SDL_Texture* texture = nullptr;
+	float w = 0.f;
+	float h = 0.f;
+	if (mRasterizer)
+	{
+		// Drawn from the glyph atlas, which holds the font at the current screen size
+		if (mGlyphAtlasSize.x <= 0.f) return;
+
+		for (char c : text)
+		{
+			if (c < kFirstAtlasGlyph || c > kLastAtlasGlyph)
+				c = '?';
+			w += mAtlasGlyphs[c - kFirstAtlasGlyph].width;
+		}
+		h = mGlyphAtlasSize.y;
+	}
+	else
+	{
+		SDL_Surface* surface = TTF_RenderText_Blended(mFont, text.data(), text.size(), color);
+		if (!surface) return;
+
+		texture = SDL_CreateTextureFromSurface(mRenderer, surface);
+		SDL_DestroySurface(surface);
+		if (!texture) return;
 
-	SDL_Texture* texture = SDL_CreateTextureFromSurface(mRenderer, surface);
-	SDL_DestroySurface(surface);
-	if (!texture) return;
+		SDL_GetTextureSize(texture, &w, &h);
+	}
 
-	float w, h;
-	SDL_GetTextureSize(texture, &w, &h);
 	Vector2 screenPos = toScreen(position);
 	SDL_FRect dst = { screenPos.x, screenPos.y, w, h };
 
@@ -169,8 +454,29 @@ void Renderer::drawText(const std::string& text, const Vector2& position, const
 		default: break;
 	}
 
-	SDL_RenderTexture(mRenderer, texture, nullptr, &dst);
-	SDL_DestroyTexture(texture);
+	if (mRasterizer)
+		rasterizeAtlasText(text, { dst.x, dst.y }, color);
+	else
+	{
+		SDL_RenderTexture(mRenderer, texture, nullptr, &dst);
+		SDL_DestroyTexture(texture);
+	}
+	mDrawCallCount++;
+}
+
+void Renderer::rasterizeAtlasText(std::string_view text, const Vector2& screenPosition, const SDL_Color& color) const
+{
+	const uint32_t argb = toARGB(color);
+	float x = screenPosition.x;
+	for (char c : text)
+	{
+		if (c < kFirstAtlasGlyph || c > kLastAtlasGlyph)
+			c = '?';
+
+		const AtlasGlyph& glyph = mAtlasGlyphs[c - kFirstAtlasGlyph];
+		mRasterizer->blitGlyph(x, screenPosition.y, glyph.width, mGlyphAtlasSize.y, glyph.x, glyph.width, argb);
+		x += glyph.width;
+	}
 }
 
 void Renderer::loadFont()
@@ -180,6 +486,8 @@ void Renderer::loadFont()
 	{
 		throw std::runtime_error("Failed to load font.");
 	}
+
+	buildGlyphAtlas();
 }
 
 void Renderer::setLogicalResolution(const Vector2& logicalSize, const Vector2& screenSize)
@@ -204,12 +512,129 @@ void Renderer::setLogicalResolution(const Vector2& logicalSize, const Vector2& s
 		}
 		loadFont();
 	}
+
+	if (mRasterizer && !mTargetSurface
+		&& (mRasterizer->getWidth() != static_cast<int32_t>(screenSize.x) || mRasterizer->getHeight() != static_cast<int32_t>(screenSize.y)))
+	{
+		mRasterizer->resize(static_cast<int32_t>(screenSize.x), static_cast<int32_t>(screenSize.y));
+		createFrameTexture();
+	}
+}
+
+void Renderer::createFrameTexture()
+{
+	if (mFrameTexture)
+		SDL_DestroyTexture(mFrameTexture);
+
+	mFrameTexture = SDL_CreateTexture(mRenderer, SDL_PIXELFORMAT_XRGB8888, SDL_TEXTUREACCESS_STREAMING,
+		mRasterizer->getWidth(), mRasterizer->getHeight());
+	if (!mFrameTexture)
+		throw std::runtime_error(std::format("SDL_CreateTexture Error: {}", SDL_GetError()));
+}
+
+void Renderer::setCameraPosition(const Vector2& position)
+{
+	mCameraPosition = position;
+}
+
+void Renderer::buildGlyphAtlas()
+{
+	destroyGlyphAtlas();
+
+	// Rasterize every glyph in white once; quads tint them through their vertex colors
+	constexpr SDL_Color white = { 255, 255, 255, 255 };
+	std::array<SDL_Surface*, kLastAtlasGlyph - kFirstAtlasGlyph + 1> glyphSurfaces{};
+
+	int atlasWidth = 0;
+	int atlasHeight = 0;
+	for (size_t i = 0; i < glyphSurfaces.size(); ++i)
+	{
+		const char c = static_cast<char>(kFirstAtlasGlyph + i);
+		glyphSurfaces[i] = TTF_RenderText_Blended(mFont, &c, 1, white);
+
+		// Blank glyphs such as the space may not produce a surface; they still need their advance
+		int width = 0;
+		int height = 0;
+		if (glyphSurfaces[i])
+		{
+			width = glyphSurfaces[i]->w;
+			height = glyphSurfaces[i]->h;
+		}
+		else
+			TTF_GetStringSize(mFont, &c, 1, &width, &height);
+
+		mAtlasGlyphs[i] = { .x = static_cast<float>(atlasWidth), .width = static_cast<float>(width) };
+		atlasWidth += width;
+		atlasHeight = std::max(atlasHeight, height);
+	}
+
+	SDL_Surface* atlas = atlasWidth > 0 ? SDL_CreateSurface(atlasWidth, atlasHeight, SDL_PIXELFORMAT_RGBA32) : nullptr;
+	for (size_t i = 0; i < glyphSurfaces.size(); ++i)
+	{
+		if (!glyphSurfaces[i])
+			continue;
+
+		if (atlas)
+		{
+			SDL_Rect destination = { static_cast<int>(mAtlasGlyphs[i].x), 0, glyphSurfaces[i]->w, glyphSurfaces[i]->h };
+			SDL_SetSurfaceBlendMode(glyphSurfaces[i], SDL_BLENDMODE_NONE);
+			SDL_BlitSurface(glyphSurfaces[i], nullptr, atlas, &destination);
+		}
+		SDL_DestroySurface(glyphSurfaces[i]);
+	}
+
+	if (!atlas)
+		return;
+
+	if (mRasterizer)
+	{
+		// The rasterizer tints glyphs itself and only needs their coverage
+		std::vector<uint8_t> mask(static_cast<size_t>(atlasWidth) * atlasHeight);
+		for (int y = 0; y < atlasHeight; ++y)
+		{
+			const auto* row = static_cast<const uint8_t*>(atlas->pixels) + static_cast<ptrdiff_t>(y) * atlas->pitch;
+			for (int x = 0; x < atlasWidth; ++x)
+				mask[static_cast<size_t>(y) * atlasWidth + x] = row[x * 4 + 3]; // RGBA32 keeps alpha in the fourth byte
+		}
+		mRasterizer->setGlyphAtlas(std::move(mask), atlasWidth, atlasHeight);
+		mGlyphAtlasSize = { static_cast<float>(atlasWidth), static_cast<float>(atlasHeight) };
+	}
+
+	if (!mRenderer)
+	{
+		SDL_DestroySurface(atlas);
+		return;
+	}
+
+	mGlyphAtlas = SDL_CreateTextureFromSurface(mRenderer, atlas);
+	SDL_DestroySurface(atlas);
+	if (!mGlyphAtlas)
+		return;
+
+	SDL_SetTextureBlendMode(mGlyphAtlas, SDL_BLENDMODE_BLEND);
+	mGlyphAtlasSize = { static_cast<float>(atlasWidth), static_cast<float>(atlasHeight) };
+}
+
+void Renderer::destroyGlyphAtlas()
+{
+	if (mGlyphAtlas)
+	{
+		SDL_DestroyTexture(mGlyphAtlas);
+		mGlyphAtlas = nullptr;
+	}
+}
+
+SDL_FRect Renderer::toScreenRect(const AABB& bounds) const
+{
+	const Vector2 min = toScreen(bounds.min);
+	const Vector2 max = toScreen(bounds.max);
+	return { min.x, min.y, max.x - min.x, max.y - min.y };
 }
 
 Vector2 Renderer::toScreen(const Vector2& logical) const
 {
 	return {
-		logical.x * mScale.x,
-		logical.y * mScale.y
+		(logical.x - mCameraPosition.x) * mScale.x,
+		(logical.y - mCameraPosition.y) * mScale.y
 	};
 }
\ No newline at end of file
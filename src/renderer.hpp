@@ -1,8 +1,13 @@
 #pragma once
 #include <format>
+#include <array>
+#include <memory>
 #include <stdexcept>
+#include <string_view>
+#include <vector>
 
 #include "math.hpp"
+#include "tileRasterizer.hpp"
 #include "SDL3/SDL.h"
 #include "SDL3_ttf/SDL_ttf.h"
 
@@ -19,10 +24,20 @@ enum class TextAlign : std::uint8_t
 	BottomRight
 };
 
+enum class RenderBackend : std::uint8_t
+{
+	Sdl,  // Every shape is an SDL_Renderer call
+	Tiled // Shapes are rasterized on the CPU by TileRasterizer; SDL only receives the finished frame
+};
+
 class Renderer final
 {
 public:
-	Renderer(SDL_Window* window, const Vector2& logicalSize, const Vector2& screenSize);
+	Renderer(SDL_Window* window, const Vector2& logicalSize, const Vector2& screenSize, RenderBackend backend = RenderBackend::Sdl);
+
+	// Software rendering into a surface owned by the caller, for runs without a window.
+	// The tiled backend needs an XRGB8888 surface.
+	Renderer(SDL_Surface* target, const Vector2& logicalSize, RenderBackend backend = RenderBackend::Sdl);
 
 	~Renderer();
 
@@ -36,12 +51,46 @@ public:
 
 	void drawFilledRectangle(const Vector2& position, const Vector2& size, const SDL_Color& color) const;
 
-	void drawText(const std::string& text, const Vector2& position, const SDL_Color& color, TextAlign align = TextAlign::MiddleLeft) const;
+	// Batched drawing. Queued shapes are submitted by flushQueue() with a single geometry call for
+	// all filled rectangles and one call per run of equally colored outlines.
+	void queueFilledRectangle(const AABB& bounds, const SDL_Color& color) const;
+
+	void queueRectangle(const AABB& bounds, const SDL_Color& color) const;
+
+	void flushQueue() const;
+
+	// Text drawn from a pre-rasterized glyph atlas: no per-call rasterization or texture uploads.
+	// Queued strings are submitted by flushTextQueue() as a single geometry call.
+	void queueAtlasText(std::string_view text, const Vector2& position, const SDL_Color& color, float scale = 1.f) const;
+
+	void flushTextQueue() const;
+
+	// Draw calls submitted since the last clearScreen()
+	uint32_t getDrawCallCount() const;
+
+	// Draw calls of the last presented frame
+	uint32_t getLastFrameDrawCallCount() const;
+
+	void drawText(std::string_view text, const Vector2& position, const SDL_Color& color, TextAlign align = TextAlign::MiddleLeft) const;
 	void loadFont();
 
 	void setLogicalResolution(const Vector2& logicalSize, const Vector2& screenSize);
 
+	// Logical position drawn at the top-left corner of the screen
+	void setCameraPosition(const Vector2& position);
+
 private:
+	void initialize(const Vector2& logicalSize, const Vector2& screenSize);
+
+	// Tiled backend: the streaming texture the rasterized frame is uploaded to
+	void createFrameTexture();
+
+	// Tiled backend: records text from the glyph atlas at a top-left screen position
+	void rasterizeAtlasText(std::string_view text, const Vector2& screenPosition, const SDL_Color& color) const;
+
+	static uint32_t toARGB(const SDL_Color& c);
+
+	static uint32_t toARGB(const SDL_FColor& c);
 
 	void setDrawColor(const SDL_Color& color) const;
 
@@ -49,13 +98,51 @@ private:
 
 	Vector2 toScreen(const Vector2& logical) const;
 
+	SDL_FRect toScreenRect(const AABB& bounds) const;
+
+	void buildGlyphAtlas();
+
+	void destroyGlyphAtlas();
+
+	// Printable ASCII
+	static constexpr char kFirstAtlasGlyph = ' ';
+	static constexpr char kLastAtlasGlyph = '~';
+
+	struct AtlasGlyph
+	{
+		float x = 0.f; // Left edge in the atlas, in pixels
+		float width = 0.f;
+	};
+
 	SDL_Renderer* mRenderer = nullptr;
 	TTF_Font* mFont = nullptr;
 
+	// Tiled backend
+	std::unique_ptr<TileRasterizer> mRasterizer;
+	SDL_Surface* mTargetSurface = nullptr; // Rasterized into directly; nullptr when presenting to a window
+	SDL_Texture* mFrameTexture = nullptr;
+
 	Vector2 mLogicalSize;
 	Vector2 mScreenSize;
 	Vector2 mScale;
+	Vector2 mCameraPosition;
 
 	float mBaseFontSize = 24.f; // Design-time font size (works well at 800x800)
 	float mCurrentFontSize = 24.f;
+
+	// Batch queues; they keep their capacity between frames
+	static constexpr size_t kReservedQuadCount = 8192;
+	static constexpr size_t kReservedGlyphCount = 2048; // Atlas text, the perf overlay's a few hundred at most
+	mutable std::vector<SDL_Vertex> mQueuedVertices;
+	mutable std::vector<int> mQuadIndices;
+	mutable std::vector<SDL_FRect> mQueuedOutlines;
+	mutable std::vector<SDL_Color> mQueuedOutlineColors;
+	mutable std::vector<SDL_Vertex> mQueuedTextVertices;
+
+	SDL_Texture* mGlyphAtlas = nullptr;
+	Vector2 mGlyphAtlasSize;
+	std::array<AtlasGlyph, kLastAtlasGlyph - kFirstAtlasGlyph + 1> mAtlasGlyphs{};
+
+	mutable uint32_t mDrawCallCount = 0;
+	mutable uint32_t mLastFrameDrawCallCount = 0;
 };
\ No newline at end of file
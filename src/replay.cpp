@@ -0,0 +1,265 @@
+#include "replay.hpp"
+
+#include <format>
+#include <iterator>
+#include <stdexcept>
+
+namespace
+{
+	void putVarint(std::vector<uint8_t>& out, uint64_t value)
+	{
+		while (value >= 0x80)
+		{
+			out.push_back(static_cast<uint8_t>(value | 0x80));
+			value >>= 7;
+		}
+		out.push_back(static_cast<uint8_t>(value));
+	}
+
+	void putFixed(std::vector<uint8_t>& out, uint64_t value, size_t size)
+	{
+		for (size_t i = 0; i < size; ++i)
+			out.push_back(static_cast<uint8_t>(value >> (i * 8)));
+	}
+
+	// Maps signed deltas to small unsigned values: 0, -1, 1, -2, ... -> 0, 1, 2, 3, ...
+	uint64_t zigzagEncode(int64_t value)
+	{
+		return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+	}
+
+	int64_t zigzagDecode(uint64_t value)
+	{
+		return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+	}
+}
+
+ReplayRecorder::ReplayRecorder(const std::string& path, const ReplayHeader& header)
+	: mPath(path), mFile(path, std::ios::binary | std::ios::trunc), mClockNs(header.startTimeNs)
+{
+	if (!mFile)
+		throw std::runtime_error(std::format("Failed to open replay file {} for writing", path));
+
+	mPending.reserve(kFlushThreshold * 2);
+	mWriting.reserve(kFlushThreshold * 2);
+
+	uint8_t flags = 0;
+	if (header.endless)
+		flags |= ReplayFormat::kFlagEndless;
+	if (header.levelSeed)
+		flags |= ReplayFormat::kFlagLevelSeed;
+
+	putFixed(mPending, ReplayFormat::kMagic, 4);
+	putFixed(mPending, ReplayFormat::kVersion, 2);
+	mPending.push_back(flags);
+	putFixed(mPending, header.rngSeed, 4);
+	putFixed(mPending, header.startTimeNs, 8);
+	if (header.levelSeed)
+		putFixed(mPending, *header.levelSeed, 8);
+	putVarint(mPending, header.levelPath.size());
+	mPending.insert(mPending.end(), header.levelPath.begin(), header.levelPath.end());
+
+	mWriter = std::jthread([this](std::stop_token stopToken) { writerLoop(stopToken); });
+}
+
+ReplayRecorder::~ReplayRecorder()
+{
+	submitPending();
+	mWriter.request_stop();
+	mWriter.join();
+
+	if (mWriteFailed)
+		SDL_Log("Failed to write replay file %s", mPath.c_str());
+	else
+		SDL_Log("Recorded %llu ticks to %s", static_cast<unsigned long long>(mTickCount), mPath.c_str());
+}
+
+void ReplayRecorder::recordTick(const ReplayTick& tick)
+{
+	putVarint(mPending, zigzagEncode(static_cast<int64_t>(tick.frameDeltaNs - mPreviousFrameDeltaNs)));
+	mPreviousFrameDeltaNs = tick.frameDeltaNs;
+
+	putVarint(mPending, (static_cast<uint64_t>(tick.keyEvents.size()) << 2) | (tick.commands & 0x3));
+
+	uint64_t referenceNs = mClockNs;
+	for (const InputEvent& event : tick.keyEvents)
+	{
+		const uint64_t keyBits = (event.key == SDLK_RIGHT ? 2u : 0u) | (event.down ? 1u : 0u);
+		putVarint(mPending, (zigzagEncode(static_cast<int64_t>(event.timestampNs - referenceNs)) << 2) | keyBits);
+		referenceNs = event.timestampNs;
+	}
+
+	putFixed(mPending, tick.stateChecksum, 4);
+
+	mClockNs += tick.frameDeltaNs;
+	mTickCount++;
+
+	if (mPending.size() >= kFlushThreshold)
+		submitPending();
+}
+
+uint64_t ReplayRecorder::getTickCount() const
+{
+	return mTickCount;
+}
+
+void ReplayRecorder::submitPending()
+{
+	if (mPending.empty())
+		return;
+
+	std::unique_lock lock(mMutex);
+	mWake.wait(lock, [this] { return !mHasWork; });
+
+	// Both buffers keep their capacity, so steady-state recording does not allocate
+	std::swap(mPending, mWriting);
+	mHasWork = true;
+	mWake.notify_all();
+}
+
+void ReplayRecorder::writerLoop(std::stop_token stopToken)
+{
+	std::unique_lock lock(mMutex);
+	while (true)
+	{
+		// Work submitted before the stop request is still written out
+		mWake.wait(lock, stopToken, [this] { return mHasWork; });
+		if (!mHasWork)
+			return;
+
+		lock.unlock();
+		mFile.write(reinterpret_cast<const char*>(mWriting.data()), static_cast<std::streamsize>(mWriting.size()));
+		mFile.flush();
+		if (!mFile)
+			mWriteFailed = true;
+		lock.lock();
+
+		mWriting.clear();
+		mHasWork = false;
+		mWake.notify_all();
+	}
+}
+
+ReplayReader::ReplayReader(const std::string& path)
+	: mPath(path)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file)
+		throw std::runtime_error(std::format("Failed to open replay file {}", path));
+
+	mData.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+	auto readFixed = [this](size_t size)
+	{
+		if (mData.size() - mOffset < size)
+			throwCorrupt("truncated header");
+
+		uint64_t value = 0;
+		for (size_t i = 0; i < size; ++i)
+			value |= static_cast<uint64_t>(mData[mOffset + i]) << (i * 8);
+		mOffset += size;
+		return value;
+	};
+
+	if (readFixed(4) != ReplayFormat::kMagic)
+		throwCorrupt("bad magic");
+
+	const auto version = static_cast<uint16_t>(readFixed(2));
+	if (version != ReplayFormat::kVersion)
+		throw std::runtime_error(std::format("Replay file {} has unsupported version {}", path, version));
+
+	const auto flags = static_cast<uint8_t>(readFixed(1));
+	mHeader.rngSeed = static_cast<uint32_t>(readFixed(4));
+	mHeader.startTimeNs = readFixed(8);
+	mHeader.endless = (flags & ReplayFormat::kFlagEndless) != 0;
+	if (flags & ReplayFormat::kFlagLevelSeed)
+		mHeader.levelSeed = readFixed(8);
+
+	const uint64_t pathLength = readVarint();
+	if (mData.size() - mOffset < pathLength)
+		throwCorrupt("truncated level path");
+	mHeader.levelPath.assign(reinterpret_cast<const char*>(mData.data() + mOffset), static_cast<size_t>(pathLength));
+	mOffset += static_cast<size_t>(pathLength);
+
+	mTicksOffset = mOffset;
+	mClockNs = mHeader.startTimeNs;
+}
+
+const ReplayHeader& ReplayReader::getHeader() const
+{
+	return mHeader;
+}
+
+bool ReplayReader::nextTick(ReplayTick& tick)
+{
+	if (mOffset == mData.size())
+		return false;
+
+	tick.frameDeltaNs = mPreviousFrameDeltaNs + static_cast<uint64_t>(zigzagDecode(readVarint()));
+	mPreviousFrameDeltaNs = tick.frameDeltaNs;
+
+	const uint64_t countAndCommands = readVarint();
+	tick.commands = static_cast<uint8_t>(countAndCommands & 0x3);
+
+	const uint64_t eventCount = countAndCommands >> 2;
+	if (eventCount > mData.size() - mOffset)
+		throwCorrupt("key event count exceeds file size");
+
+	tick.keyEvents.clear();
+	uint64_t referenceNs = mClockNs;
+	for (uint64_t i = 0; i < eventCount; ++i)
+	{
+		const uint64_t value = readVarint();
+		InputEvent event;
+		event.timestampNs = referenceNs + static_cast<uint64_t>(zigzagDecode(value >> 2));
+		event.key = (value & 2) ? SDLK_RIGHT : SDLK_LEFT;
+		event.down = (value & 1) != 0;
+		tick.keyEvents.push_back(event);
+		referenceNs = event.timestampNs;
+	}
+
+	if (mData.size() - mOffset < 4)
+		throwCorrupt("truncated tick");
+	tick.stateChecksum = 0;
+	for (size_t i = 0; i < 4; ++i)
+		tick.stateChecksum |= static_cast<uint32_t>(mData[mOffset + i]) << (i * 8);
+	mOffset += 4;
+
+	mClockNs += tick.frameDeltaNs;
+	mTickCount++;
+	return true;
+}
+
+uint64_t ReplayReader::getTickCount() const
+{
+	return mTickCount;
+}
+
+void ReplayReader::rewind()
+{
+	mOffset = mTicksOffset;
+	mTickCount = 0;
+	mClockNs = mHeader.startTimeNs;
+	mPreviousFrameDeltaNs = 0;
+}
+
+uint64_t ReplayReader::readVarint()
+{
+	uint64_t value = 0;
+	for (int shift = 0; shift < 64; shift += 7)
+	{
+		if (mOffset == mData.size())
+			throwCorrupt("truncated varint");
+
+		const uint8_t byte = mData[mOffset++];
+		value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+		if ((byte & 0x80) == 0)
+			return value;
+	}
+	throwCorrupt("varint too long");
+}
+
+void ReplayReader::throwCorrupt(const char* reason) const
+{
+	throw std::runtime_error(std::format("Replay file {} is corrupt: {}", mPath, reason));
+}
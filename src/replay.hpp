@@ -0,0 +1,164 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "inputSampler.hpp"
+
+// Binary replay file (.arkr) layout, all integers little endian:
+//   header: u32 magic, u16 version, u8 flags, u32 rng seed, u64 start time,
+//           [u64 level seed], varint level path length, level path bytes
+//   ticks until the end of the file, each:
+//     varint zigzag(frame delta - previous frame delta)
+//     varint (key event count << 2) | commands
+//     per key event: varint (zigzag(timestamp - previous timestamp) << 2) | (right << 1) | down
+//     u32 state checksum
+// Key event timestamps are relative to the previous event of the tick, or to the start of the tick for the first one.
+namespace ReplayFormat
+{
+	constexpr uint32_t kMagic = 0x524B5241; // "ARKR"
+	constexpr uint16_t kVersion = 1;
+
+	constexpr uint8_t kFlagEndless = 1u << 0;
+	constexpr uint8_t kFlagLevelSeed = 1u << 1;
+}
+
+// Discrete commands a tick can issue besides platform movement
+namespace ReplayCommand
+{
+	constexpr uint8_t kSpace = 1u << 0; // Start, serve, pause or resume
+	constexpr uint8_t kRestart = 1u << 1;
+}
+
+// Everything needed to rebuild the simulation state the recording started from
+struct ReplayHeader
+{
+	uint32_t rngSeed = 0;
+	uint64_t startTimeNs = 0; // Simulation clock before the first tick
+	bool endless = false;
+	std::optional<uint64_t> levelSeed;
+	std::string levelPath;
+};
+
+// Input consumed by one simulation tick and a checksum of the state it produced
+struct ReplayTick
+{
+	uint64_t frameDeltaNs = 0;
+	uint8_t commands = 0;
+	std::vector<InputEvent> keyEvents; // Platform key transitions (SDLK_LEFT / SDLK_RIGHT only)
+	uint32_t stateChecksum = 0;
+};
+
+// FNV-1a over the raw bytes of simulation values, so floats are compared bit for bit
+class StateChecksum final
+{
+public:
+	template <typename T>
+		requires std::is_trivially_copyable_v<T>
+	void add(const T& value)
+	{
+		unsigned char bytes[sizeof(T)];
+		std::memcpy(bytes, &value, sizeof(T));
+		addBytes(bytes, sizeof(T));
+	}
+
+	template <typename T>
+		requires std::is_trivially_copyable_v<T>
+	void add(std::span<const T> values)
+	{
+		for (const T& value : values)
+			add(value);
+	}
+
+	uint32_t get() const { return mHash; }
+
+private:
+	void addBytes(const unsigned char* bytes, size_t size)
+	{
+		for (size_t i = 0; i < size; ++i)
+			mHash = (mHash ^ bytes[i]) * 16777619u;
+	}
+
+	uint32_t mHash = 2166136261u;
+};
+
+// Encodes ticks on the calling thread and hands full buffers to a background thread for writing,
+// so the game loop never waits on the disk unless the writer falls a whole buffer behind
+class ReplayRecorder final
+{
+public:
+	ReplayRecorder(const std::string& path, const ReplayHeader& header);
+
+	// Writes out every recorded tick before returning
+	~ReplayRecorder();
+
+	ReplayRecorder(const ReplayRecorder&) = delete;
+	ReplayRecorder& operator=(const ReplayRecorder&) = delete;
+
+	void recordTick(const ReplayTick& tick);
+
+	uint64_t getTickCount() const;
+
+private:
+	void submitPending();
+
+	void writerLoop(std::stop_token stopToken);
+
+	static constexpr size_t kFlushThreshold = 16 * 1024;
+
+	std::string mPath;
+	std::ofstream mFile;
+	uint64_t mTickCount = 0;
+	uint64_t mClockNs = 0;
+	uint64_t mPreviousFrameDeltaNs = 0;
+
+	std::vector<uint8_t> mPending; // Encoded ticks not handed to the writer yet
+	std::vector<uint8_t> mWriting; // Owned by the writer thread while mHasWork is set
+	std::mutex mMutex;
+	std::condition_variable_any mWake;
+	bool mHasWork = false;
+	std::atomic<bool> mWriteFailed{ false };
+	std::jthread mWriter;
+};
+
+// Loads a replay file and decodes its ticks in order
+class ReplayReader final
+{
+public:
+	explicit ReplayReader(const std::string& path);
+
+	const ReplayHeader& getHeader() const;
+
+	// Decodes the next tick into tick, reusing its key event storage. Returns false at the end of the replay.
+	bool nextTick(ReplayTick& tick);
+
+	// Ticks decoded so far
+	uint64_t getTickCount() const;
+
+	// Starts over from the first tick
+	void rewind();
+
+private:
+	uint64_t readVarint();
+
+	[[noreturn]] void throwCorrupt(const char* reason) const;
+
+	std::string mPath;
+	ReplayHeader mHeader;
+	std::vector<uint8_t> mData;
+	size_t mTicksOffset = 0;
+	size_t mOffset = 0;
+	uint64_t mTickCount = 0;
+	uint64_t mClockNs = 0;
+	uint64_t mPreviousFrameDeltaNs = 0;
+};
@@ -0,0 +1,75 @@
+#include "simulationState.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+void saveSnapshot(const SimulationState& state, const Playfield& playfield, SimulationSnapshot& snapshot)
+{
+	std::memcpy(&snapshot.state, &state, sizeof(SimulationState));
+	playfield.saveState(snapshot.playfield);
+
+	// Stays within the reserved capacity, so this does not allocate
+	const auto hitPoints = playfield.getHitPoints();
+	snapshot.hitPoints.resize(hitPoints.size());
+	if (!hitPoints.empty())
+		std::memcpy(snapshot.hitPoints.data(), hitPoints.data(), hitPoints.size());
+}
+
+void restoreSnapshot(const SimulationSnapshot& snapshot, SimulationState& state, Playfield& playfield)
+{
+	// The playfield validates first, so a rejected snapshot leaves everything untouched
+	playfield.restoreState(snapshot.playfield, snapshot.hitPoints);
+	std::memcpy(&state, &snapshot.state, sizeof(SimulationState));
+}
+
+SnapshotRing::SnapshotRing(size_t slotCount)
+	: mSlots(slotCount)
+{
+}
+
+void SnapshotRing::reserve(size_t hitPointCount)
+{
+	for (auto& slot : mSlots)
+		slot.hitPoints.reserve(hitPointCount);
+}
+
+SimulationSnapshot& SnapshotRing::push()
+{
+	SimulationSnapshot& slot = mSlots[mNext];
+	mNext = (mNext + 1) % mSlots.size();
+	mCount = std::min(mCount + 1, mSlots.size());
+	return slot;
+}
+
+void SnapshotRing::pop()
+{
+	if (mCount == 0)
+		return;
+
+	mNext = (mNext + mSlots.size() - 1) % mSlots.size();
+	mCount--;
+}
+
+const SimulationSnapshot* SnapshotRing::get(size_t age) const
+{
+	if (age >= mCount)
+		return nullptr;
+
+	return &mSlots[(mNext + mSlots.size() - 1 - age) % mSlots.size()];
+}
+
+size_t SnapshotRing::size() const
+{
+	return mCount;
+}
+
+size_t SnapshotRing::capacity() const
+{
+	return mSlots.size();
+}
+
+void SnapshotRing::clear()
+{
+	mNext = 0;
+	mCount = 0;
+}
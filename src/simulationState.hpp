@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#include "ball.hpp"
+#include "gameState.hpp"
+#include "platform.hpp"
+#include "playfield.hpp"
+
+// Everything the simulation mutates during play apart from the playfield. Kept trivially copyable,
+// so it can be snapshotted with a single memcpy. Walls and the collision context are derived from it every tick.
+struct SimulationState
+{
+	std::optional<Ball> ball;
+	std::optional<Platform> platform;
+	uint32_t score = 0;
+	uint32_t maxScore = 0;
+	uint32_t lifeCount = 0;
+	GameState gameState = GameState::NotStarted;
+	bool moveLeftHeld = false;
+	bool moveRightHeld = false;
+	bool hitWallPreviously = false;
+	bool hasMoved = false;
+	float viewTop = 0.f; // Top of the visible area in world units; moves upwards in endless mode
+	uint64_t platformTimeNs = 0; // Time the platform has been integrated up to
+	std::mt19937 rng;
+};
+
+static_assert(std::is_trivially_copyable_v<SimulationState>, "SimulationState must stay trivially copyable");
+static_assert(std::is_trivially_copyable_v<PlayfieldState>, "PlayfieldState must stay trivially copyable");
+
+// A restorable copy of the simulation: two fixed-size copies plus the playfield's contiguous hit points
+struct SimulationSnapshot
+{
+	uint64_t tick = 0;
+	SimulationState state;
+	PlayfieldState playfield;
+	std::vector<uint8_t> hitPoints;
+};
+
+void saveSnapshot(const SimulationState& state, const Playfield& playfield, SimulationSnapshot& snapshot);
+
+// Throws std::invalid_argument when the snapshot was taken on another level
+void restoreSnapshot(const SimulationSnapshot& snapshot, SimulationState& state, Playfield& playfield);
+
+// Fixed number of preallocated snapshot slots, overwriting the oldest when full
+class SnapshotRing final
+{
+public:
+	explicit SnapshotRing(size_t slotCount);
+
+	// Sizes every slot for the hit points of the current level. After this, saving never allocates.
+	void reserve(size_t hitPointCount);
+
+	// Slot to overwrite with the newest snapshot
+	SimulationSnapshot& push();
+
+	// Drops the newest snapshot, e.g. after rolling back to it
+	void pop();
+
+	// Snapshot taken age pushes ago (0 is the newest), or nullptr when no longer stored
+	const SimulationSnapshot* get(size_t age) const;
+
+	size_t size() const;
+
+	size_t capacity() const;
+
+	void clear();
+
+private:
+	std::vector<SimulationSnapshot> mSlots;
+	size_t mNext = 0;
+	size_t mCount = 0;
+};
@@ -2,6 +2,8 @@
 
 #include <SDL3/SDL_audio.h>
 
+#include "profiler.hpp"
+
 SoundPlayer::SoundPlayer()
 {
 	const std::string soundsPath = "assets/sounds/";
@@ -43,6 +45,8 @@ SoundPlayer::~SoundPlayer()
 
 void SoundPlayer::play(SoundId id) const
 {
+	PROFILE_ZONE("SoundPlayer::play");
+
 	if (!stream) return;
 
 	const SoundData& sound = sounds[static_cast<size_t>(id)];
@@ -53,6 +57,11 @@ void SoundPlayer::play(SoundId id) const
 	}
 }
 
+int SoundPlayer::getQueuedBytes() const
+{
+	return stream ? SDL_GetAudioStreamQueued(stream) : 0;
+}
+
 void SoundPlayer::loadSound(SoundId id, const char* filePath)
 {
 	SoundData sound;
@@ -27,6 +27,9 @@ public:
 
 	void play(SoundId id) const;
 
+	// Bytes of audio queued but not yet played
+	int getQueuedBytes() const;
+
 private:
 
 	struct SoundData
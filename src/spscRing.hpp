@@ -0,0 +1,64 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// Lock-free single-producer / single-consumer ring buffer with a fixed power-of-two capacity.
+// The producer only writes mHead, the consumer only writes mTail.
+template <typename T, size_t Capacity>
+class SpscRing final
+{
+	static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+	// Producer side. Returns false (and drops the value) when the ring is full.
+	bool tryPush(const T& value)
+	{
+		const size_t head = mHead.load(std::memory_order_relaxed);
+		if (head - mTail.load(std::memory_order_acquire) == Capacity)
+			return false;
+
+		mBuffer[head & kMask] = value;
+		mHead.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Consumer side. Copies the oldest value without removing it.
+	bool peek(T& value) const
+	{
+		const size_t tail = mTail.load(std::memory_order_relaxed);
+		if (tail == mHead.load(std::memory_order_acquire))
+			return false;
+
+		value = mBuffer[tail & kMask];
+		return true;
+	}
+
+	// Consumer side. Removes the oldest value.
+	bool tryPop(T& value)
+	{
+		if (!peek(value))
+			return false;
+
+		mTail.store(mTail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+		return true;
+	}
+
+	size_t size() const
+	{
+		return mHead.load(std::memory_order_acquire) - mTail.load(std::memory_order_acquire);
+	}
+
+	static constexpr size_t capacity()
+	{
+		return Capacity;
+	}
+
+private:
+	static constexpr size_t kMask = Capacity - 1;
+
+	alignas(64) std::atomic<size_t> mHead{ 0 };
+	alignas(64) std::atomic<size_t> mTail{ 0 };
+	alignas(64) std::array<T, Capacity> mBuffer{};
+};
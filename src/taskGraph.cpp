@@ -0,0 +1,160 @@
+#include "taskGraph.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+namespace
+{
+	uint64_t getTimeNs()
+	{
+		using namespace std::chrono;
+		return static_cast<uint64_t>(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+	}
+}
+
+TaskGraph::TaskId TaskGraph::addTask(const char* name, std::function<void()> function, TaskResources reads, TaskResources writes)
+{
+	const auto id = static_cast<TaskId>(mTasks.size());
+
+	Task task;
+	task.function = std::move(function);
+	task.reads = reads;
+	task.writes = writes;
+	for (TaskId other = 0; other < id; ++other)
+	{
+		Task& earlier = mTasks[other];
+		const bool conflicts = (writes & (earlier.reads | earlier.writes)) != 0 || (reads & earlier.writes) != 0;
+		if (!conflicts)
+			continue;
+
+		earlier.successors.push_back(id);
+		task.predecessors.push_back(other);
+	}
+	mTasks.push_back(std::move(task));
+
+	mPendingDependencies = std::make_unique<std::atomic<uint32_t>[]>(mTasks.size());
+	mTimings.resize(mTasks.size());
+	mStats.push_back({ .name = name });
+	mPathFinishNs.resize(mTasks.size());
+	mPathPrevious.resize(mTasks.size());
+	mCriticalPath.reserve(mTasks.size());
+	return id;
+}
+
+void TaskGraph::run(ThreadPool& pool)
+{
+	if (mTasks.empty())
+		return;
+
+	mPool = &pool;
+	mRunStartNs = getTimeNs();
+	mRemainingTasks.store(static_cast<uint32_t>(mTasks.size()), std::memory_order_relaxed);
+	for (size_t i = 0; i < mTasks.size(); ++i)
+		mPendingDependencies[i].store(static_cast<uint32_t>(mTasks[i].predecessors.size()), std::memory_order_relaxed);
+
+	for (TaskId id = 0; id < mTasks.size(); ++id)
+	{
+		if (mTasks[id].predecessors.empty())
+			pool.submit({ .function = &TaskGraph::runTask, .context = this, .index = id });
+	}
+
+	while (mRemainingTasks.load(std::memory_order_acquire) > 0)
+	{
+		if (!pool.runPendingJob())
+			std::this_thread::yield();
+	}
+
+	mRunNs = getTimeNs() - mRunStartNs;
+	updateCriticalPath();
+}
+
+size_t TaskGraph::getTaskCount() const
+{
+	return mTasks.size();
+}
+
+std::span<const TaskTiming> TaskGraph::getTimings() const
+{
+	return mTimings;
+}
+
+std::span<const TaskGraph::TaskId> TaskGraph::getCriticalPath() const
+{
+	return mCriticalPath;
+}
+
+uint64_t TaskGraph::getCriticalPathNs() const
+{
+	return mCriticalPathNs;
+}
+
+uint64_t TaskGraph::getRunNs() const
+{
+	return mRunNs;
+}
+
+std::span<const TaskStats> TaskGraph::getStats() const
+{
+	return mStats;
+}
+
+void TaskGraph::runTask(void* context, uint32_t index)
+{
+	auto& graph = *static_cast<TaskGraph*>(context);
+	Task& task = graph.mTasks[index];
+
+	TaskTiming& timing = graph.mTimings[index];
+	timing.threadIndex = graph.mPool->getCurrentThreadIndex();
+	timing.startNs = getTimeNs() - graph.mRunStartNs;
+	task.function();
+	timing.endNs = getTimeNs() - graph.mRunStartNs;
+
+	for (TaskId successor : task.successors)
+	{
+		if (graph.mPendingDependencies[successor].fetch_sub(1, std::memory_order_acq_rel) == 1)
+			graph.mPool->submit({ .function = &TaskGraph::runTask, .context = &graph, .index = successor });
+	}
+
+	graph.mRemainingTasks.fetch_sub(1, std::memory_order_release);
+}
+
+void TaskGraph::updateCriticalPath()
+{
+	// Tasks only depend on earlier tasks, so insertion order is a topological order
+	TaskId last = 0;
+	for (TaskId id = 0; id < mTasks.size(); ++id)
+	{
+		const uint64_t duration = mTimings[id].endNs - mTimings[id].startNs;
+
+		uint64_t start = 0;
+		mPathPrevious[id] = id;
+		for (TaskId predecessor : mTasks[id].predecessors)
+		{
+			if (mPathPrevious[id] == id || mPathFinishNs[predecessor] > start)
+			{
+				start = mPathFinishNs[predecessor];
+				mPathPrevious[id] = predecessor;
+			}
+		}
+		mPathFinishNs[id] = start + duration;
+		if (mPathFinishNs[id] > mPathFinishNs[last])
+			last = id;
+
+		TaskStats& stats = mStats[id];
+		stats.runCount++;
+		stats.totalNs += duration;
+		stats.maxNs = std::max(stats.maxNs, duration);
+	}
+
+	mCriticalPathNs = mPathFinishNs[last];
+	mCriticalPath.clear();
+	for (TaskId id = last;; id = mPathPrevious[id])
+	{
+		mCriticalPath.push_back(id);
+		mStats[id].criticalPathCount++;
+		if (mPathPrevious[id] == id)
+			break;
+	}
+	std::ranges::reverse(mCriticalPath);
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "threadPool.hpp"
+
+// Bit set of the data a task touches; the meaning of each bit is up to the owner of the graph
+using TaskResources = uint32_t;
+
+struct TaskTiming
+{
+	uint64_t startNs = 0; // Relative to the start of the run
+	uint64_t endNs = 0;
+	uint32_t threadIndex = 0;
+};
+
+// Per-task statistics accumulated over every run of the graph
+struct TaskStats
+{
+	const char* name = nullptr;
+	uint64_t runCount = 0;
+	uint64_t totalNs = 0;
+	uint64_t maxNs = 0;
+	uint64_t criticalPathCount = 0; // Runs in which the task was on the critical path
+};
+
+// A fixed set of tasks run once per frame. Tasks declare which resources they read and write;
+// a task waits for every earlier task that writes something it reads or writes, or reads something
+// it writes. Everything else runs concurrently on the pool.
+class TaskGraph final
+{
+public:
+	using TaskId = uint32_t;
+
+	TaskId addTask(const char* name, std::function<void()> function, TaskResources reads, TaskResources writes);
+
+	// Runs every task once and returns when all have finished. The calling thread helps out.
+	void run(ThreadPool& pool);
+
+	size_t getTaskCount() const;
+
+	// Timings of the last run
+	std::span<const TaskTiming> getTimings() const;
+
+	// Longest chain of dependent tasks in the last run, first task first
+	std::span<const TaskId> getCriticalPath() const;
+
+	uint64_t getCriticalPathNs() const;
+
+	// Wall time of the last run
+	uint64_t getRunNs() const;
+
+	std::span<const TaskStats> getStats() const;
+
+private:
+	struct Task
+	{
+		std::function<void()> function;
+		TaskResources reads = 0;
+		TaskResources writes = 0;
+		std::vector<TaskId> successors;
+		std::vector<TaskId> predecessors;
+	};
+
+	static void runTask(void* context, uint32_t index);
+
+	void updateCriticalPath();
+
+	std::vector<Task> mTasks;
+	std::unique_ptr<std::atomic<uint32_t>[]> mPendingDependencies;
+	std::atomic<uint32_t> mRemainingTasks{ 0 };
+	ThreadPool* mPool = nullptr;
+	uint64_t mRunStartNs = 0;
+	uint64_t mRunNs = 0;
+
+	std::vector<TaskTiming> mTimings;
+	std::vector<TaskStats> mStats;
+	std::vector<TaskId> mCriticalPath;
+	std::vector<uint64_t> mPathFinishNs; // Scratch for the critical path search
+	std::vector<TaskId> mPathPrevious;
+	uint64_t mCriticalPathNs = 0;
+};
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Layout of the shared-memory telemetry segment. Shared between the game, which publishes, and
+// external monitors, which only read. Everything in here must stay plain and fixed-size.
+namespace Telemetry
+{
+	inline constexpr char kDefaultSegmentName[] = "/arkanoid_telemetry";
+	inline constexpr uint32_t kMagic = 0x544B5241; // "ARKT"
+	inline constexpr uint32_t kVersion = 2;
+	inline constexpr uint32_t kRingCapacity = 1024; // Power of two
+
+	struct FrameSample
+	{
+		uint64_t frameIndex = 0;
+		uint64_t timestampNs = 0; // Publisher clock, only meaningful as differences
+		float frameMs = 0.f;
+		float eventsMs = 0.f;
+		float updateMs = 0.f;
+		float renderMs = 0.f;
+		float uiMs = 0.f;
+		uint32_t particleCount = 0;
+		uint32_t blockCount = 0;
+		uint32_t ccdIterations = 0;
+		uint32_t ccdBudgetExhausted = 0; // 1 if the ball update ran out of CCD steps
+		uint32_t drawCalls = 0;
+		int32_t audioQueuedBytes = 0;
+	};
+
+	// Each slot is a seqlock: the sequence is odd while the publisher writes the sample and
+	// 2 * (frame slot index + 1) once the sample for that index is complete
+	struct Slot
+	{
+		std::atomic<uint64_t> sequence{ 0 };
+		FrameSample sample;
+	};
+
+	struct Segment
+	{
+		uint32_t magic = 0;
+		uint32_t version = 0;
+		uint32_t capacity = 0;
+		uint32_t sampleSize = 0;
+
+		// Number of samples published so far; written by the publisher only
+		alignas(64) std::atomic<uint64_t> writeIndex{ 0 };
+		alignas(64) Slot slots[kRingCapacity];
+	};
+
+	static_assert(std::atomic<uint64_t>::is_always_lock_free, "Shared-memory atomics must be lock-free");
+	static_assert((kRingCapacity & (kRingCapacity - 1)) == 0, "Ring capacity must be a power of two");
+
+	// Copies the sample published as number index. Fails if it was overwritten or is being written.
+	inline bool readSample(const Segment& segment, uint64_t index, FrameSample& sample)
+	{
+		const Slot& slot = segment.slots[index & (kRingCapacity - 1)];
+		const uint64_t expected = 2 * (index + 1);
+
+		if (slot.sequence.load(std::memory_order_acquire) != expected)
+			return false;
+
+		sample = slot.sample;
+		std::atomic_thread_fence(std::memory_order_acquire);
+		return slot.sequence.load(std::memory_order_relaxed) == expected;
+	}
+}
@@ -0,0 +1,80 @@
+#include "telemetryPublisher.hpp"
+
+#include <new>
+
+#include "SDL3/SDL.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define ARKANOID_HAS_POSIX_SHM 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+TelemetryPublisher::TelemetryPublisher(const std::string& segmentName)
+	: mSegmentName(segmentName)
+{
+#ifdef ARKANOID_HAS_POSIX_SHM
+	const int fd = shm_open(mSegmentName.c_str(), O_CREAT | O_RDWR, 0600);
+	if (fd < 0)
+	{
+		SDL_Log("Telemetry: shm_open(%s) failed", mSegmentName.c_str());
+		return;
+	}
+
+	void* memory = MAP_FAILED;
+	if (ftruncate(fd, sizeof(Telemetry::Segment)) == 0)
+		memory = mmap(nullptr, sizeof(Telemetry::Segment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+
+	if (memory == MAP_FAILED)
+	{
+		SDL_Log("Telemetry: mapping %s failed", mSegmentName.c_str());
+		shm_unlink(mSegmentName.c_str());
+		return;
+	}
+
+	// Readers check the magic last, so publish the header only after the ring is initialized
+	mSegment = new (memory) Telemetry::Segment();
+	mSegment->capacity = Telemetry::kRingCapacity;
+	mSegment->sampleSize = sizeof(Telemetry::FrameSample);
+	mSegment->version = Telemetry::kVersion;
+	std::atomic_thread_fence(std::memory_order_release);
+	mSegment->magic = Telemetry::kMagic;
+#else
+	SDL_Log("Telemetry: shared memory is not supported on this platform");
+#endif
+}
+
+TelemetryPublisher::~TelemetryPublisher()
+{
+#ifdef ARKANOID_HAS_POSIX_SHM
+	if (mSegment)
+	{
+		munmap(mSegment, sizeof(Telemetry::Segment));
+		shm_unlink(mSegmentName.c_str());
+	}
+#endif
+}
+
+bool TelemetryPublisher::isOpen() const
+{
+	return mSegment != nullptr;
+}
+
+void TelemetryPublisher::publish(const Telemetry::FrameSample& sample)
+{
+	if (!mSegment)
+		return;
+
+	Telemetry::Slot& slot = mSegment->slots[mWriteIndex & (Telemetry::kRingCapacity - 1)];
+
+	// Odd while writing, so readers discard torn copies
+	slot.sequence.store(2 * mWriteIndex + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	slot.sample = sample;
+	slot.sequence.store(2 * (mWriteIndex + 1), std::memory_order_release);
+
+	mWriteIndex++;
+	mSegment->writeIndex.store(mWriteIndex, std::memory_order_release);
+}
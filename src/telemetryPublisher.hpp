@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+
+#include "telemetry.hpp"
+
+// Publishes per-frame stats into a POSIX shared-memory ring that external monitors can attach to.
+// Publishing is wait-free: the game overwrites the oldest sample and never waits for a reader, so a
+// slow or missing monitor cannot stall a frame. On platforms without POSIX shared memory, or if
+// the segment cannot be created, the publisher stays closed and publish() does nothing.
+class TelemetryPublisher final
+{
+public:
+	explicit TelemetryPublisher(const std::string& segmentName = Telemetry::kDefaultSegmentName);
+
+	~TelemetryPublisher();
+
+	TelemetryPublisher(const TelemetryPublisher&) = delete;
+	TelemetryPublisher& operator=(const TelemetryPublisher&) = delete;
+
+	bool isOpen() const;
+
+	void publish(const Telemetry::FrameSample& sample);
+
+private:
+	std::string mSegmentName;
+	Telemetry::Segment* mSegment = nullptr;
+	uint64_t mWriteIndex = 0;
+};
@@ -0,0 +1,137 @@
+#include "threadPool.hpp"
+
+#include <algorithm>
+
+#include "profiler.hpp"
+
+namespace
+{
+	thread_local const ThreadPool* tCurrentPool = nullptr;
+	thread_local uint32_t tCurrentThreadIndex = 0;
+}
+
+ThreadPool::ThreadPool(uint32_t workerCount)
+{
+	if (workerCount == 0)
+		workerCount = std::max(1u, std::thread::hardware_concurrency()) - 1;
+
+	mQueues.reserve(workerCount + 1);
+	for (uint32_t i = 0; i <= workerCount; ++i)
+		mQueues.push_back(std::make_unique<JobQueue>());
+
+	tCurrentPool = this;
+	tCurrentThreadIndex = 0;
+
+	mWorkers.reserve(workerCount);
+	for (uint32_t i = 1; i <= workerCount; ++i)
+		mWorkers.emplace_back([this, i](std::stop_token stopToken) { workerLoop(i, stopToken); });
+}
+
+ThreadPool::~ThreadPool()
+{
+	for (auto& worker : mWorkers)
+		worker.request_stop();
+	mWakeCondition.notify_all();
+	mWorkers.clear();
+
+	if (tCurrentPool == this)
+		tCurrentPool = nullptr;
+}
+
+void ThreadPool::submit(const ThreadPoolJob& job)
+{
+	JobQueue& queue = *mQueues[getCurrentThreadIndex()];
+	bool isQueued = false;
+	{
+		std::scoped_lock lock(queue.mutex);
+		if (queue.count < kQueueCapacity)
+		{
+			queue.jobs[(queue.head + queue.count) % kQueueCapacity] = job;
+			queue.count++;
+			mQueuedJobs.fetch_add(1, std::memory_order_release);
+			isQueued = true;
+		}
+	}
+
+	if (!isQueued)
+	{
+		job.function(job.context, job.index);
+		return;
+	}
+
+	// Taking the wake mutex orders this against a worker that just checked for work and is about to sleep
+	{
+		std::scoped_lock wakeLock(mWakeMutex);
+	}
+	mWakeCondition.notify_one();
+}
+
+bool ThreadPool::runPendingJob()
+{
+	const uint32_t index = getCurrentThreadIndex();
+
+	ThreadPoolJob job;
+	if (!popJob(index, job) && !stealJob(index, job))
+		return false;
+
+	job.function(job.context, job.index);
+	return true;
+}
+
+uint32_t ThreadPool::getThreadCount() const
+{
+	return static_cast<uint32_t>(mQueues.size());
+}
+
+uint32_t ThreadPool::getCurrentThreadIndex() const
+{
+	return tCurrentPool == this ? tCurrentThreadIndex : 0;
+}
+
+void ThreadPool::workerLoop(uint32_t index, std::stop_token stopToken)
+{
+	tCurrentPool = this;
+	tCurrentThreadIndex = index;
+	PROFILE_THREAD("worker");
+
+	while (!stopToken.stop_requested())
+	{
+		if (runPendingJob())
+			continue;
+
+		std::unique_lock lock(mWakeMutex);
+		mWakeCondition.wait(lock, stopToken, [this] { return mQueuedJobs.load(std::memory_order_acquire) > 0; });
+	}
+}
+
+bool ThreadPool::popJob(uint32_t queueIndex, ThreadPoolJob& job)
+{
+	JobQueue& queue = *mQueues[queueIndex];
+	std::scoped_lock lock(queue.mutex);
+	if (queue.count == 0)
+		return false;
+
+	queue.count--;
+	job = queue.jobs[(queue.head + queue.count) % kQueueCapacity];
+	mQueuedJobs.fetch_sub(1, std::memory_order_relaxed);
+	return true;
+}
+
+bool ThreadPool::stealJob(uint32_t thiefIndex, ThreadPoolJob& job)
+{
+	const auto queueCount = static_cast<uint32_t>(mQueues.size());
+	for (uint32_t offset = 1; offset < queueCount; ++offset)
+	{
+		JobQueue& queue = *mQueues[(thiefIndex + offset) % queueCount];
+		std::scoped_lock lock(queue.mutex);
+		if (queue.count == 0)
+			continue;
+
+		job = queue.jobs[queue.head];
+		queue.head = (queue.head + 1) % kQueueCapacity;
+		queue.count--;
+		mQueuedJobs.fetch_sub(1, std::memory_order_relaxed);
+		return true;
+	}
+	return false;
+}
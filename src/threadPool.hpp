@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A unit of work. Plain function pointer plus context, so submitting never allocates.
+struct ThreadPoolJob
+{
+	void (*function)(void* context, uint32_t index) = nullptr;
+	void* context = nullptr;
+	uint32_t index = 0;
+};
+
+// Work-stealing thread pool. Every thread, including the one that owns the pool, has its own
+// bounded job queue: a thread pushes and pops at the back of its own queue (LIFO, cache-warm),
+// and idle threads steal from the front of the others (FIFO, oldest work first).
+class ThreadPool final
+{
+public:
+	static constexpr size_t kQueueCapacity = 256;
+
+	// workerCount additional threads; 0 picks the hardware concurrency minus the owning thread
+	explicit ThreadPool(uint32_t workerCount = 0);
+
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	// Queues a job on the calling thread's queue. Runs it inline when the queue is full.
+	void submit(const ThreadPoolJob& job);
+
+	// Runs one queued job on the calling thread, its own queue first. Returns false if none was found.
+	bool runPendingJob();
+
+	// Worker threads plus the owning thread
+	uint32_t getThreadCount() const;
+
+	// Index of the calling thread in this pool: 0 for the owner, 1..n for workers
+	uint32_t getCurrentThreadIndex() const;
+
+private:
+	struct JobQueue
+	{
+		std::mutex mutex;
+		ThreadPoolJob jobs[kQueueCapacity];
+		size_t head = 0; // Oldest job
+		size_t count = 0;
+	};
+
+	void workerLoop(uint32_t index, std::stop_token stopToken);
+
+	bool popJob(uint32_t queueIndex, ThreadPoolJob& job);
+
+	bool stealJob(uint32_t thiefIndex, ThreadPoolJob& job);
+
+	std::vector<std::unique_ptr<JobQueue>> mQueues;
+	std::vector<std::jthread> mWorkers;
+
+	std::mutex mWakeMutex;
+	std::condition_variable_any mWakeCondition;
+	std::atomic<uint32_t> mQueuedJobs{ 0 };
+};
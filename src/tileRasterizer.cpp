@@ -0,0 +1,313 @@
+#include "tileRasterizer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ARKANOID_RASTER_SSE2 1
+#endif
+
+#include "profiler.hpp"
+
+namespace
+{
+	// x / 255 for x in [0, 255 * 255], rounded
+	constexpr uint32_t divide255(uint32_t x)
+	{
+		x += 128;
+		return (x + (x >> 8)) >> 8;
+	}
+
+	uint32_t blendPixel(uint32_t destination, uint32_t color, uint32_t alpha)
+	{
+		const uint32_t inverse = 255 - alpha;
+		const uint32_t r = divide255(((color >> 16) & 0xFF) * alpha + ((destination >> 16) & 0xFF) * inverse);
+		const uint32_t g = divide255(((color >> 8) & 0xFF) * alpha + ((destination >> 8) & 0xFF) * inverse);
+		const uint32_t b = divide255((color & 0xFF) * alpha + (destination & 0xFF) * inverse);
+		return 0xFF000000 | (r << 16) | (g << 8) | b;
+	}
+
+	void fillSpan(uint32_t* pixels, int32_t count, uint32_t color)
+	{
+		int32_t i = 0;
+#if defined(ARKANOID_RASTER_SSE2)
+		const __m128i value = _mm_set1_epi32(static_cast<int>(color));
+		for (; i + 4 <= count; i += 4)
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(pixels + i), value);
+#endif
+		for (; i < count; ++i)
+			pixels[i] = color;
+	}
+
+	void blendSpan(uint32_t* pixels, int32_t count, uint32_t color, uint32_t alpha)
+	{
+		int32_t i = 0;
+#if defined(ARKANOID_RASTER_SSE2)
+		// Four pixels at a time, widened to 16 bits per channel
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i source = _mm_unpacklo_epi8(_mm_set1_epi32(static_cast<int>(color)), zero);
+		const __m128i sourceTerm = _mm_add_epi16(_mm_mullo_epi16(source, _mm_set1_epi16(static_cast<short>(alpha))), _mm_set1_epi16(128));
+		const __m128i inverse = _mm_set1_epi16(static_cast<short>(255 - alpha));
+		const __m128i opaque = _mm_set1_epi32(static_cast<int>(0xFF000000));
+		auto blend = [&](__m128i destination)
+		{
+			__m128i sum = _mm_add_epi16(sourceTerm, _mm_mullo_epi16(destination, inverse));
+			return _mm_srli_epi16(_mm_add_epi16(sum, _mm_srli_epi16(sum, 8)), 8);
+		};
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128i destination = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + i));
+			const __m128i low = blend(_mm_unpacklo_epi8(destination, zero));
+			const __m128i high = blend(_mm_unpackhi_epi8(destination, zero));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(pixels + i), _mm_or_si128(_mm_packus_epi16(low, high), opaque));
+		}
+#endif
+		for (; i < count; ++i)
+			pixels[i] = blendPixel(pixels[i], color, alpha);
+	}
+
+	void drawSpan(uint32_t* pixels, int32_t count, uint32_t color, uint32_t alpha)
+	{
+		if (alpha == 255)
+			fillSpan(pixels, count, 0xFF000000 | color);
+		else if (alpha > 0)
+			blendSpan(pixels, count, color, alpha);
+	}
+}
+
+TileRasterizer::TileRasterizer(int32_t width, int32_t height)
+{
+	resize(width, height);
+}
+
+void TileRasterizer::resize(int32_t width, int32_t height)
+{
+	mWidth = std::max(width, 0);
+	mHeight = std::max(height, 0);
+	mTileColumns = (mWidth + kTileSize - 1) / kTileSize;
+	mTileRows = (mHeight + kTileSize - 1) / kTileSize;
+	mTileCommands.resize(static_cast<size_t>(mTileColumns) * mTileRows);
+	clear(mClearColor);
+}
+
+int32_t TileRasterizer::getWidth() const
+{
+	return mWidth;
+}
+
+int32_t TileRasterizer::getHeight() const
+{
+	return mHeight;
+}
+
+void TileRasterizer::clear(uint32_t color)
+{
+	mClearColor = 0xFF000000 | color;
+	mCommands.clear();
+	for (auto& commands : mTileCommands)
+		commands.clear();
+}
+
+void TileRasterizer::fillRectangle(float x, float y, float width, float height, uint32_t color)
+{
+	RasterCommand command;
+	command.type = RasterCommand::Type::Rectangle;
+	command.color = color;
+	command.alpha = static_cast<uint8_t>(color >> 24);
+
+	// Pixels whose centers lie inside the rectangle
+	command.x0 = static_cast<int32_t>(std::ceil(x - 0.5f));
+	command.y0 = static_cast<int32_t>(std::ceil(y - 0.5f));
+	command.x1 = static_cast<int32_t>(std::ceil(x + width - 0.5f));
+	command.y1 = static_cast<int32_t>(std::ceil(y + height - 0.5f));
+	record(command);
+}
+
+void TileRasterizer::strokeRectangle(float x, float y, float width, float height, uint32_t color)
+{
+	fillRectangle(x, y, width, 1.f, color);
+	fillRectangle(x, y + height - 1.f, width, 1.f, color);
+	fillRectangle(x, y + 1.f, 1.f, height - 2.f, color);
+	fillRectangle(x + width - 1.f, y + 1.f, 1.f, height - 2.f, color);
+}
+
+void TileRasterizer::fillCircle(float centerX, float centerY, float radius, uint32_t color)
+{
+	RasterCommand command;
+	command.type = RasterCommand::Type::Circle;
+	command.color = color;
+	command.alpha = static_cast<uint8_t>(color >> 24);
+	command.centerX = centerX;
+	command.centerY = centerY;
+	command.radius = radius;
+	command.x0 = static_cast<int32_t>(std::floor(centerX - radius));
+	command.y0 = static_cast<int32_t>(std::floor(centerY - radius));
+	command.x1 = static_cast<int32_t>(std::ceil(centerX + radius)) + 1;
+	command.y1 = static_cast<int32_t>(std::ceil(centerY + radius)) + 1;
+	record(command);
+}
+
+void TileRasterizer::blitGlyph(float x, float y, float width, float height, float sourceX, float sourceWidth, uint32_t color)
+{
+	if (mGlyphMask.empty() || width <= 0.f || height <= 0.f)
+		return;
+
+	RasterCommand command;
+	command.type = RasterCommand::Type::Glyph;
+	command.color = color;
+	command.alpha = static_cast<uint8_t>(color >> 24);
+	command.originX = x;
+	command.originY = y;
+	command.sourceX = sourceX;
+	command.sourceStepX = sourceWidth / width;
+	command.sourceStepY = static_cast<float>(mGlyphMaskHeight) / height;
+	command.x0 = static_cast<int32_t>(std::ceil(x - 0.5f));
+	command.y0 = static_cast<int32_t>(std::ceil(y - 0.5f));
+	command.x1 = static_cast<int32_t>(std::ceil(x + width - 0.5f));
+	command.y1 = static_cast<int32_t>(std::ceil(y + height - 0.5f));
+	record(command);
+}
+
+void TileRasterizer::setGlyphAtlas(std::vector<uint8_t> mask, int32_t width, int32_t height)
+{
+	mGlyphMask = std::move(mask);
+	mGlyphMaskWidth = width;
+	mGlyphMaskHeight = height;
+}
+
+void TileRasterizer::rasterize(uint32_t* pixels, int32_t pitch)
+{
+	PROFILE_ZONE("TileRasterizer::rasterize");
+
+	const auto tileCount = static_cast<uint32_t>(mTileCommands.size());
+	if (tileCount == 0)
+		return;
+
+	mPixels = pixels;
+	mPitch = pitch;
+	mNextTile.store(0, std::memory_order_relaxed);
+
+	// A few jobs per thread, each taking tiles until none are left, so uneven tiles balance out
+	const uint32_t jobCount = std::min({ tileCount, mThreadPool.getThreadCount() * 4, static_cast<uint32_t>(ThreadPool::kQueueCapacity) });
+	mRemainingJobs.store(jobCount, std::memory_order_relaxed);
+	for (uint32_t job = 0; job < jobCount; ++job)
+		mThreadPool.submit({ .function = &TileRasterizer::rasterizeTiles, .context = this, .index = job });
+
+	while (mRemainingJobs.load(std::memory_order_acquire) > 0)
+	{
+		if (!mThreadPool.runPendingJob())
+			std::this_thread::yield();
+	}
+}
+
+size_t TileRasterizer::getCommandCount() const
+{
+	return mCommands.size();
+}
+
+uint32_t TileRasterizer::getThreadCount() const
+{
+	return mThreadPool.getThreadCount();
+}
+
+void TileRasterizer::record(const RasterCommand& command)
+{
+	RasterCommand clipped = command;
+	if (!clip(clipped))
+		return;
+
+	const auto index = static_cast<uint32_t>(mCommands.size());
+	mCommands.push_back(clipped);
+
+	for (int32_t row = clipped.y0 / kTileSize; row <= (clipped.y1 - 1) / kTileSize; ++row)
+	{
+		for (int32_t column = clipped.x0 / kTileSize; column <= (clipped.x1 - 1) / kTileSize; ++column)
+			mTileCommands[static_cast<size_t>(row) * mTileColumns + column].push_back(index);
+	}
+}
+
+void TileRasterizer::rasterizeTiles(void* context, uint32_t)
+{
+	auto& rasterizer = *static_cast<TileRasterizer*>(context);
+	const auto tileCount = static_cast<uint32_t>(rasterizer.mTileCommands.size());
+	for (uint32_t tile = rasterizer.mNextTile.fetch_add(1, std::memory_order_relaxed); tile < tileCount;
+		tile = rasterizer.mNextTile.fetch_add(1, std::memory_order_relaxed))
+		rasterizer.rasterizeTile(tile);
+
+	rasterizer.mRemainingJobs.fetch_sub(1, std::memory_order_release);
+}
+
+void TileRasterizer::rasterizeTile(uint32_t tile) const
+{
+	const int32_t tileX0 = static_cast<int32_t>(tile % mTileColumns) * kTileSize;
+	const int32_t tileY0 = static_cast<int32_t>(tile / mTileColumns) * kTileSize;
+	const int32_t tileX1 = std::min(tileX0 + kTileSize, mWidth);
+	const int32_t tileY1 = std::min(tileY0 + kTileSize, mHeight);
+
+	for (int32_t y = tileY0; y < tileY1; ++y)
+		fillSpan(mPixels + static_cast<ptrdiff_t>(y) * mPitch + tileX0, tileX1 - tileX0, mClearColor);
+
+	for (const uint32_t index : mTileCommands[tile])
+	{
+		const RasterCommand& command = mCommands[index];
+		const int32_t x0 = std::max(command.x0, tileX0);
+		const int32_t x1 = std::min(command.x1, tileX1);
+		const int32_t y0 = std::max(command.y0, tileY0);
+		const int32_t y1 = std::min(command.y1, tileY1);
+		const uint32_t color = command.color & 0xFFFFFF;
+
+		switch (command.type)
+		{
+			case RasterCommand::Type::Rectangle:
+				for (int32_t y = y0; y < y1; ++y)
+					drawSpan(mPixels + static_cast<ptrdiff_t>(y) * mPitch + x0, x1 - x0, color, command.alpha);
+				break;
+
+			case RasterCommand::Type::Circle:
+			{
+				// Span of pixel centers inside the circle on every row
+				const float radiusSquared = command.radius * command.radius;
+				for (int32_t y = y0; y < y1; ++y)
+				{
+					const float dy = static_cast<float>(y) + 0.5f - command.centerY;
+					if (dy * dy > radiusSquared)
+						continue;
+
+					const float halfWidth = std::sqrt(radiusSquared - dy * dy);
+					const int32_t spanX0 = std::max(x0, static_cast<int32_t>(std::ceil(command.centerX - halfWidth - 0.5f)));
+					const int32_t spanX1 = std::min(x1, static_cast<int32_t>(std::floor(command.centerX + halfWidth - 0.5f)) + 1);
+					if (spanX0 < spanX1)
+						drawSpan(mPixels + static_cast<ptrdiff_t>(y) * mPitch + spanX0, spanX1 - spanX0, color, command.alpha);
+				}
+				break;
+			}
+
+			case RasterCommand::Type::Glyph:
+				for (int32_t y = y0; y < y1; ++y)
+				{
+					const auto sourceY = std::min(static_cast<int32_t>((static_cast<float>(y) + 0.5f - command.originY) * command.sourceStepY), mGlyphMaskHeight - 1);
+					const uint8_t* maskRow = mGlyphMask.data() + static_cast<ptrdiff_t>(sourceY) * mGlyphMaskWidth;
+					uint32_t* row = mPixels + static_cast<ptrdiff_t>(y) * mPitch;
+					for (int32_t x = x0; x < x1; ++x)
+					{
+						const auto sourceX = std::min(static_cast<int32_t>(command.sourceX + (static_cast<float>(x) + 0.5f - command.originX) * command.sourceStepX), mGlyphMaskWidth - 1);
+						const uint32_t alpha = divide255(maskRow[sourceX] * uint32_t{ command.alpha });
+						if (alpha > 0)
+							row[x] = blendPixel(row[x], color, alpha);
+					}
+				}
+				break;
+		}
+	}
+}
+
+bool TileRasterizer::clip(RasterCommand& command) const
+{
+	command.x0 = std::clamp(command.x0, 0, mWidth);
+	command.x1 = std::clamp(command.x1, 0, mWidth);
+	command.y0 = std::clamp(command.y0, 0, mHeight);
+	command.y1 = std::clamp(command.y1, 0, mHeight);
+	return command.x0 < command.x1 && command.y0 < command.y1 && command.alpha > 0;
+}
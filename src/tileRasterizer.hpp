@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "threadPool.hpp"
+
+// Drawing command in pixel coordinates. Bounds are clipped to the framebuffer when recorded.
+struct RasterCommand
+{
+	enum class Type : uint8_t
+	{
+		Rectangle,
+		Circle,
+		Glyph // Alpha mask from the glyph atlas, scaled nearest-neighbour into the bounds
+	};
+
+	Type type = Type::Rectangle;
+	uint8_t alpha = 255;
+	uint32_t color = 0; // 0xAARRGGBB
+	int32_t x0 = 0, y0 = 0, x1 = 0, y1 = 0; // Covered pixels [x0, x1) x [y0, y1)
+	float centerX = 0.f, centerY = 0.f, radius = 0.f; // Circle
+	float originX = 0.f, originY = 0.f; // Glyph: unclipped top-left corner on screen
+	float sourceX = 0.f, sourceStepX = 0.f, sourceStepY = 0.f; // Glyph: atlas column of originX and atlas pixels per screen pixel
+};
+
+// CPU rasterizer for the renderer's shapes. Commands of a frame are binned into square tiles, and the
+// tiles are rasterized in parallel on a thread pool straight into the target pixels, each by one thread
+// in submission order. Pixels are XRGB8888.
+class TileRasterizer final
+{
+public:
+	static constexpr int32_t kTileSize = 64;
+
+	TileRasterizer(int32_t width, int32_t height);
+
+	void resize(int32_t width, int32_t height);
+
+	int32_t getWidth() const;
+
+	int32_t getHeight() const;
+
+	// Drops all recorded commands and fills the frame with color when it is rasterized
+	void clear(uint32_t color);
+
+	void fillRectangle(float x, float y, float width, float height, uint32_t color);
+
+	// One pixel wide outline on the inside of the rectangle
+	void strokeRectangle(float x, float y, float width, float height, uint32_t color);
+
+	void fillCircle(float centerX, float centerY, float radius, uint32_t color);
+
+	// Blits atlas columns [sourceX, sourceX + sourceWidth) scaled to the screen rectangle, tinted with color
+	void blitGlyph(float x, float y, float width, float height, float sourceX, float sourceWidth, uint32_t color);
+
+	// Alpha mask of the glyph atlas, one byte per pixel
+	void setGlyphAtlas(std::vector<uint8_t> mask, int32_t width, int32_t height);
+
+	// Rasterizes all recorded commands into pixels, pitch given in pixels
+	void rasterize(uint32_t* pixels, int32_t pitch);
+
+	size_t getCommandCount() const;
+
+	uint32_t getThreadCount() const;
+
+private:
+	void record(const RasterCommand& command);
+
+	static void rasterizeTiles(void* context, uint32_t index);
+
+	void rasterizeTile(uint32_t tile) const;
+
+	// Returns the bounds clipped to the framebuffer, false when nothing is left
+	bool clip(RasterCommand& command) const;
+
+	int32_t mWidth = 0;
+	int32_t mHeight = 0;
+	int32_t mTileColumns = 0;
+	int32_t mTileRows = 0;
+	uint32_t mClearColor = 0xFF000000;
+
+	std::vector<RasterCommand> mCommands;
+	std::vector<std::vector<uint32_t>> mTileCommands; // Command indices per tile, in submission order
+
+	std::vector<uint8_t> mGlyphMask;
+	int32_t mGlyphMaskWidth = 0;
+	int32_t mGlyphMaskHeight = 0;
+
+	// Frame being rasterized
+	uint32_t* mPixels = nullptr;
+	int32_t mPitch = 0;
+	std::atomic<uint32_t> mNextTile{ 0 };
+	std::atomic<uint32_t> mRemainingJobs{ 0 };
+
+	ThreadPool mThreadPool;
+};
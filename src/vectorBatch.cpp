@@ -0,0 +1,187 @@
+#include "vectorBatch.hpp"
+
+#include <cassert>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ARKANOID_VECTOR_BATCH_SSE2 1
+#endif
+
+namespace
+{
+	const float* floats(std::span<const Vector2> v)
+	{
+		return &v.data()->x;
+	}
+
+	float* floats(std::span<Vector2> v)
+	{
+		return &v.data()->x;
+	}
+
+#if defined(ARKANOID_VECTOR_BATCH_SSE2)
+	// Four interleaved vectors in two registers -> their x and y components in one register each
+	void deinterleave(__m128 low, __m128 high, __m128& x, __m128& y)
+	{
+		x = _mm_shuffle_ps(low, high, _MM_SHUFFLE(2, 0, 2, 0));
+		y = _mm_shuffle_ps(low, high, _MM_SHUFFLE(3, 1, 3, 1));
+	}
+#endif
+}
+
+namespace VectorBatch
+{
+	void add(std::span<const Vector2> a, std::span<const Vector2> b, std::span<Vector2> out)
+	{
+		assert(a.size() == out.size() && b.size() == out.size());
+
+		const float* pa = floats(a);
+		const float* pb = floats(b);
+		float* po = floats(out);
+		const size_t count = out.size() * 2;
+		size_t i = 0;
+#if defined(ARKANOID_VECTOR_BATCH_SSE2)
+		for (; i + 4 <= count; i += 4)
+			_mm_storeu_ps(po + i, _mm_add_ps(_mm_loadu_ps(pa + i), _mm_loadu_ps(pb + i)));
+#endif
+		for (; i < count; ++i)
+			po[i] = pa[i] + pb[i];
+	}
+
+	void multiply(std::span<const Vector2> a, std::span<const Vector2> b, std::span<Vector2> out)
+	{
+		assert(a.size() == out.size() && b.size() == out.size());
+
+		const float* pa = floats(a);
+		const float* pb = floats(b);
+		float* po = floats(out);
+		const size_t count = out.size() * 2;
+		size_t i = 0;
+#if defined(ARKANOID_VECTOR_BATCH_SSE2)
+		for (; i + 4 <= count; i += 4)
+			_mm_storeu_ps(po + i, _mm_mul_ps(_mm_loadu_ps(pa + i), _mm_loadu_ps(pb + i)));
+#endif
+		for (; i < count; ++i)
+			po[i] = pa[i] * pb[i];
+	}
+
+	void scale(std::span<const Vector2> a, float s, std::span<Vector2> out)
+	{
+		assert(a.size() == out.size());
+
+		const float* pa = floats(a);
+		float* po = floats(out);
+		const size_t count = out.size() * 2;
+		size_t i = 0;
+#if defined(ARKANOID_VECTOR_BATCH_SSE2)
+		const __m128 factor = _mm_set1_ps(s);
+		for (; i + 4 <= count; i += 4)
+			_mm_storeu_ps(po + i, _mm_mul_ps(_mm_loadu_ps(pa + i), factor));
+#endif
+		for (; i < count; ++i)
+			po[i] = pa[i] * s;
+	}
+
+	void multiplyAdd(std::span<const Vector2> a, std::span<const Vector2> b, float s, std::span<Vector2> out)
+	{
+		assert(a.size() == out.size() && b.size() == out.size());
+
+		const float* pa = floats(a);
+		const float* pb = floats(b);
+		float* po = floats(out);
+		const size_t count = out.size() * 2;
+		size_t i = 0;
+#if defined(ARKANOID_VECTOR_BATCH_SSE2)
+		const __m128 factor = _mm_set1_ps(s);
+		for (; i + 4 <= count; i += 4)
+			_mm_storeu_ps(po + i, _mm_add_ps(_mm_loadu_ps(pa + i), _mm_mul_ps(_mm_loadu_ps(pb + i), factor)));
+#endif
+		for (; i < count; ++i)
+			po[i] = pa[i] + pb[i] * s;
+	}
+
+	void dot(std::span<const Vector2> a, std::span<const Vector2> b, std::span<float> out)
+	{
+		assert(a.size() == out.size() && b.size() == out.size());
+
+		size_t i = 0;
+#if defined(ARKANOID_VECTOR_BATCH_SSE2)
+		const float* pa = floats(a);
+		const float* pb = floats(b);
+		for (; i + 4 <= out.size(); i += 4)
+		{
+			__m128 x, y;
+			deinterleave(_mm_mul_ps(_mm_loadu_ps(pa + i * 2), _mm_loadu_ps(pb + i * 2)),
+				_mm_mul_ps(_mm_loadu_ps(pa + i * 2 + 4), _mm_loadu_ps(pb + i * 2 + 4)), x, y);
+			_mm_storeu_ps(out.data() + i, _mm_add_ps(x, y));
+		}
+#endif
+		for (; i < out.size(); ++i)
+			out[i] = ::dot(a[i], b[i]);
+	}
+
+	void normalize(std::span<const Vector2> v, std::span<Vector2> out)
+	{
+		assert(v.size() == out.size());
+
+		size_t i = 0;
+#if defined(ARKANOID_VECTOR_BATCH_SSE2)
+		const float* pv = floats(v);
+		float* po = floats(out);
+		const __m128 zero = _mm_setzero_ps();
+		for (; i + 4 <= out.size(); i += 4)
+		{
+			const __m128 low = _mm_loadu_ps(pv + i * 2);
+			const __m128 high = _mm_loadu_ps(pv + i * 2 + 4);
+			__m128 x, y;
+			deinterleave(low, high, x, y);
+
+			const __m128 squared = _mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y));
+			const __m128 length = _mm_sqrt_ps(squared);
+			const __m128 nonZero = _mm_cmpgt_ps(squared, zero);
+
+			// Divide like the scalar operator, then clear the lanes of zero vectors
+			_mm_storeu_ps(po + i * 2, _mm_and_ps(_mm_div_ps(low, _mm_unpacklo_ps(length, length)), _mm_unpacklo_ps(nonZero, nonZero)));
+			_mm_storeu_ps(po + i * 2 + 4, _mm_and_ps(_mm_div_ps(high, _mm_unpackhi_ps(length, length)), _mm_unpackhi_ps(nonZero, nonZero)));
+		}
+#endif
+		for (; i < out.size(); ++i)
+			out[i] = lengthSquared(v[i]) > 0.f ? ::normalize(v[i]) : Vector2{};
+	}
+
+	void normalizeFast(std::span<const Vector2> v, std::span<Vector2> out)
+	{
+		assert(v.size() == out.size());
+
+		size_t i = 0;
+#if defined(ARKANOID_VECTOR_BATCH_SSE2)
+		const float* pv = floats(v);
+		float* po = floats(out);
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 half = _mm_set1_ps(0.5f);
+		const __m128 threeHalves = _mm_set1_ps(1.5f);
+		for (; i + 4 <= out.size(); i += 4)
+		{
+			const __m128 low = _mm_loadu_ps(pv + i * 2);
+			const __m128 high = _mm_loadu_ps(pv + i * 2 + 4);
+			__m128 x, y;
+			deinterleave(low, high, x, y);
+
+			const __m128 squared = _mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y));
+
+			// The estimate has a relative error of up to 1.5 * 2^-12; one Newton-Raphson step squares it
+			__m128 inverse = _mm_rsqrt_ps(squared);
+			inverse = _mm_mul_ps(inverse, _mm_sub_ps(threeHalves, _mm_mul_ps(_mm_mul_ps(half, squared), _mm_mul_ps(inverse, inverse))));
+			inverse = _mm_and_ps(inverse, _mm_cmpgt_ps(squared, zero));
+
+			_mm_storeu_ps(po + i * 2, _mm_mul_ps(low, _mm_unpacklo_ps(inverse, inverse)));
+			_mm_storeu_ps(po + i * 2 + 4, _mm_mul_ps(high, _mm_unpackhi_ps(inverse, inverse)));
+		}
+#endif
+		for (; i < out.size(); ++i)
+		{
+			const float squared = lengthSquared(v[i]);
+			out[i] = squared > 0.f ? v[i] * (1.f / std::sqrt(squared)) : Vector2{};
+		}
+	}
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <span>
+
+#include "math.hpp"
+
+static_assert(sizeof(Vector2) == 2 * sizeof(float), "Batch math treats Vector2 arrays as interleaved floats");
+
+// Vector2 operations over whole arrays, two to four vectors per SSE2 instruction where available and a
+// scalar loop otherwise. All spans of one call have the same size; out may alias an input.
+// add, multiply, scale and normalize round exactly like the scalar operators of math.hpp.
+namespace VectorBatch
+{
+	// Largest relative error of normalizeFast against normalize, per component and in length
+	constexpr float kFastNormalizeMaxError = 1e-6f;
+
+	// out[i] = a[i] + b[i]
+	void add(std::span<const Vector2> a, std::span<const Vector2> b, std::span<Vector2> out);
+
+	// out[i] = a[i] * b[i], per component
+	void multiply(std::span<const Vector2> a, std::span<const Vector2> b, std::span<Vector2> out);
+
+	// out[i] = a[i] * s
+	void scale(std::span<const Vector2> a, float s, std::span<Vector2> out);
+
+	// out[i] = a[i] + b[i] * s, e.g. integrating positions with velocities
+	void multiplyAdd(std::span<const Vector2> a, std::span<const Vector2> b, float s, std::span<Vector2> out);
+
+	// out[i] = dot(a[i], b[i])
+	void dot(std::span<const Vector2> a, std::span<const Vector2> b, std::span<float> out);
+
+	// out[i] = normalize(v[i]), but a zero vector stays zero instead of turning into NaN
+	void normalize(std::span<const Vector2> v, std::span<Vector2> out);
+
+	// Reciprocal square root estimate refined by one Newton-Raphson step, within kFastNormalizeMaxError.
+	// Zero vectors stay zero; lengths must stay within about 1e-18..1e18 so the squared length is a normal float.
+	void normalizeFast(std::span<const Vector2> v, std::span<Vector2> out);
+}
@@ -6,11 +6,11 @@ class Wall final : public GameObject
 public:
 	Wall(const Vector2& position, const Vector2& size, const SDL_Color& color);
 
-	void render(const Renderer& renderer) const override;
+	void render(const Renderer& renderer) const;
 
 	Vector2 getSize() const;
 
-	AABB getAABB() const override;
+	AABB getAABB() const;
 
 private:
 	Vector2 mSize;
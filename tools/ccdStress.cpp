@@ -0,0 +1,423 @@
+// Randomized stress test of the ball's continuous collision loop (Physics::moveBall).
+//
+// Fires millions of seeded single-tick shots into a full block field, the walls and a moving platform
+// and counts how many CCD iterations each one needs, once without a practical cap and once with the
+// game's iteration budget. Besides uniformly random shots it aims at the cases that make the loop take
+// many steps: near-parallel grazes along faces and block seams, and wedges into concave corners.
+// Blocks survive every hit, like reinforced ones, so nothing breaks a bounce cycle early.
+//
+// Usage: CcdStress [--shots N] [--seed N] [--threads N] [--budget N] [--top N] [--shot INDEX]
+//
+// Every shot is a pure function of (seed, index), so the worst shots it reports can be replayed step by
+// step with --shot INDEX and the same --seed. Exits with code 1 when a budgeted shot ends with the ball
+// inside something or with a non-finite position.
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <format>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "counterRng.hpp"
+#include "gameConfig.hpp"
+#include "gameRules.hpp"
+#include "physics.hpp"
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	using GameConfig::kViewSize;
+	using GameConfig::kWallThickness;
+	constexpr float kPlatformY = GameConfig::kDefaultPlatformStartPosition.y;
+	constexpr uint32_t kUnboundedIterations = 1u << 16; // Only there so a true livelock still terminates
+	constexpr float kPenetrationTolerance = 0.01f;
+
+	enum class ShotKind : uint8_t
+	{
+		Random,
+		Graze,   // Almost parallel to a face, almost touching it
+		Wedge,   // Into a concave corner between a wall and the blocks or the platform
+		Count
+	};
+
+	constexpr std::array kShotKindNames = { "random", "graze", "wedge" };
+
+	struct StressOptions
+	{
+		uint64_t shotCount = 1'000'000;
+		uint64_t seed = 1;
+		uint32_t threadCount = 0; // All hardware threads
+		uint32_t budget = GameConfig::kCcdIterationBudget;
+		size_t topCount = 10;
+		std::optional<uint64_t> replayShot;
+	};
+
+	struct Shot
+	{
+		ShotKind kind = ShotKind::Random;
+		Vector2 position;
+		Vector2 direction;
+		float speed = 0.f;
+		float deltaTime = 0.f;
+		float platformMove = 0.f; // Platform displacement over the tick along x
+	};
+
+	struct ShotResult
+	{
+		uint64_t index = 0;
+		ShotKind kind = ShotKind::Random;
+		uint32_t iterations = 0; // Unbounded
+		float droppedFraction = 0.f; // Share of the tick distance the budget dropped
+	};
+
+	struct StressStats
+	{
+		CcdStats unbounded;
+		CcdStats budgeted;
+		std::array<CcdStats, static_cast<size_t>(ShotKind::Count)> unboundedByKind;
+		uint64_t rejectedShots = 0; // Start positions inside something, drawn again
+		uint64_t penetrations = 0;
+		uint64_t nonFinite = 0;
+		double droppedFraction = 0.0;
+		std::vector<ShotResult> worst; // Sorted by iterations, most first
+	};
+
+	StressOptions parseOptions(int argc, char* argv[])
+	{
+		StressOptions options;
+		for (int i = 1; i < argc; ++i)
+		{
+			const std::string_view arg = argv[i];
+			if (arg == "--shots" && i + 1 < argc)
+				options.shotCount = std::max<uint64_t>(1, std::stoull(argv[++i]));
+			else if (arg == "--seed" && i + 1 < argc)
+				options.seed = std::stoull(argv[++i]);
+			else if (arg == "--threads" && i + 1 < argc)
+				options.threadCount = static_cast<uint32_t>(std::stoul(argv[++i]));
+			else if (arg == "--budget" && i + 1 < argc)
+				options.budget = static_cast<uint32_t>(std::stoul(argv[++i]));
+			else if (arg == "--top" && i + 1 < argc)
+				options.topCount = std::stoul(argv[++i]);
+			else if (arg == "--shot" && i + 1 < argc)
+				options.replayShot = std::stoull(argv[++i]);
+			else
+				throw std::invalid_argument(std::format("Unknown argument: {}", arg));
+		}
+
+		if (options.budget == 0)
+			throw std::invalid_argument("--budget needs at least one collision step");
+
+		if (options.threadCount == 0)
+			options.threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+		return options;
+	}
+
+	// The game's walls and a full block field; the platform is set per shot
+	CollisionContext makeScene()
+	{
+		CollisionContext context;
+		context.walls = GameRules::getWalls();
+
+		for (uint32_t row = 0; row < GameConfig::kBlockRowCount; ++row)
+		{
+			for (uint32_t column = 0; column < GameConfig::kBlockColumnCount; ++column)
+			{
+				const Vector2 min = GameConfig::kLevelOrigin + Vector2{ static_cast<float>(column), static_cast<float>(row) } * GameConfig::kBlockSize;
+				context.blockAABBs.push_back({ min, min + GameConfig::kBlockSize });
+				context.blockHandles.push_back({ .chunk = 0, .index = row * static_cast<uint32_t>(GameConfig::kBlockColumnCount) + column });
+			}
+		}
+		return context;
+	}
+
+	AABB platformAt(float x)
+	{
+		const Vector2 center{ x, kPlatformY };
+		return { center - GameConfig::kPlatformSize * 0.5f, center + GameConfig::kPlatformSize * 0.5f };
+	}
+
+	// Deepest overlap of a ball at position with anything in the context, 0 when it is clear
+	float penetration(const Vector2& position, const CollisionContext& context)
+	{
+		float deepest = 0.f;
+		auto check = [&](const AABB& box)
+		{
+			const Vector2 closest{ std::clamp(position.x, box.min.x, box.max.x), std::clamp(position.y, box.min.y, box.max.y) };
+			deepest = std::max(deepest, GameConfig::kBallRadius - length(position - closest));
+		};
+
+		for (const AABB& wall : context.walls)
+			check(wall);
+		for (const AABB& block : context.blockAABBs)
+			check(block);
+		if (context.platform)
+			check(*context.platform);
+		return deepest;
+	}
+
+	Vector2 fromAngle(float angle)
+	{
+		return { std::cos(angle), std::sin(angle) };
+	}
+
+	// A face of the scene to graze: a point on it and its outward normal. Inner block sides touch their
+	// neighbours, so the block field only offers its bottom row of faces and the seams between them.
+	struct Surface
+	{
+		Vector2 point;
+		Vector2 normal;
+	};
+
+	Surface pickSurface(CounterRng& rng, const CollisionContext& context)
+	{
+		const float along = rng.nextUniform();
+		const uint32_t choice = static_cast<uint32_t>(rng.next() % 4);
+		const AABB& platform = *context.platform;
+		switch (choice)
+		{
+			case 0: return { { kWallThickness, kWallThickness + along * (kViewSize - kWallThickness) }, { 1.f, 0.f } };
+			case 1: return { { kViewSize - kWallThickness, kWallThickness + along * (kViewSize - kWallThickness) }, { -1.f, 0.f } };
+			case 2:
+			{
+				const AABB& lastRow = context.blockAABBs.back();
+				return { { kWallThickness + along * (kViewSize - 2.f * kWallThickness), lastRow.max.y }, { 0.f, 1.f } };
+			}
+			default: return { { platform.min.x + along * (platform.max.x - platform.min.x), platform.min.y }, { 0.f, -1.f } };
+		}
+	}
+
+	// Draws the shot with the given index; empty when its start position is inside something
+	std::optional<Shot> makeShot(uint64_t seed, uint64_t index, CollisionContext& context)
+	{
+		CounterRng rng(CounterRng(seed).at(index));
+		Shot shot;
+		shot.kind = static_cast<ShotKind>(rng.next() % static_cast<uint64_t>(ShotKind::Count));
+
+		// Default speed up to forty booster hits; mostly 60 Hz ticks, sometimes a hitch
+		shot.speed = GameConfig::kDefaultBallSpeed + GameConfig::kBallSpeedIncrement * static_cast<float>(rng.next() % 41);
+		shot.deltaTime = rng.nextUniform() < 0.9f ? 1.f / 60.f : 1.f / 60.f + rng.nextUniform() * 0.1f;
+		shot.platformMove = rng.nextUniform() < 0.5f ? 0.f : (rng.nextUniform() * 2.f - 1.f) * GameConfig::kPlatformSpeed * shot.deltaTime;
+
+		const float halfPlatform = GameConfig::kPlatformSize.x * 0.5f;
+		const float platformX = kWallThickness + halfPlatform + rng.nextUniform() * (kViewSize - 2.f * (kWallThickness + halfPlatform));
+		context.platform = platformAt(platformX);
+		context.platformDisplacement = { shot.platformMove, 0.f };
+		context.platformDirection = { shot.platformMove / shot.deltaTime, 0.f };
+
+		const float radius = GameConfig::kBallRadius;
+		switch (shot.kind)
+		{
+			case ShotKind::Random:
+			{
+				shot.position = { kWallThickness + radius + rng.nextUniform() * (kViewSize - 2.f * (kWallThickness + radius)),
+					kWallThickness + radius + rng.nextUniform() * (kViewSize - kWallThickness - 2.f * radius) };
+				shot.direction = fromAngle(rng.nextUniform() * 2.f * pi);
+				break;
+			}
+			case ShotKind::Graze:
+			{
+				// Up to a thousandth of a unit off the face, 1e-6 to 0.1 radians into it
+				const Surface surface = pickSurface(rng, context);
+				const Vector2 tangent = Vector2{ -surface.normal.y, surface.normal.x } * (rng.nextUniform() < 0.5f ? -1.f : 1.f);
+				const float gap = rng.nextUniform() * 1e-3f;
+				const float angle = std::pow(10.f, -6.f + 5.f * rng.nextUniform());
+				shot.position = surface.point + surface.normal * (radius + gap);
+				shot.direction = normalize(tangent * std::cos(angle) - surface.normal * std::sin(angle));
+				break;
+			}
+			case ShotKind::Wedge:
+			{
+				// Into one of the concave corners: a wall under the block field, or a wall next to a platform pushed against it
+				const uint32_t corner = static_cast<uint32_t>(rng.next() % 4);
+				const bool right = corner % 2 == 1;
+				const bool platformCorner = corner >= 2;
+				if (platformCorner)
+				{
+					const float x = right ? kViewSize - kWallThickness - halfPlatform : kWallThickness + halfPlatform;
+					context.platform = platformAt(x);
+					context.platformDisplacement = { right ? std::max(shot.platformMove, 0.f) : std::min(shot.platformMove, 0.f), 0.f };
+					context.platformDirection = context.platformDisplacement / shot.deltaTime;
+				}
+
+				const Vector2 wallNormal{ right ? -1.f : 1.f, 0.f };
+				const Vector2 floorNormal = platformCorner ? Vector2{ 0.f, -1.f } : Vector2{ 0.f, 1.f };
+				const Vector2 cornerPoint{ right ? kViewSize - kWallThickness : kWallThickness,
+					platformCorner ? context.platform->min.y : GameConfig::kLevelOrigin.y + GameConfig::kBlockSize.y * static_cast<float>(GameConfig::kBlockRowCount) };
+				const float angle = rng.nextUniform() * 0.5f * pi;
+				shot.position = cornerPoint + wallNormal * (radius + rng.nextUniform() * 2.f) + floorNormal * (radius + rng.nextUniform() * 2.f);
+				shot.direction = -(wallNormal * std::cos(angle) + floorNormal * std::sin(angle));
+				break;
+			}
+			case ShotKind::Count:
+				break;
+		}
+
+		if (!std::isfinite(shot.position.x) || !std::isfinite(shot.position.y) || shot.position.y > kViewSize
+			|| penetration(shot.position, context) > 0.f)
+			return std::nullopt;
+
+		return shot;
+	}
+
+	Ball makeBall(const Shot& shot)
+	{
+		Ball ball(shot.position, GameConfig::kBallRadius, shot.speed);
+		ball.setDirection(shot.direction);
+		return ball;
+	}
+
+	void insertWorst(std::vector<ShotResult>& worst, const ShotResult& result, size_t topCount)
+	{
+		if (topCount == 0 || (worst.size() == topCount && worst.back().iterations >= result.iterations))
+			return;
+
+		const auto at = std::ranges::upper_bound(worst, result.iterations, std::greater{}, &ShotResult::iterations);
+		worst.insert(at, result);
+		if (worst.size() > topCount)
+			worst.pop_back();
+	}
+
+	StressStats runShots(const StressOptions& options, uint32_t thread)
+	{
+		StressStats stats;
+		CollisionContext context = makeScene();
+		auto noHitHandling = [](const PhysicsHitResult&) {};
+
+		for (uint64_t index = thread; index < options.shotCount; index += options.threadCount)
+		{
+			const std::optional<Shot> shot = makeShot(options.seed, index, context);
+			if (!shot)
+			{
+				stats.rejectedShots++;
+				continue;
+			}
+
+			const float distance = shot->speed * shot->deltaTime;
+
+			Ball unboundedBall = makeBall(*shot);
+			const CcdResult unbounded = Physics::moveBall(unboundedBall, distance, context, kUnboundedIterations, noHitHandling);
+			stats.unbounded.record(unbounded);
+			stats.unboundedByKind[static_cast<size_t>(shot->kind)].record(unbounded);
+
+			Ball ball = makeBall(*shot);
+			const CcdResult budgeted = Physics::moveBall(ball, distance, context, options.budget, noHitHandling);
+			stats.budgeted.record(budgeted);
+			stats.droppedFraction += budgeted.droppedDistance / distance;
+
+			const Vector2 end = ball.getPosition();
+			if (!std::isfinite(end.x) || !std::isfinite(end.y))
+				stats.nonFinite++;
+			else if (penetration(end, context) > kPenetrationTolerance)
+				stats.penetrations++;
+
+			insertWorst(stats.worst, {
+				.index = index,
+				.kind = shot->kind,
+				.iterations = unbounded.iterations,
+				.droppedFraction = budgeted.droppedDistance / distance
+			}, options.topCount);
+		}
+		return stats;
+	}
+
+	void replayShot(const StressOptions& options, uint64_t index)
+	{
+		CollisionContext context = makeScene();
+		const std::optional<Shot> shot = makeShot(options.seed, index, context);
+		if (!shot)
+		{
+			std::cout << std::format("shot {} starts inside the scene and is not fired\n", index);
+			return;
+		}
+
+		const float distance = shot->speed * shot->deltaTime;
+		std::cout << std::format("shot {} ({}): position ({:.6f}, {:.6f}) direction ({:.9f}, {:.9f}) speed {} dt {:.6f} distance {:.4f} platform move {:.4f}\n",
+			index, kShotKindNames[static_cast<size_t>(shot->kind)], shot->position.x, shot->position.y,
+			shot->direction.x, shot->direction.y, shot->speed, shot->deltaTime, distance, shot->platformMove);
+
+		Ball ball = makeBall(*shot);
+		uint32_t step = 0;
+		const CcdResult result = Physics::moveBall(ball, distance, context, kUnboundedIterations, [&](const PhysicsHitResult& hit)
+		{
+			const std::string surface = hit.hitBlock ? std::format("block {}", *hit.hitBlock) : hit.hitPlatform ? "platform" : "wall";
+			std::cout << std::format("  step {:4}: {:<9} traveled {:.9f}  position ({:.6f}, {:.6f})  direction ({:.9f}, {:.9f})\n",
+				++step, surface, hit.traveled, hit.newPosition.x, hit.newPosition.y, hit.newDirection.x, hit.newDirection.y);
+		});
+
+		Ball budgetedBall = makeBall(*shot);
+		const CcdResult budgeted = Physics::moveBall(budgetedBall, distance, context, options.budget, [](const PhysicsHitResult&) {});
+		std::cout << std::format("{} iterations, ends at ({:.6f}, {:.6f}); with a budget of {}: {} iterations, {:.4f} dropped, ends at ({:.6f}, {:.6f}), penetration {:.6f}\n",
+			result.iterations, ball.getPosition().x, ball.getPosition().y, options.budget, budgeted.iterations, budgeted.droppedDistance,
+			budgetedBall.getPosition().x, budgetedBall.getPosition().y, penetration(budgetedBall.getPosition(), context));
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	try
+	{
+		const StressOptions options = parseOptions(argc, argv);
+		if (options.replayShot)
+		{
+			replayShot(options, *options.replayShot);
+			return 0;
+		}
+
+		std::cout << std::format("{} shots, seed {}, budget {}, {} threads\n", options.shotCount, options.seed, options.budget, options.threadCount);
+
+		const auto start = Clock::now();
+		std::vector<StressStats> threadStats(options.threadCount);
+		{
+			std::vector<std::jthread> threads;
+			for (uint32_t thread = 0; thread < options.threadCount; ++thread)
+				threads.emplace_back([&, thread] { threadStats[thread] = runShots(options, thread); });
+		}
+		const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+		StressStats total;
+		for (const StressStats& stats : threadStats)
+		{
+			total.unbounded.merge(stats.unbounded);
+			total.budgeted.merge(stats.budgeted);
+			for (size_t kind = 0; kind < total.unboundedByKind.size(); ++kind)
+				total.unboundedByKind[kind].merge(stats.unboundedByKind[kind]);
+			total.rejectedShots += stats.rejectedShots;
+			total.penetrations += stats.penetrations;
+			total.nonFinite += stats.nonFinite;
+			total.droppedFraction += stats.droppedFraction;
+			for (const ShotResult& result : stats.worst)
+				insertWorst(total.worst, result, options.topCount);
+		}
+
+		std::cout << std::format("{:.2f} s, {:.2f} M shots/s, {} start positions rejected\n",
+			seconds, static_cast<double>(options.shotCount) / seconds / 1e6, total.rejectedShots);
+		std::cout << std::format("unbounded  {}\n", total.unbounded.toString());
+		for (size_t kind = 0; kind < total.unboundedByKind.size(); ++kind)
+			std::cout << std::format("  {:<8} {}\n", kShotKindNames[kind], total.unboundedByKind[kind].toString());
+		std::cout << std::format("budgeted   {}\n", total.budgeted.toString());
+		std::cout << std::format("  dropped {:.6f}% of all tick distance, {} ended inside something, {} non-finite\n",
+			100.0 * total.droppedFraction / static_cast<double>(std::max<uint64_t>(total.budgeted.updates, 1)), total.penetrations, total.nonFinite);
+
+		std::cout << std::format("worst shots (replay with --shot INDEX --seed {}):\n", options.seed);
+		for (const ShotResult& result : total.worst)
+			std::cout << std::format("  shot {:<10} {:<8} {:>7} iterations, budget dropped {:.2f}% of the tick\n",
+				result.index, kShotKindNames[static_cast<size_t>(result.kind)], result.iterations, 100.0 * result.droppedFraction);
+
+		return total.penetrations == 0 && total.nonFinite == 0 ? 0 : 1;
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << '\n';
+		return 1;
+	}
+}
@@ -0,0 +1,179 @@
+// Converts between the human-editable text level format and the binary .arkl format.
+//
+// Text format:
+//   # comment
+//   cell <width> <height>      (optional, defaults to the standard block size)
+//   origin <x> <y>             (optional, defaults to the inner corner of the walls)
+//   ---
+//   one line per row, one character per column:
+//     '.' or ' '  empty
+//     'N'         normal block
+//     'B'         booster block
+//     'R'         reinforced block with default hit points
+//     '1'..'9'    reinforced block with that many hit points
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "levelFormat.hpp"
+
+namespace
+{
+	struct TextLevel
+	{
+		LevelGrid grid{ .columns = 0, .rows = 0, .cellSize = { 65.f, 30.f }, .origin = { 10.f, 10.f } };
+		std::vector<LevelBlock> blocks;
+	};
+
+	bool parseCell(char c, LevelBlock& block)
+	{
+		switch (c)
+		{
+			case 'N': block.type = BlockType::Normal; break;
+			case 'B': block.type = BlockType::Booster; break;
+			case 'R': block.type = BlockType::Reinforced; break;
+			default:
+				if (c < '1' || c > '9')
+					return false;
+				block.type = BlockType::Reinforced;
+				block.hitPoints = static_cast<uint8_t>(c - '0');
+				return true;
+		}
+		block.hitPoints = getDefaultHitPoints(block.type);
+		return true;
+	}
+
+	char formatCell(const LevelBlock& block)
+	{
+		if (block.hitPoints != getDefaultHitPoints(block.type) && block.hitPoints <= 9)
+			return static_cast<char>('0' + block.hitPoints);
+
+		switch (block.type)
+		{
+			case BlockType::Booster: return 'B';
+			case BlockType::Reinforced: return 'R';
+			default: return 'N';
+		}
+	}
+
+	TextLevel readTextLevel(const std::string& path)
+	{
+		std::ifstream file(path);
+		if (!file)
+			throw std::runtime_error(std::format("Failed to open {}", path));
+
+		TextLevel level;
+		std::string line;
+		bool inGrid = false;
+		size_t row = 0;
+		size_t lineNumber = 0;
+
+		while (std::getline(file, line))
+		{
+			lineNumber++;
+			if (!line.empty() && line.back() == '\r')
+				line.pop_back();
+
+			if (!inGrid)
+			{
+				std::istringstream tokens(line);
+				std::string key;
+				tokens >> key;
+
+				if (key.empty() || key[0] == '#')
+					continue;
+				if (key == "---")
+					inGrid = true;
+				else if (key == "cell")
+					tokens >> level.grid.cellSize.x >> level.grid.cellSize.y;
+				else if (key == "origin")
+					tokens >> level.grid.origin.x >> level.grid.origin.y;
+				else
+					throw std::runtime_error(std::format("{}:{}: unknown key '{}'", path, lineNumber, key));
+				continue;
+			}
+
+			if (line.size() > UINT16_MAX || row >= UINT16_MAX)
+				throw std::runtime_error(std::format("{}:{}: level exceeds {} columns or rows", path, lineNumber, UINT16_MAX));
+
+			for (size_t column = 0; column < line.size(); ++column)
+			{
+				const char c = line[column];
+				if (c == '.' || c == ' ')
+					continue;
+
+				LevelBlock block{ .column = static_cast<uint16_t>(column), .row = static_cast<uint16_t>(row) };
+				if (!parseCell(c, block))
+					throw std::runtime_error(std::format("{}:{}: unknown block '{}'", path, lineNumber, c));
+				level.blocks.push_back(block);
+			}
+
+			level.grid.columns = std::max(level.grid.columns, static_cast<uint16_t>(line.size()));
+			row++;
+		}
+
+		level.grid.rows = static_cast<uint16_t>(row);
+		return level;
+	}
+
+	void dumpLevel(const std::string& path)
+	{
+		const auto start = std::chrono::steady_clock::now();
+
+		LevelReader reader(path);
+		const LevelHeader& header = reader.getHeader();
+		std::vector<std::string> rows(header.grid.rows, std::string(header.grid.columns, '.'));
+		reader.forEachBlock([&](const LevelBlock& block) { rows[block.row][block.column] = formatCell(block); });
+
+		const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+
+		std::cout << std::format("# {} blocks in {} records, decoded in {:.2f} ms\n", header.blockCount, header.recordCount, elapsed.count());
+		std::cout << std::format("cell {} {}\norigin {} {}\n---\n", header.grid.cellSize.x, header.grid.cellSize.y, header.grid.origin.x, header.grid.origin.y);
+		for (const auto& row : rows)
+			std::cout << row << '\n';
+	}
+
+	void printUsage()
+	{
+		std::cerr << "Usage:\n"
+			<< "  LevelConverter <input.txt> <output.arkl> [--rle]\n"
+			<< "  LevelConverter --dump <input.arkl>\n";
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	try
+	{
+		const std::vector<std::string> args(argv + 1, argv + argc);
+
+		if (args.size() == 2 && args[0] == "--dump")
+		{
+			dumpLevel(args[1]);
+			return 0;
+		}
+
+		if (args.size() == 2 || (args.size() == 3 && args[2] == "--rle"))
+		{
+			const TextLevel level = readTextLevel(args[0]);
+			writeLevelFile(args[1], level.grid, level.blocks, args.size() == 3);
+			std::cout << std::format("Wrote {} blocks ({}x{}) to {}\n", level.blocks.size(), level.grid.columns, level.grid.rows, args[1]);
+			return 0;
+		}
+
+		printUsage();
+		return 1;
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << '\n';
+		return 1;
+	}
+}
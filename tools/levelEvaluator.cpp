@@ -0,0 +1,302 @@
+// Monte Carlo evaluation of generated levels: plays thousands of independent headless games per
+// block-type weight configuration across all cores and aggregates how they went.
+//
+// Usage: LevelEvaluator [--games N] [--threads N] [--controller autoplay|random] [--seed N]
+//                       [--max-minutes M] [--scaling] [--distance-field] [--weights NORMAL,BOOSTER,REINFORCED]...
+//
+// Every game gets its own level seed and random number generator derived from (seed, configuration,
+// game), so results do not depend on the thread count. --scaling replays the first configuration with
+// 1, 2, 4, ... threads and reports the speedup.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <format>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "autoplay.hpp"
+#include "counterRng.hpp"
+#include "gameConfig.hpp"
+#include "headlessGame.hpp"
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+	using TypeWeights = std::array<float, static_cast<size_t>(BlockType::Count)>;
+
+	enum class Controller : uint8_t
+	{
+		Autoplay,
+		Random // Holds a random direction for a random number of ticks
+	};
+
+	struct EvaluatorOptions
+	{
+		uint32_t gameCount = 4096;
+		uint32_t threadCount = 0; // Hardware concurrency
+		Controller controller = Controller::Autoplay;
+		uint64_t seed = 1;
+		float maxMinutes = 30.f; // Simulated time after which a game counts as timed out
+		bool scaling = false;
+		bool distanceField = false; // Physics through HeadlessGame's distance field instead of sweeping every box
+		std::vector<TypeWeights> configurations;
+	};
+
+	struct GameResult
+	{
+		HeadlessGameStats stats;
+		bool won = false;
+		bool timedOut = false;
+	};
+
+	TypeWeights parseWeights(std::string_view text)
+	{
+		TypeWeights weights{};
+		size_t count = 0;
+		while (!text.empty())
+		{
+			const size_t separator = text.find(',');
+			if (count == weights.size())
+				throw std::invalid_argument(std::format("Expected {} weights", weights.size()));
+
+			weights[count++] = std::stof(std::string(text.substr(0, separator)));
+			text = separator == std::string_view::npos ? std::string_view{} : text.substr(separator + 1);
+		}
+		if (count != weights.size())
+			throw std::invalid_argument(std::format("Expected {} weights", weights.size()));
+
+		if (std::ranges::any_of(weights, [](float weight) { return !std::isfinite(weight) || weight < 0.f; }))
+			throw std::invalid_argument("Weights must be finite and not negative");
+
+		if (std::ranges::none_of(weights, [](float weight) { return weight > 0.f; }))
+			throw std::invalid_argument("At least one weight must be positive");
+
+		return weights;
+	}
+
+	EvaluatorOptions parseOptions(int argc, char* argv[])
+	{
+		EvaluatorOptions options;
+		for (int i = 1; i < argc; ++i)
+		{
+			const std::string_view arg = argv[i];
+			if (arg == "--games" && i + 1 < argc)
+				options.gameCount = std::max(1u, static_cast<uint32_t>(std::stoul(argv[++i])));
+			else if (arg == "--threads" && i + 1 < argc)
+				options.threadCount = static_cast<uint32_t>(std::stoul(argv[++i]));
+			else if (arg == "--controller" && i + 1 < argc)
+			{
+				const std::string_view name = argv[++i];
+				if (name == "autoplay")
+					options.controller = Controller::Autoplay;
+				else if (name == "random")
+					options.controller = Controller::Random;
+				else
+					throw std::invalid_argument(std::format("Unknown controller: {}", name));
+			}
+			else if (arg == "--seed" && i + 1 < argc)
+				options.seed = std::stoull(argv[++i]);
+			else if (arg == "--max-minutes" && i + 1 < argc)
+				options.maxMinutes = std::stof(argv[++i]);
+			else if (arg == "--scaling")
+				options.scaling = true;
+			else if (arg == "--distance-field")
+				options.distanceField = true;
+			else if (arg == "--weights" && i + 1 < argc)
+				options.configurations.push_back(parseWeights(argv[++i]));
+			else
+				throw std::invalid_argument(std::format("Unknown argument: {}", arg));
+		}
+
+		if (options.configurations.empty())
+			options.configurations.push_back(GameConfig::kBlockTypeWeights);
+
+		if (options.threadCount == 0)
+			options.threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+		return options;
+	}
+
+	GameResult playGame(const TypeWeights& weights, uint64_t gameSeed, Controller controller, bool distanceField, uint64_t maxTicks)
+	{
+		const CounterRng seeds(gameSeed);
+
+		LevelGenConfig config;
+		config.seed = seeds.at(0);
+		config.grid = {
+			.columns = GameConfig::kBlockColumnCount,
+			.rows = GameConfig::kBlockRowCount,
+			.cellSize = GameConfig::kBlockSize,
+			.origin = GameConfig::kLevelOrigin
+		};
+		config.typeWeights = weights;
+
+		HeadlessGame game(config, static_cast<uint32_t>(seeds.at(1)), distanceField);
+		AutoplayController autoplay;
+		CounterRng randomInput(seeds.at(2));
+		MoveDirection direction = MoveDirection::None;
+		uint64_t holdTicks = 0;
+
+		while (!game.isFinished() && game.getStats().ticks < maxTicks)
+		{
+			game.serve();
+
+			if (controller == Controller::Autoplay)
+				direction = autoplay.chooseDirection(game.getState(), game.getCollisionContext(), HeadlessGame::kTickSeconds);
+			else if (holdTicks-- == 0)
+			{
+				direction = static_cast<MoveDirection>(randomInput.next() % 3);
+				holdTicks = 5 + randomInput.next() % 30;
+			}
+
+			game.step(direction);
+		}
+
+		return {
+			.stats = game.getStats(),
+			.won = game.getState().gameState == GameState::Won,
+			.timedOut = !game.isFinished()
+		};
+	}
+
+	// Plays every game of one configuration; threads take the next unplayed game until none is left
+	std::vector<GameResult> evaluate(const EvaluatorOptions& options, size_t configuration, uint32_t threadCount)
+	{
+		const TypeWeights& weights = options.configurations[configuration];
+		const auto maxTicks = static_cast<uint64_t>(options.maxMinutes * 60.f / HeadlessGame::kTickSeconds);
+		const CounterRng gameSeeds(options.seed + configuration);
+
+		std::vector<GameResult> results(options.gameCount);
+		std::atomic<uint32_t> nextGame{ 0 };
+
+		// An exception escaping a thread terminates the process, so the first one is handed back to the caller
+		std::exception_ptr failure;
+		std::mutex failureMutex;
+		{
+			std::vector<std::jthread> workers;
+			for (uint32_t t = 0; t < threadCount; ++t)
+			{
+				workers.emplace_back([&]
+				{
+					try
+					{
+						for (uint32_t game = nextGame++; game < options.gameCount; game = nextGame++)
+							results[game] = playGame(weights, gameSeeds.at(game), options.controller, options.distanceField, maxTicks);
+					}
+					catch (...)
+					{
+						const std::lock_guard lock(failureMutex);
+						if (!failure)
+							failure = std::current_exception();
+						nextGame = options.gameCount; // The other workers stop after their current game
+					}
+				});
+			}
+		}
+
+		if (failure)
+			std::rethrow_exception(failure);
+
+		return results;
+	}
+
+	float percentile(std::vector<float>& values, float fraction)
+	{
+		if (values.empty())
+			return 0.f;
+
+		const auto index = static_cast<size_t>(fraction * static_cast<float>(values.size() - 1));
+		std::ranges::nth_element(values, values.begin() + static_cast<std::ptrdiff_t>(index));
+		return values[index];
+	}
+
+	void report(const TypeWeights& weights, const std::vector<GameResult>& results, double wallSeconds)
+	{
+		uint64_t ticks = 0;
+		uint32_t won = 0;
+		uint32_t timedOut = 0;
+		double livesLost = 0.0;
+		double platformBounces = 0.0;
+		double wallBounces = 0.0;
+		double blockBounces = 0.0;
+		double boosterHits = 0.0;
+		std::vector<float> completionSeconds;
+		CcdStats ccd;
+		for (const GameResult& result : results)
+		{
+			ccd.merge(result.stats.ccd);
+			ticks += result.stats.ticks;
+			livesLost += result.stats.livesLost;
+			platformBounces += result.stats.platformBounces;
+			wallBounces += result.stats.wallBounces;
+			blockBounces += result.stats.blockBounces;
+			boosterHits += result.stats.boosterHits;
+			timedOut += result.timedOut;
+			if (result.won)
+			{
+				won++;
+				completionSeconds.push_back(static_cast<float>(result.stats.ticks) * HeadlessGame::kTickSeconds);
+			}
+		}
+
+		const auto games = static_cast<double>(results.size());
+		std::cout << std::format("weights {:.2f}/{:.2f}/{:.2f}: {} games, {:.1f}% won, {} timed out\n",
+			weights[0], weights[1], weights[2], results.size(), 100.0 * won / games, timedOut);
+		std::cout << std::format("  completion   p50 {:7.1f} s  p95 {:7.1f} s (won games)\n",
+			percentile(completionSeconds, 0.5f), percentile(completionSeconds, 0.95f));
+		std::cout << std::format("  per game     lives lost {:.2f}  bounces platform {:.1f} wall {:.1f} block {:.1f}  booster hits {:.1f} ({:.1f}% of block hits)\n",
+			livesLost / games, platformBounces / games, wallBounces / games, blockBounces / games,
+			boosterHits / games, blockBounces > 0.0 ? 100.0 * boosterHits / blockBounces : 0.0);
+		std::cout << std::format("  ccd          {}\n", ccd.toString());
+		std::cout << std::format("  throughput   {:.0f} games/s  {:.2f} Mticks/s\n",
+			games / wallSeconds, static_cast<double>(ticks) / wallSeconds / 1e6);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	try
+	{
+		const EvaluatorOptions options = parseOptions(argc, argv);
+		std::cout << std::format("{} controller, {} threads\n",
+			options.controller == Controller::Autoplay ? "autoplay" : "random", options.threadCount);
+
+		for (size_t configuration = 0; configuration < options.configurations.size(); ++configuration)
+		{
+			const auto start = Clock::now();
+			const std::vector<GameResult> results = evaluate(options, configuration, options.threadCount);
+			report(options.configurations[configuration], results, std::chrono::duration<double>(Clock::now() - start).count());
+		}
+
+		if (options.scaling)
+		{
+			double singleThreadSeconds = 0.0;
+			for (uint32_t threads = 1; threads <= options.threadCount; threads *= 2)
+			{
+				const auto start = Clock::now();
+				evaluate(options, 0, threads);
+				const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+				if (threads == 1)
+					singleThreadSeconds = seconds;
+				std::cout << std::format("scaling: {:>3} threads {:8.0f} games/s  speedup {:.2f}x\n",
+					threads, options.gameCount / seconds, singleThreadSeconds / seconds);
+			}
+		}
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << '\n';
+		return 1;
+	}
+
+	return 0;
+}
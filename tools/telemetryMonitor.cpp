@@ -0,0 +1,219 @@
+// Attaches to the game's shared-memory telemetry segment and prints rolling percentiles.
+//
+// Usage: TelemetryMonitor [--segment NAME] [--window FRAMES] [--interval MS]
+//
+// The monitor only reads the segment. It never blocks the game; if it falls behind by more than
+// the ring capacity it skips ahead and reports how many samples it missed. When no new samples
+// arrive it checks whether the game has exited or restarted with a fresh segment, and re-attaches.
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <format>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "telemetry.hpp"
+
+namespace
+{
+	struct Options
+	{
+		std::string segmentName = Telemetry::kDefaultSegmentName;
+		size_t windowFrames = 600;
+		int intervalMs = 1000;
+	};
+
+	Options parseOptions(int argc, char* argv[])
+	{
+		Options options;
+		for (int i = 1; i < argc; ++i)
+		{
+			const std::string_view arg = argv[i];
+			if (arg == "--segment" && i + 1 < argc)
+				options.segmentName = argv[++i];
+			else if (arg == "--window" && i + 1 < argc)
+				options.windowFrames = std::max<size_t>(1, std::stoul(argv[++i]));
+			else if (arg == "--interval" && i + 1 < argc)
+				options.intervalMs = std::max(10, std::stoi(argv[++i]));
+			else
+				throw std::invalid_argument(std::format("Unknown argument: {}", arg));
+		}
+		return options;
+	}
+
+	// A mapped segment and the shared-memory object it came from. The publisher unlinks its segment on
+	// exit and a restarted game creates a new one under the same name, which the old mapping never sees.
+	struct Attachment
+	{
+		const Telemetry::Segment* segment = nullptr;
+		dev_t device = 0;
+		ino_t inode = 0;
+	};
+
+	// Maps the segment read-only, waiting until the game has created and initialized it
+	Attachment attach(const std::string& name)
+	{
+		bool hasReportedWait = false;
+		for (;;)
+		{
+			const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+			if (fd >= 0)
+			{
+				struct stat info{};
+				void* memory = fstat(fd, &info) == 0 ? mmap(nullptr, sizeof(Telemetry::Segment), PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+				close(fd);
+
+				if (memory != MAP_FAILED)
+				{
+					const auto* segment = static_cast<const Telemetry::Segment*>(memory);
+					if (segment->magic == Telemetry::kMagic)
+					{
+						std::atomic_thread_fence(std::memory_order_acquire);
+						if (segment->version != Telemetry::kVersion || segment->sampleSize != sizeof(Telemetry::FrameSample))
+							throw std::runtime_error("Telemetry segment has an incompatible layout");
+						return { segment, info.st_dev, info.st_ino };
+					}
+					munmap(memory, sizeof(Telemetry::Segment));
+				}
+			}
+
+			if (!hasReportedWait)
+				std::cout << std::format("Waiting for telemetry segment {}...\n", name);
+			hasReportedWait = true;
+			std::this_thread::sleep_for(std::chrono::milliseconds(250));
+		}
+	}
+
+	void detach(Attachment& attachment)
+	{
+		munmap(const_cast<Telemetry::Segment*>(attachment.segment), sizeof(Telemetry::Segment));
+		attachment = {};
+	}
+
+	// Whether the name no longer refers to the attached segment: unlinked by a game that exited, or recreated by a new one
+	bool isReplaced(const std::string& name, const Attachment& attachment)
+	{
+		const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+		if (fd < 0)
+			return true;
+
+		struct stat info{};
+		const bool same = fstat(fd, &info) == 0 && info.st_dev == attachment.device && info.st_ino == attachment.inode;
+		close(fd);
+		return !same;
+	}
+
+	float percentile(std::vector<float>& values, float fraction)
+	{
+		const auto index = static_cast<size_t>(fraction * static_cast<float>(values.size() - 1) + 0.5f);
+		std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(index), values.end());
+		return values[index];
+	}
+
+	template <typename Field>
+	void printPercentiles(std::string_view label, const std::deque<Telemetry::FrameSample>& window, Field field)
+	{
+		std::vector<float> values;
+		values.reserve(window.size());
+		for (const auto& sample : window)
+			values.push_back(field(sample));
+
+		const float p50 = percentile(values, 0.50f);
+		const float p95 = percentile(values, 0.95f);
+		const float p99 = percentile(values, 0.99f);
+		const float max = *std::ranges::max_element(values);
+		std::cout << std::format("  {:<8} p50 {:7.3f}  p95 {:7.3f}  p99 {:7.3f}  max {:7.3f} ms\n", label, p50, p95, p99, max);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	try
+	{
+		const Options options = parseOptions(argc, argv);
+		Attachment attachment = attach(options.segmentName);
+
+		std::deque<Telemetry::FrameSample> window;
+		uint64_t readIndex = attachment.segment->writeIndex.load(std::memory_order_acquire);
+		uint64_t missedSamples = 0;
+
+		for (;;)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(options.intervalMs));
+
+			uint64_t writeIndex = attachment.segment->writeIndex.load(std::memory_order_acquire);
+			if (writeIndex == readIndex && isReplaced(options.segmentName, attachment))
+			{
+				std::cout << "Telemetry segment went away, re-attaching\n";
+				detach(attachment);
+				attachment = attach(options.segmentName);
+				readIndex = 0;
+				writeIndex = attachment.segment->writeIndex.load(std::memory_order_acquire);
+				window.clear();
+			}
+			else if (writeIndex < readIndex)
+			{
+				// The segment was reinitialized in place by a game that found it left over
+				readIndex = 0;
+				window.clear();
+			}
+
+			if (writeIndex - readIndex > Telemetry::kRingCapacity)
+			{
+				missedSamples += writeIndex - readIndex - Telemetry::kRingCapacity;
+				readIndex = writeIndex - Telemetry::kRingCapacity;
+			}
+
+			for (; readIndex < writeIndex; ++readIndex)
+			{
+				Telemetry::FrameSample sample;
+				if (!Telemetry::readSample(*attachment.segment, readIndex, sample))
+				{
+					missedSamples++;
+					continue;
+				}
+
+				window.push_back(sample);
+				if (window.size() > options.windowFrames)
+					window.pop_front();
+			}
+
+			if (window.empty())
+				continue;
+
+			const Telemetry::FrameSample& latest = window.back();
+			std::cout << std::format("frame {}  window {} frames  missed {}\n", latest.frameIndex, window.size(), missedSamples);
+			printPercentiles("frame", window, [](const auto& s) { return s.frameMs; });
+			printPercentiles("events", window, [](const auto& s) { return s.eventsMs; });
+			printPercentiles("update", window, [](const auto& s) { return s.updateMs; });
+			printPercentiles("render", window, [](const auto& s) { return s.renderMs; });
+			printPercentiles("ui", window, [](const auto& s) { return s.uiMs; });
+			uint32_t maxCcdIterations = 0;
+			size_t ccdBudgetExhausted = 0;
+			for (const auto& sample : window)
+			{
+				maxCcdIterations = std::max(maxCcdIterations, sample.ccdIterations);
+				ccdBudgetExhausted += sample.ccdBudgetExhausted;
+			}
+			std::cout << std::format("  particles {}  blocks {}  ccd {} (window max {}, budget exhausted {})  draws {}  audio queued {} bytes\n\n",
+				latest.particleCount, latest.blockCount, latest.ccdIterations, maxCcdIterations, ccdBudgetExhausted,
+				latest.drawCalls, latest.audioQueuedBytes);
+		}
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << '\n';
+		return 1;
+	}
+}